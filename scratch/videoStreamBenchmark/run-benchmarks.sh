@@ -0,0 +1,16 @@
+#!/bin/sh
+# Run every benchmark scenario in its own process (so that the peak RSS
+# is per scenario) and collect the results in one CSV file.
+#
+# Usage: ./scratch/videoStreamBenchmark/run-benchmarks.sh [output.csv] [scenario-filter]
+
+OUTPUT=${1:-video-stream-benchmark.csv}
+FILTER=${2:-.}
+
+rm -f "$OUTPUT"
+HEADER=--header
+for SCENARIO in $(./ns3 run --no-build "videoStreamBenchmark --list" | grep -E "$FILTER"); do
+  ./ns3 run --no-build "videoStreamBenchmark --scenario=$SCENARIO --output=$OUTPUT $HEADER" || exit 1
+  HEADER=
+done
+cat "$OUTPUT"
@@ -0,0 +1,399 @@
+/*****************************************************
+*
+* File:  videoStreamBenchmark.cc
+*
+* Explanation:  Scaling benchmark of the video stream
+*               applications. Each run executes one fixed
+*               scenario and prints one machine-readable
+*               result line (CSV or JSON) with the wall-clock
+*               time, the number of executed events and the
+*               peak resident set size.
+*
+*               ./ns3 run "videoStreamBenchmark --list"
+*               ./ns3 run "videoStreamBenchmark --scenario=star-100"
+*
+*****************************************************/
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/applications-module.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sys/resource.h>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("VideoStreamBenchmark");
+
+/**
+ * @brief Topology of a benchmark scenario.
+ */
+enum Topology
+{
+    STAR,    //!< Server on the hub, one client per spoke
+    DUMBBELL //!< Server on the left, clients on the right of a shared bottleneck
+};
+
+/**
+ * @brief A fixed benchmark scenario.
+ */
+struct Scenario
+{
+    const char* name;       //!< Name used on the command line
+    Topology topology;      //!< Topology
+    uint32_t clients;       //!< Number of clients
+    uint16_t level;         //!< Fixed video level
+    uint32_t maxPacketSize; //!< Server MaxPacketSize
+    double simTime;         //!< Simulated seconds of streaming
+    uint32_t nodes = 0;     //!< Client nodes of a population (0 for one node per client)
+    double arrivalRate = 0; //!< Poisson arrivals per second (0 for synchronized starts)
+    double meanSession = 0; //!< Mean of the exponential session length in seconds
+    uint32_t aggregation = 0; //!< Server FrameAggregation (0 for one packet per fragment)
+    uint32_t packetInterval = 0; //!< One Poisson client in packetInterval runs packets, the others are fluid (0 for packets only)
+};
+
+// Client count sweeps use the lowest level; the level and packet size sweeps use 10 clients.
+// Poisson scenarios run many sessions per node with exponential session lengths.
+// The -agg scenarios repeat a scenario with aggregated fragments to measure the speedup and the
+// change of the frame latency and stalls it costs.
+// Hybrid scenarios run most Poisson sessions in the fluid model and one in packetInterval as packets.
+static const Scenario g_scenarios[] = {
+    {"star-1", STAR, 1, 1, 1400, 10.0},
+    {"star-10", STAR, 10, 1, 1400, 10.0},
+    {"star-100", STAR, 100, 1, 1400, 5.0},
+    {"star-1000", STAR, 1000, 1, 1400, 2.0},
+    {"star-10000", STAR, 10000, 1, 1400, 1.0},
+    {"dumbbell-1", DUMBBELL, 1, 1, 1400, 10.0},
+    {"dumbbell-10", DUMBBELL, 10, 1, 1400, 10.0},
+    {"dumbbell-100", DUMBBELL, 100, 1, 1400, 5.0},
+    {"dumbbell-1000", DUMBBELL, 1000, 1, 1400, 2.0},
+    {"level-1", STAR, 10, 1, 1400, 5.0},
+    {"level-2", STAR, 10, 2, 1400, 5.0},
+    {"level-3", STAR, 10, 3, 1400, 5.0},
+    {"level-4", STAR, 10, 4, 1400, 5.0},
+    {"level-5", STAR, 10, 5, 1400, 5.0},
+    {"mps-512", STAR, 10, 3, 512, 5.0},
+    {"mps-1400", STAR, 10, 3, 1400, 5.0},
+    {"mps-8972", STAR, 10, 3, 8972, 5.0},
+    {"mps-65000", STAR, 10, 3, 65000, 5.0},
+    {"poisson-1000", STAR, 1000, 1, 1400, 20.0, 100, 100.0, 5.0},
+    {"poisson-10000", STAR, 10000, 1, 1400, 20.0, 100, 1000.0, 5.0},
+    {"star-100-agg", STAR, 100, 1, 1400, 5.0, 0, 0, 0, 46},
+    {"dumbbell-100-agg", DUMBBELL, 100, 1, 1400, 5.0, 0, 0, 0, 46},
+    {"level-5-agg", STAR, 10, 5, 1400, 5.0, 0, 0, 0, 46},
+    {"hybrid-10000", STAR, 10000, 1, 1400, 20.0, 100, 1000.0, 5.0, 0, 100},
+    {"hybrid-100000", STAR, 100000, 1, 1400, 20.0, 100, 10000.0, 5.0, 0, 100},
+};
+
+static uint64_t g_txPackets = 0;
+static uint64_t g_rxBytes = 0;
+
+static void
+CountTx(Ptr<const Packet> packet)
+{
+    g_txPackets++;
+}
+
+static void
+CountRx(Ptr<const Packet> packet, const Address& from)
+{
+    g_rxBytes += packet->GetSize();
+}
+
+/**
+ * @brief Mean bitrate of video level 1 in a frame file, for the fluid sessions.
+ */
+static DataRate
+FrameFileBitRate(const std::string& frameFile, Time interval)
+{
+    std::ifstream frames(frameFile);
+    double sum = 0;
+    uint64_t count = 0;
+    uint32_t size;
+    while (frames >> size)
+    {
+        sum += size;
+        ++count;
+    }
+    return DataRate(count > 0 ? static_cast<uint64_t>(sum / count * 8 / interval.GetSeconds()) : 0);
+}
+
+/**
+ * @brief Link MTU large enough for the server packets (UDP + IPv4 headers included).
+ */
+static uint16_t
+LinkMtu(uint32_t maxPacketSize)
+{
+    return std::min<uint32_t>(65535, std::max<uint32_t>(1500, maxPacketSize + 28));
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string scenarioName = "star-10";
+    std::string format = "csv";
+    std::string output = "";
+    std::string frameFile = "./scratch/videoStreamer/frameList.txt";
+    bool list = false;
+    bool header = false;
+    bool pathMtu = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scenario", "Name of the scenario to run", scenarioName);
+    cmd.AddValue("format", "Output format (csv or json)", format);
+    cmd.AddValue("output", "File the result is appended to (stdout if empty)", output);
+    cmd.AddValue("frameFile", "Frame size trace used by the server (synthetic VBR frames if empty)", frameFile);
+    cmd.AddValue("list", "List the scenario names and exit", list);
+    cmd.AddValue("header", "Print the CSV header before the result", header);
+    cmd.AddValue("pathMtu", "Size the fragments to the path MTU instead of the scenario MaxPacketSize", pathMtu);
+    cmd.Parse(argc, argv);
+
+    if (list)
+    {
+        for (const Scenario& s : g_scenarios)
+        {
+            std::cout << s.name << "\n";
+        }
+        return 0;
+    }
+
+    const Scenario* scenario = nullptr;
+    for (const Scenario& s : g_scenarios)
+    {
+        if (scenarioName == s.name)
+        {
+            scenario = &s;
+        }
+    }
+    if (scenario == nullptr)
+    {
+        std::cerr << "Unknown scenario " << scenarioName << " (use --list)" << std::endl;
+        return 1;
+    }
+
+    Time::SetResolution(Time::NS);
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    uint16_t port = 6969;
+    // Aggregated packets must not be fragmented by IP either
+    uint16_t mtu = LinkMtu(scenario->maxPacketSize * std::max<uint32_t>(1, scenario->aggregation));
+    bool population = scenario->arrivalRate > 0;
+
+    PointToPointHelper access;
+    access.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    access.SetDeviceAttribute("Mtu", UintegerValue(mtu));
+    access.SetChannelAttribute("Delay", StringValue("2ms"));
+
+    Ptr<Node> serverNode;
+    NodeContainer clientNodes;
+    std::vector<Ipv4Address> serverAddresses; // server address seen by each client
+    if (scenario->topology == STAR)
+    {
+        PointToPointStarHelper star(population ? scenario->nodes : scenario->clients, access);
+        InternetStackHelper stack;
+        star.InstallStack(stack);
+        star.AssignIpv4Addresses(Ipv4AddressHelper("10.0.0.0", "255.255.255.252"));
+        serverNode = star.GetHub();
+        // Every spoke is directly connected to the hub, so no routing is needed
+        for (uint32_t i = 0; i < star.SpokeCount(); ++i)
+        {
+            clientNodes.Add(star.GetSpokeNode(i));
+            serverAddresses.push_back(star.GetHubIpv4Address(i));
+        }
+        if (population)
+        {
+            // Sessions of every spoke reach the server through the first hub address
+            Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+        }
+    }
+    else
+    {
+        // Each leaf takes a /24: the left leaves count up from 10.0.0.0 and the right leaves from
+        // 10.128.0.0, so each side addresses at most 32768 leaves before reaching the next range,
+        // and the routers use 10.255.0.0 above both
+        if (scenario->clients > 32768)
+        {
+            std::cerr << "Scenario " << scenario->name << " has more than 32768 leaves per side" << std::endl;
+            return 1;
+        }
+        PointToPointHelper bottleneck;
+        bottleneck.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
+        bottleneck.SetDeviceAttribute("Mtu", UintegerValue(mtu));
+        bottleneck.SetChannelAttribute("Delay", StringValue("10ms"));
+
+        PointToPointDumbbellHelper dumbbell(1, access, scenario->clients, access, bottleneck);
+        InternetStackHelper stack;
+        dumbbell.InstallStack(stack);
+        dumbbell.AssignIpv4Addresses(Ipv4AddressHelper("10.0.0.0", "255.255.255.0"),
+                                     Ipv4AddressHelper("10.128.0.0", "255.255.255.0"),
+                                     Ipv4AddressHelper("10.255.0.0", "255.255.255.0"));
+        serverNode = dumbbell.GetLeft(0);
+        for (uint32_t i = 0; i < dumbbell.RightCount(); ++i)
+        {
+            clientNodes.Add(dumbbell.GetRight(i));
+            serverAddresses.push_back(dumbbell.GetLeftIpv4Address(0));
+        }
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    }
+
+    Time start = Seconds(1.0);
+    Time stop = start + Seconds(scenario->simTime);
+
+    VideoStreamServerHelper videoServer(port);
+    videoServer.SetAttribute("MaxPacketSize", UintegerValue(scenario->maxPacketSize));
+    videoServer.SetAttribute("FrameFile", StringValue(frameFile));
+    Ptr<VideoStreamFrameGenerator> generator;
+    if (frameFile.empty())
+    {
+        generator = CreateObject<VideoStreamFrameGenerator>();
+        videoServer.SetAttribute("FrameGenerator", PointerValue(generator));
+    }
+    videoServer.SetAttribute("InitialVideoLevel", UintegerValue(scenario->level));
+    videoServer.SetAttribute("FrameAggregation", UintegerValue(scenario->aggregation));
+    if (pathMtu)
+    {
+        videoServer.SetAttribute("FragmentSizing", StringValue("PathMtu"));
+        videoServer.SetAttribute("Jumbo", BooleanValue(true));
+    }
+    ApplicationContainer serverApp = videoServer.Install(serverNode);
+    serverApp.Start(Seconds(0.0));
+    serverApp.Stop(stop);
+    serverApp.Get(0)->TraceConnectWithoutContext("Tx", MakeCallback(&CountTx));
+
+    ApplicationContainer clients;
+    Ptr<VideoStreamFluidModel> fluid;
+    if (population)
+    {
+        VideoStreamPopulationHelper videoClients(serverAddresses[0], port);
+        videoClients.SetClientAttribute("InitialVideoLevel", UintegerValue(scenario->level));
+        videoClients.SetClientAttribute("Adaptive", BooleanValue(false));
+        videoClients.SetPoissonArrivals(scenario->arrivalRate);
+        Ptr<ExponentialRandomVariable> sessionLength = CreateObject<ExponentialRandomVariable>();
+        sessionLength->SetAttribute("Mean", DoubleValue(scenario->meanSession));
+        sessionLength->SetStream(1);
+        videoClients.SetSessionLength(sessionLength);
+        videoClients.AssignStreams(2);
+        if (scenario->packetInterval > 0)
+        {
+            // The fluid sessions stream the bitrate the server sends at
+            TimeValue interval;
+            serverApp.Get(0)->GetAttribute("Interval", interval);
+            DataRate bitRate =
+                generator ? DataRate(static_cast<uint64_t>(generator->GetMeanFrameSize(1) * 8 /
+                                                           interval.Get().GetSeconds()))
+                          : FrameFileBitRate(frameFile, interval.Get());
+            fluid = CreateObject<VideoStreamFluidModel>();
+            fluid->SetAttribute("BitRate", DataRateValue(bitRate));
+            fluid->SetAttribute("VideoLevel", UintegerValue(scenario->level));
+            videoClients.SetFluidModel(fluid, scenario->packetInterval);
+        }
+        clients = videoClients.Install(clientNodes, scenario->clients, start, stop);
+        for (uint32_t i = 0; i < clients.GetN(); ++i)
+        {
+            clients.Get(i)->TraceConnectWithoutContext("Rx", MakeCallback(&CountRx));
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0; i < clientNodes.GetN(); ++i)
+        {
+            VideoStreamClientHelper videoClient(serverAddresses[i], port);
+            videoClient.SetAttribute("InitialVideoLevel", UintegerValue(scenario->level));
+            videoClient.SetAttribute("Adaptive", BooleanValue(false));
+            ApplicationContainer clientApp = videoClient.Install(clientNodes.Get(i));
+            clientApp.Start(start);
+            clientApp.Stop(stop);
+            clientApp.Get(0)->TraceConnectWithoutContext("Rx", MakeCallback(&CountRx));
+            clients.Add(clientApp);
+        }
+    }
+
+    Simulator::Stop(stop);
+    auto wallStart = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto wallStop = std::chrono::steady_clock::now();
+    uint64_t events = Simulator::GetEventCount();
+
+    // Accuracy of the run: what the clients saw, to compare with and without aggregation
+    VideoStreamHistogram frameLatency, timeToFirstFrame;
+    uint64_t stalls = 0;
+    for (uint32_t i = 0; i < clients.GetN(); ++i)
+    {
+        Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient>(clients.Get(i));
+        frameLatency.Merge(client->GetFrameLatencyHistogram());
+        stalls += client->GetStallHistogram().GetCount();
+        if (client->GetReceivedFrames() > 0)
+        {
+            timeToFirstFrame.Record(client->GetTimeToFirstFrame());
+        }
+    }
+    uint32_t fluidSessions = fluid ? fluid->GetFluidSessions() : 0;
+    uint32_t installedClients = clients.GetN() + fluidSessions;
+    uint32_t fluidStalls = fluid ? fluid->GetStallCount() : 0;
+    double fluidStartupMs =
+        fluid ? fluid->GetStartupDelayHistogram().GetMean().GetSeconds() * 1000 : 0;
+    Simulator::Destroy();
+
+    double wall = std::chrono::duration<double>(wallStop - wallStart).count();
+    // The applications start at 1 s, so only the streaming interval counts
+    double simSeconds = (stop - start).GetSeconds();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    long peakRssKb = usage.ru_maxrss;
+
+    std::ostringstream result;
+    if (format == "json")
+    {
+        result << "{\"scenario\":\"" << scenario->name << "\""
+               << ",\"topology\":\"" << (scenario->topology == STAR ? "star" : "dumbbell") << "\""
+               << ",\"clients\":" << installedClients << ",\"level\":" << scenario->level
+               << ",\"maxPacketSize\":" << scenario->maxPacketSize
+               << ",\"aggregation\":" << scenario->aggregation << ",\"simTime\":" << simSeconds
+               << ",\"wallClock\":" << wall << ",\"wallPerSimSecond\":" << wall / simSeconds
+               << ",\"events\":" << events << ",\"eventsPerSecond\":" << events / wall
+               << ",\"eventsPerSimSecond\":" << events / simSeconds << ",\"txPackets\":" << g_txPackets
+               << ",\"rxBytes\":" << g_rxBytes << ",\"peakRssKb\":" << peakRssKb
+               << ",\"frameLatencyMeanMs\":" << frameLatency.GetMean().GetSeconds() * 1000
+               << ",\"frameLatencyP99Ms\":" << frameLatency.GetPercentile(99).GetSeconds() * 1000
+               << ",\"stalls\":" << stalls
+               << ",\"ttffMeanMs\":" << timeToFirstFrame.GetMean().GetSeconds() * 1000
+               << ",\"ttffP99Ms\":" << timeToFirstFrame.GetPercentile(99).GetSeconds() * 1000
+               << ",\"fluidSessions\":" << fluidSessions
+               << ",\"fluidStalls\":" << fluidStalls << ",\"fluidStartupMeanMs\":" << fluidStartupMs
+               << "}\n";
+    }
+    else
+    {
+        if (header)
+        {
+            result << "scenario,topology,clients,level,maxPacketSize,aggregation,simTime,wallClock,wallPerSimSecond,"
+                      "events,eventsPerSecond,eventsPerSimSecond,txPackets,rxBytes,peakRssKb,"
+                      "frameLatencyMeanMs,frameLatencyP99Ms,stalls,ttffMeanMs,ttffP99Ms,fluidSessions,"
+                      "fluidStalls,fluidStartupMeanMs\n";
+        }
+        result << scenario->name << "," << (scenario->topology == STAR ? "star" : "dumbbell") << ","
+               << installedClients << "," << scenario->level << "," << scenario->maxPacketSize << ","
+               << scenario->aggregation << "," << simSeconds << "," << wall << "," << wall / simSeconds << "," << events << ","
+               << events / wall << "," << events / simSeconds << "," << g_txPackets << "," << g_rxBytes
+               << "," << peakRssKb << "," << frameLatency.GetMean().GetSeconds() * 1000 << ","
+               << frameLatency.GetPercentile(99).GetSeconds() * 1000 << "," << stalls << ","
+               << timeToFirstFrame.GetMean().GetSeconds() * 1000 << ","
+               << timeToFirstFrame.GetPercentile(99).GetSeconds() * 1000 << "," << fluidSessions << "," << fluidStalls << "," << fluidStartupMs << "\n";
+    }
+
+    if (output.empty())
+    {
+        std::cout << result.str();
+    }
+    else
+    {
+        std::ofstream outFile(output, std::ios::out | std::ios::app);
+        outFile << result.str();
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+/*****************************************************
+*
+* File:  videoStreamLogDecoder.cc
+*
+* Explanation:  Offline decoder of the binary event log
+*               written by the video stream applications
+*               (EventLogFile attribute). Prints the events
+*               as aligned text or CSV.
+*
+*               ./ns3 run "videoStreamLogDecoder --input=events.bin"
+*               ./ns3 run "videoStreamLogDecoder --input=events.bin --format=csv --output=events.csv"
+*
+*****************************************************/
+#include "ns3/core-module.h"
+#include "ns3/applications-module.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input = "";
+    std::string output = "";
+    std::string format = "text";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Binary event log to decode", input);
+    cmd.AddValue("output", "File the decoded events are written to (stdout if empty)", output);
+    cmd.AddValue("format", "Output format (text or csv)", format);
+    cmd.Parse(argc, argv);
+
+    if (input.empty() || (format != "text" && format != "csv"))
+    {
+        std::cerr << "Usage: videoStreamLogDecoder --input=<file> [--format=text|csv] [--output=<file>]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(input, std::ios::in | std::ios::binary);
+    if (!in.is_open())
+    {
+        std::cerr << "Could not open " << input << std::endl;
+        return 1;
+    }
+
+    std::ofstream outFile;
+    if (!output.empty())
+    {
+        outFile.open(output, std::ios::out);
+        if (!outFile.is_open())
+        {
+            std::cerr << "Could not open " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : outFile;
+
+    if (!VideoStreamEventLog::Decode(in, out, format == "csv"))
+    {
+        std::cerr << input << " is not a valid or complete video stream event log" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -12,6 +12,7 @@
 #include "ns3/point-to-point-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/wifi-module.h"
+#include "ns3/video-stream-wifi-module.h"
 #include "ns3/mobility-module.h"
 #include "ns3/csma-module.h"
 #include "ns3/netanim-module.h"
@@ -44,10 +45,27 @@ NS_LOG_COMPONENT_DEFINE ("VideoStreamTest");
 int
 main (int argc, char *argv[])
 {
+  std::string eventLog = "";
+  bool useProxy = false;
+  bool useRouter = false;
+  bool live = false;
+  bool linkHints = false;
+  double reportInterval = 0.0;
+
   CommandLine cmd;
+  cmd.AddValue ("eventLog", "Binary file the video stream events are recorded to (disabled if empty)", eventLog);
+  cmd.AddValue ("useProxy", "Serve the client of the router topology through a caching proxy on the router", useProxy);
+  cmd.AddValue ("useRouter", "Spread the clients of the three server topology over the servers through a request router on the first access point", useRouter);
+  cmd.AddValue ("live", "Produce the frames on a live timeline and join the clients at the live edge", live);
+  cmd.AddValue ("linkHints", "Let the clients of the Wi-Fi topologies lower their level on the SNR, rate and retries of their link", linkHints);
+  cmd.AddValue ("reportInterval", "Seconds between two receiver reports driving the server rate control (0 disables them)", reportInterval);
   cmd.Parse (argc, argv);
   
   Time::SetResolution (Time::NS);
+  Config::SetDefault ("ns3::VideoStreamServer::EventLogFile", StringValue (eventLog));
+  Config::SetDefault ("ns3::VideoStreamClient::EventLogFile", StringValue (eventLog));
+  Config::SetDefault ("ns3::VideoStreamServer::Live", BooleanValue (live));
+  Config::SetDefault ("ns3::VideoStreamClient::ReportInterval", TimeValue (Seconds (reportInterval)));
   LogComponentEnable ("VideoStreamClientApplication", LOG_LEVEL_INFO);
   LogComponentEnable ("VideoStreamServerApplication", LOG_LEVEL_INFO);
 
@@ -117,138 +135,22 @@ main (int argc, char *argv[])
     Simulator::Run();
 
     // --- FlowMonitor Statistics Collection ---
-    flowmon->CheckForLostPackets();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats();
-
-    // Open an output file to store metrics
-    std::ofstream outFile("flowmon_metrics_CASE_1.csv", std::ios::out);
-    if (!outFile.is_open())
+    FlowMetricsReporter reporter(flowmon, flowmonHelper.GetClassifier());
+    reporter.AddServerPort(port);
+    reporter.SetFlowSelection(FlowMetricsReporter::VIDEO_FLOWS);
+    reporter.SetLinkCapacity(DataRate("60Mbps"));
+    reporter.Collect();
+    reporter.Print(std::cout);
+    if (!reporter.WriteCsv("flowmon_metrics_CASE_1.csv"))
     {
-        NS_LOG_ERROR("Could not open output file for writing metrics.");
         return 1;
     }
 
-    // Write CSV header
-    outFile << "FlowID,Source,Destination,TxPackets,RxPackets,Throughput(Mbps),Goodput(Mbps),AverageDelay(s),PacketLossRatio(%),PacketDeliveryRatio(%),AverageJitter(s),BandwidthUtilization(%),Retransmissions\n";
-
-    // Print header to terminal
-    std::cout << "FlowID\tSource\t\tDestination\tTxPackets\tRxPackets\tThroughput(Mbps)\tGoodput(Mbps)\tAverageDelay(s)\tPacketLossRatio(%)\tPacketDeliveryRatio(%)\tAverageJitter(s)\tBandwidthUtilization(%)\tRetransmissions\n";
-
-    // Variables for Jain's Fairness Index
-    double sumThroughput = 0.0;
-    double sumSqThroughput = 0.0;
-    uint32_t numFlows = 0;
-
-    // Iterate through each flow and extract metrics
-    for (auto &flow : stats)
-    {
-        FlowId flowId = flow.first;
-        FlowMonitor::FlowStats flowStats = flow.second;
-
-        // Get flow classifier information
-        Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow(flowId);
-
-        // Calculate Time Duration
-        double timeDuration = flowStats.timeLastRxPacket.GetSeconds() - flowStats.timeFirstTxPacket.GetSeconds();
-
-        // Calculate Throughput (Mbps)
-        double throughput = (flowStats.rxBytes * 8.0) / timeDuration / 1e6; // Mbps
-
-        // Calculate Goodput (Mbps)
-        // Assuming application data size is equal to rxBytes
-        // If there is overhead, adjust accordingly
-        double goodput = throughput; // In this case, assume no overhead
-
-        // Calculate Average Delay (seconds)
-        double averageDelay = 0.0;
-        if (flowStats.rxPackets > 0)
-        {
-            averageDelay = flowStats.delaySum.GetSeconds() / flowStats.rxPackets;
-        }
-
-        // Calculate Packet Loss Ratio (%)
-        double packetLossRatio = 0.0;
-        if (flowStats.txPackets > 0)
-        {
-            packetLossRatio = ((double)(flowStats.txPackets - flowStats.rxPackets) / flowStats.txPackets) * 100.0;
-        }
-
-        // Calculate Packet Delivery Ratio (%)
-        double packetDeliveryRatio = 0.0;
-        if (flowStats.txPackets > 0)
-        {
-            packetDeliveryRatio = ((double)flowStats.rxPackets / flowStats.txPackets) * 100.0;
-        }
-
-        // Calculate Average Jitter (seconds)
-        double averageJitter = 0.0;
-        if (flowStats.rxPackets > 1)
-        {
-            averageJitter = flowStats.jitterSum.GetSeconds() / (flowStats.rxPackets - 1);
-        }
-
-        // Calculate Bandwidth Utilization (%)
-        double linkCapacity = 60.0; // Mbps
-        double bandwidthUtilization = (throughput / linkCapacity) * 100.0;
-
-        // Calculate Retransmissions
-        // Assuming retransmissions are the difference between MAC-level transmissions and IP-level transmissions
-        uint64_t retransmissions = 0;
-        if (flowStats.txPackets > 0)
-        {
-            retransmissions = flowStats.txPackets - flowStats.rxPackets;
-        }
-
-        // Update variables for Jain's Fairness Index
-        sumThroughput += throughput;
-        sumSqThroughput += throughput * throughput;
-        numFlows++;
-
-        // Write metrics to CSV
-        outFile << flowId << ","
-                << t.sourceAddress << "," << t.destinationAddress << ","
-                << flowStats.txPackets << "," << flowStats.rxPackets << ","
-                << throughput << "," << goodput << ","
-                << averageDelay << "," << packetLossRatio << ","
-                << packetDeliveryRatio << "," << averageJitter << ","
-                << bandwidthUtilization << "," << retransmissions << "\n";
-
-        // Print metrics to terminal
-        std::cout << flowId << "\t"
-                  << t.sourceAddress << "\t"
-                  << t.destinationAddress << "\t"
-                  << flowStats.txPackets << "\t\t"
-                  << flowStats.rxPackets << "\t\t"
-                  << throughput << "\t\t"
-                  << goodput << "\t\t"
-                  << averageDelay << "\t\t"
-                  << packetLossRatio << "\t\t"
-                  << packetDeliveryRatio << "\t\t"
-                  << averageJitter << "\t\t"
-                  << bandwidthUtilization << "\t\t"
-                  << retransmissions << "\n";
-    }
-
-    outFile.close();
-
-    // Calculate Jain's Fairness Index
-    double fairnessIndex = 0.0;
-    if (numFlows > 0)
-    {
-        fairnessIndex = (sumThroughput * sumThroughput) / (numFlows * sumSqThroughput);
-    }
-
-    // Print Jain's Fairness Index
-    std::cout << "\nJain's Fairness Index: " << fairnessIndex << std::endl;
-
-    // --- FlowMonitor Statistics Collection End ---
-
     // Destroy the simulation
     Simulator::Destroy();
 
     // Notify user
-    std::cout << "\nSimulation completed. Metrics have been saved to flowmon_metrics.csv.\n";f
+    std::cout << "\nSimulation completed. Metrics have been saved to flowmon_metrics_CASE_1.csv.\n";
   }
 
   else if (CASE == 2)
@@ -337,141 +239,22 @@ main (int argc, char *argv[])
     Simulator::Run();
 
     // Flow Monitor Analysis
-    flowmon->CheckForLostPackets();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats();
-
-    // Open an output file to store metrics
-    std::ofstream outFile("flowmon_metrics_CASE_2.csv", std::ios::out);
-    if (!outFile.is_open())
+    FlowMetricsReporter reporter(flowmon, flowmonHelper.GetClassifier());
+    reporter.AddServerPort(port);
+    reporter.SetFlowSelection(FlowMetricsReporter::VIDEO_FLOWS);
+    reporter.SetLinkCapacity(DataRate("20Mbps"));
+    reporter.Collect();
+    reporter.Print(std::cout);
+    if (!reporter.WriteCsv("flowmon_metrics_CASE_2.csv"))
     {
-        NS_LOG_ERROR("Could not open output file for writing metrics.");
         return 1;
     }
 
-    // Write CSV header
-    outFile << "FlowID,Source,Destination,TxPackets,RxPackets,Throughput(Mbps),Goodput(Mbps),"
-               "AverageDelay(s),PacketLossRatio(%),PacketDeliveryRatio(%),AverageJitter(s),"
-               "BandwidthUtilization(%),Retransmissions\n";
-
-    // Print header to terminal
-    std::cout << "FlowID\tSource\t\tDestination\tTxPackets\tRxPackets\tThroughput(Mbps)\tGoodput(Mbps)\t"
-                 "AverageDelay(s)\tPacketLossRatio(%)\tPacketDeliveryRatio(%)\tAverageJitter(s)\t"
-                 "BandwidthUtilization(%)\tRetransmissions\n";
-
-    // Variables for Jain's Fairness Index
-    double sumThroughput = 0.0;
-    double sumSqThroughput = 0.0;
-    uint32_t numFlows = 0;
-
-    // Process each flow
-    for (std::map<FlowId, FlowMonitor::FlowStats>::const_iterator it = stats.begin(); it != stats.end(); ++it)
-    {
-        FlowId flowId = it->first;
-        FlowMonitor::FlowStats flowStats = it->second;
-        Ipv4FlowClassifier::FiveTuple flow = classifier->FindFlow(flowId);
-
-        // Only consider flows from the server to clients
-        if ((flow.sourceAddress == i0i1.GetAddress(0) && flow.destinationAddress == i0i1.GetAddress(1)) ||
-            (flow.sourceAddress == i0i2.GetAddress(0) && flow.destinationAddress == i0i2.GetAddress(1)))
-        {
-            // Calculate metrics
-            double timeDuration = flowStats.timeLastRxPacket.GetSeconds() - flowStats.timeFirstTxPacket.GetSeconds();
-            double throughput = (flowStats.rxBytes * 8.0) / timeDuration / 1e6; // Mbps
-
-            // Goodput (assuming no overhead for simplification)
-            double goodput = throughput; // Adjust if overhead is known
-
-            // Average Delay
-            double averageDelay = 0.0;
-            if (flowStats.rxPackets > 0)
-            {
-                averageDelay = flowStats.delaySum.GetSeconds() / flowStats.rxPackets;
-            }
-
-            // Packet Loss Ratio
-            double packetLossRatio = 0.0;
-            if (flowStats.txPackets > 0)
-            {
-                packetLossRatio = ((double)(flowStats.txPackets - flowStats.rxPackets) / flowStats.txPackets) * 100.0;
-            }
-
-            // Packet Delivery Ratio
-            double packetDeliveryRatio = 0.0;
-            if (flowStats.txPackets > 0)
-            {
-                packetDeliveryRatio = ((double)flowStats.rxPackets / flowStats.txPackets) * 100.0;
-            }
-
-            // Average Jitter
-            double averageJitter = 0.0;
-            if (flowStats.rxPackets > 1)
-            {
-                averageJitter = flowStats.jitterSum.GetSeconds() / (flowStats.rxPackets - 1);
-            }
-
-            // Bandwidth Utilization
-            double linkCapacity = 20.0; // Mbps
-            double bandwidthUtilization = (throughput / linkCapacity) * 100.0;
-
-            // Retransmissions (simplified estimation)
-            uint64_t retransmissions = 0;
-            if (flowStats.txPackets > flowStats.rxPackets)
-            {
-                retransmissions = flowStats.txPackets - flowStats.rxPackets;
-            }
-
-            // Update variables for Jain's Fairness Index
-            sumThroughput += throughput;
-            sumSqThroughput += throughput * throughput;
-            numFlows++;
-
-            // Write metrics to CSV
-            outFile << flowId << ","
-                    << flow.sourceAddress << "," << flow.destinationAddress << ","
-                    << flowStats.txPackets << "," << flowStats.rxPackets << ","
-                    << throughput << "," << goodput << ","
-                    << averageDelay << "," << packetLossRatio << ","
-                    << packetDeliveryRatio << "," << averageJitter << ","
-                    << bandwidthUtilization << "," << retransmissions << "\n";
-
-            // Print metrics to terminal
-            std::cout << flowId << "\t"
-                      << flow.sourceAddress << "\t"
-                      << flow.destinationAddress << "\t"
-                      << flowStats.txPackets << "\t\t"
-                      << flowStats.rxPackets << "\t\t"
-                      << throughput << "\t\t"
-                      << goodput << "\t\t"
-                      << averageDelay << "\t\t"
-                      << packetLossRatio << "\t\t"
-                      << packetDeliveryRatio << "\t\t"
-                      << averageJitter << "\t\t"
-                      << bandwidthUtilization << "\t\t"
-                      << retransmissions << "\n";
-        }
-    }
-
-    outFile.close();
-
-    // Calculate Jain's Fairness Index
-    double fairnessIndex = 0.0;
-    if (numFlows > 0)
-    {
-        fairnessIndex = (sumThroughput * sumThroughput) / (numFlows * sumSqThroughput);
-    }
-
-    // Print Jain's Fairness Index
-    std::cout << "\nJain's Fairness Index: " << fairnessIndex << std::endl;
-
-    // Serialize flow monitor data to XML (optional)
     flowmon->SerializeToXmlFile("Case_2_flowmonitor.xml", true, true);
 
-    // Destroy the simulation
     Simulator::Destroy();
 
-    // Notify user
-    std::cout << "\nSimulation completed. Metrics have been saved to flowmon_metrics_case2.csv.\n";
+    std::cout << "\nSimulation completed. Metrics have been saved to flowmon_metrics_CASE_2.csv.\n";
   }
   else if (CASE == 3)
   {
@@ -548,6 +331,11 @@ main (int argc, char *argv[])
       VideoStreamClientHelper videoClient (apInterfaces.GetAddress (0), 5000);
       ApplicationContainer clientApps =
       videoClient.Install (wifiStaNodes.Get (k));
+      if (linkHints)
+      {
+        VideoStreamWifiHintsHelper hints;
+        hints.Install (clientApps);
+      }
       clientApps.Start (Seconds (0.5));
       clientApps.Stop (Seconds (100.0));
     }
@@ -624,9 +412,26 @@ main (int argc, char *argv[])
     wifiInterfaces=address.Assign (staDevices);
                   
     //UdpEchoServerHelper echoServer (9);
+    uint16_t routerPort = 5001;
+    Ptr<VideoStreamRouter> router;
+    if (useRouter)
+    {
+      // the servers report their load to the router, which spreads the clients over them
+      VideoStreamRouterHelper videoRouter (routerPort);
+      ApplicationContainer routerApp = videoRouter.Install (wifiApNode.Get (0));
+      routerApp.Start (Seconds (0.0));
+      routerApp.Stop (Seconds (100.0));
+      router = DynamicCast<VideoStreamRouter> (routerApp.Get (0));
+    }
+
     VideoStreamServerHelper videoServer (5000);
     videoServer.SetAttribute ("MaxPacketSize", UintegerValue (1400));
     videoServer.SetAttribute ("FrameFile", StringValue ("./scratch/videoStreamer/small.txt"));
+    if (useRouter)
+    {
+      videoServer.SetAttribute ("RouterAddress", AddressValue (apInterfaces.GetAddress (0)));
+      videoServer.SetAttribute ("RouterPort", UintegerValue (routerPort));
+    }
     for(uint m=0; m<nAp; m++)
     {
       ApplicationContainer serverApps = videoServer.Install (wifiApNode.Get (m));
@@ -636,9 +441,14 @@ main (int argc, char *argv[])
   
     for(uint k=0; k<nWifi; k++)
     {
-      VideoStreamClientHelper videoClient (apInterfaces.GetAddress (k), 5000);
+      VideoStreamClientHelper videoClient (useRouter ? apInterfaces.GetAddress (0) : apInterfaces.GetAddress (k), useRouter ? routerPort : 5000);
       ApplicationContainer clientApps =
       videoClient.Install (wifiStaNodes.Get (k));
+      if (linkHints)
+      {
+        VideoStreamWifiHintsHelper hints;
+        hints.Install (clientApps);
+      }
       clientApps.Start (Seconds (0.5));
       clientApps.Stop (Seconds (100.0));
     }
@@ -650,6 +460,13 @@ main (int argc, char *argv[])
     phy.EnablePcap ("wifi-videoStream", apDevices.Get (0));
     AnimationInterface anim("wifi-1-3.xml");
     Simulator::Run ();
+    if (router)
+    {
+      for (uint32_t m = 0; m < router->GetServerCount (); m++)
+      {
+        std::cout << "Server " << m << " received " << router->GetRedirectCount (m) << " sessions from the router" << std::endl;
+      }
+    }
     Simulator::Destroy ();
   }
   else if(CASE==5){
@@ -771,8 +588,19 @@ VideoStreamServerHelper videoServer (5000);
     serverApp.Start(Seconds(0.0));
     serverApp.Stop(Seconds(100.0));
 
-    // Client Application (Client to Server)
-    Ipv4Address serverAddress = serverRouterInterfaces.GetAddress(0); // Server's IP
+    // Edge proxy on the router, caching the frames of the server (optional)
+    Ptr<VideoStreamProxy> proxy;
+    if (useProxy)
+    {
+        VideoStreamProxyHelper videoProxy(serverRouterInterfaces.GetAddress(0), port, port);
+        ApplicationContainer proxyApp = videoProxy.Install(routerNode.Get(0));
+        proxyApp.Start(Seconds(0.0));
+        proxyApp.Stop(Seconds(100.0));
+        proxy = DynamicCast<VideoStreamProxy>(proxyApp.Get(0));
+    }
+
+    // Client Application (Client to Server, or to the proxy)
+    Ipv4Address serverAddress = useProxy ? routerClientInterfaces.GetAddress(0) : serverRouterInterfaces.GetAddress(0);
     VideoStreamClientHelper videoClient(serverAddress, port);
 
     ApplicationContainer clientApp = videoClient.Install(clientNode.Get(0));
@@ -816,133 +644,42 @@ VideoStreamServerHelper videoServer (5000);
     Simulator::Run();
 
     // 11. Flow Monitor Analysis
-    flowmon->CheckForLostPackets();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats();
-
-    // Open an output file to store metrics
-    std::ofstream outFile("flowmon_metrics_router_topology_case_6.csv", std::ios::out);
-    if (!outFile.is_open())
+    FlowMetricsReporter reporter(flowmon, flowmonHelper.GetClassifier());
+    reporter.AddServerPort(port);
+    reporter.AddServerPort(reversePort);
+    reporter.SetFlowSelection(FlowMetricsReporter::VIDEO_FLOWS);
+    reporter.SetLinkCapacity(DataRate("60Mbps"));
+    reporter.Collect();
+    reporter.Print(std::cout);
+    if (proxy)
     {
-        NS_LOG_ERROR("Could not open output file for writing metrics.");
-        return 1;
+        std::cout << "Proxy hit ratio: " << proxy->GetHitRatio()
+                  << ", origin offload: " << proxy->GetOriginOffload() << "\n";
     }
-
-    // Write CSV header
-    outFile << "FlowID,Source,Destination,TxPackets,RxPackets,Throughput(Mbps),Goodput(Mbps),"
-               "AverageDelay(s),PacketLossRatio(%),PacketDeliveryRatio(%),AverageJitter(s),"
-               "BandwidthUtilization(%),Retransmissions\n";
-
-    // Print header to terminal
-    std::cout << "FlowID\tSource\t\tDestination\tTxPackets\tRxPackets\tThroughput(Mbps)\tGoodput(Mbps)\t"
-                 "AverageDelay(s)\tPacketLossRatio(%)\tPacketDeliveryRatio(%)\tAverageJitter(s)\t"
-                 "BandwidthUtilization(%)\tRetransmissions\n";
-
-    // Variables for Jain's Fairness Index
-    double sumThroughput = 0.0;
-    double sumSqThroughput = 0.0;
-    uint32_t numFlows = 0;
-
-    // Process each flow
-    for (auto it = stats.begin(); it != stats.end(); ++it)
+    // tail latency of both directions, merged across the clients
+    VideoStreamHistogram frameLatency, fragmentGap, stalls, startup;
+    for (Ptr<Application> app : {clientApp.Get(0), reverseClientApp.Get(0)})
     {
-        FlowId flowId = it->first;
-        FlowMonitor::FlowStats flowStats = it->second;
-        Ipv4FlowClassifier::FiveTuple flow = classifier->FindFlow(flowId);
-
-        // Process flows between server and client in both directions
-        if ((flow.sourceAddress == serverRouterInterfaces.GetAddress(0) && flow.destinationAddress == routerClientInterfaces.GetAddress(1)) ||
-            (flow.sourceAddress == routerClientInterfaces.GetAddress(1) && flow.destinationAddress == serverRouterInterfaces.GetAddress(0)))
-        {
-            // Calculate metrics
-            double timeDuration = flowStats.timeLastRxPacket.GetSeconds() - flowStats.timeFirstTxPacket.GetSeconds();
-            double throughput = (flowStats.rxBytes * 8.0) / timeDuration / 1e6; // Mbps
-
-            // Goodput (assuming no overhead for simplification)
-            double goodput = throughput; // Adjust if overhead is known
-
-            // Average Delay
-            double averageDelay = 0.0;
-            if (flowStats.rxPackets > 0)
-            {
-                averageDelay = flowStats.delaySum.GetSeconds() / flowStats.rxPackets;
-            }
-
-            // Packet Loss Ratio
-            double packetLossRatio = 0.0;
-            if (flowStats.txPackets > 0)
-            {
-                packetLossRatio = ((double)(flowStats.txPackets - flowStats.rxPackets) / flowStats.txPackets) * 100.0;
-            }
-
-            // Packet Delivery Ratio
-            double packetDeliveryRatio = 0.0;
-            if (flowStats.txPackets > 0)
-            {
-                packetDeliveryRatio = ((double)flowStats.rxPackets / flowStats.txPackets) * 100.0;
-            }
-
-            // Average Jitter
-            double averageJitter = 0.0;
-            if (flowStats.rxPackets > 1)
-            {
-                averageJitter = flowStats.jitterSum.GetSeconds() / (flowStats.rxPackets - 1);
-            }
-
-            // Bandwidth Utilization
-            double linkCapacity = 60.0; // Mbps
-            double bandwidthUtilization = (throughput / linkCapacity) * 100.0;
-
-            // Retransmissions (simplified estimation)
-            uint64_t retransmissions = 0;
-            if (flowStats.txPackets > flowStats.rxPackets)
-            {
-                retransmissions = flowStats.txPackets - flowStats.rxPackets;
-            }
-
-            // Update variables for Jain's Fairness Index
-            sumThroughput += throughput;
-            sumSqThroughput += throughput * throughput;
-            numFlows++;
-
-            // Write metrics to CSV
-            outFile << flowId << ","
-                    << flow.sourceAddress << "," << flow.destinationAddress << ","
-                    << flowStats.txPackets << "," << flowStats.rxPackets << ","
-                    << throughput << "," << goodput << ","
-                    << averageDelay << "," << packetLossRatio << ","
-                    << packetDeliveryRatio << "," << averageJitter << ","
-                    << bandwidthUtilization << "," << retransmissions << "\n";
-
-            // Print metrics to terminal
-            std::cout << flowId << "\t"
-                      << flow.sourceAddress << "\t"
-                      << flow.destinationAddress << "\t"
-                      << flowStats.txPackets << "\t\t"
-                      << flowStats.rxPackets << "\t\t"
-                      << throughput << "\t\t"
-                      << goodput << "\t\t"
-                      << averageDelay << "\t\t"
-                      << packetLossRatio << "\t\t"
-                      << packetDeliveryRatio << "\t\t"
-                      << averageJitter << "\t\t"
-                      << bandwidthUtilization << "\t\t"
-                      << retransmissions << "\n";
-        }
+        Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient>(app);
+        frameLatency.Merge(client->GetFrameLatencyHistogram());
+        fragmentGap.Merge(client->GetFragmentGapHistogram());
+        stalls.Merge(client->GetStallHistogram());
+        startup.Record(client->GetStartupDelay());
     }
-
-    outFile.close();
-
-    // Calculate Jain's Fairness Index
-    double fairnessIndex = 0.0;
-    if (numFlows > 0)
+    std::cout << "Frame latency: ";
+    frameLatency.Print(std::cout);
+    std::cout << "\nFragment gap: ";
+    fragmentGap.Print(std::cout);
+    std::cout << "\nStall duration: ";
+    stalls.Print(std::cout);
+    std::cout << "\nStartup delay: ";
+    startup.Print(std::cout);
+    std::cout << "\n";
+    if (!reporter.WriteCsv("flowmon_metrics_router_topology_case_6.csv"))
     {
-        fairnessIndex = (sumThroughput * sumThroughput) / (numFlows * sumSqThroughput);
+        return 1;
     }
 
-    // Print Jain's Fairness Index
-    std::cout << "\nJain's Fairness Index: " << fairnessIndex << std::endl;
-
     // Serialize flow monitor data to XML (optional)
     flowmon->SerializeToXmlFile("router_topology_flowmonitor_case_6.xml", true, true);
 
@@ -950,7 +687,7 @@ VideoStreamServerHelper videoServer (5000);
     Simulator::Destroy();
 
     // Notify user
-    std::cout << "\nSimulation completed. Metrics have been saved to flowmon_metrics_router_topology.csv.\n";
+    std::cout << "\nSimulation completed. Metrics have been saved to flowmon_metrics_router_topology_case_6.csv.\n";
   }
   else if (CASE==7){
   // 1. Create nodes: Server, Router, Client 1, and Client 2
@@ -1131,154 +868,22 @@ VideoStreamServerHelper videoServer (5000);
     Simulator::Run();
 
     // 11. Flow Monitor Analysis
-    flowmon->CheckForLostPackets();
-    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmonHelper.GetClassifier());
-    std::map<FlowId, FlowMonitor::FlowStats> stats = flowmon->GetFlowStats();
-
-    // Open an output file to store metrics
-    std::ofstream outFile("flowmon_metrics_all_paths_case_7.csv", std::ios::out);
-    if (!outFile.is_open())
+    FlowMetricsReporter reporter(flowmon, flowmonHelper.GetClassifier());
+    reporter.AddServerPort(portSC1);
+    reporter.AddServerPort(portSC2);
+    reporter.AddServerPort(portC1C2);
+    reporter.AddServerPort(portSC1 + 10);
+    reporter.AddServerPort(portSC2 + 10);
+    reporter.AddServerPort(portC1C2 + 10);
+    reporter.SetFlowSelection(FlowMetricsReporter::VIDEO_FLOWS);
+    reporter.SetLinkCapacity(DataRate("60Mbps"));
+    reporter.Collect();
+    reporter.Print(std::cout);
+    if (!reporter.WriteCsv("flowmon_metrics_all_paths_case_7.csv"))
     {
-        NS_LOG_ERROR("Could not open output file for writing metrics.");
         return 1;
     }
 
-    // Write CSV header
-    outFile << "FlowID,Source,Destination,TxPackets,RxPackets,Throughput(Mbps),Goodput(Mbps),"
-               "AverageDelay(s),PacketLossRatio(%),PacketDeliveryRatio(%),AverageJitter(s),"
-               "BandwidthUtilization(%),Retransmissions\n";
-
-    // Print header to terminal
-    std::cout << "FlowID\tSource\t\tDestination\tTxPackets\tRxPackets\tThroughput(Mbps)\tGoodput(Mbps)\t"
-                 "AverageDelay(s)\tPacketLossRatio(%)\tPacketDeliveryRatio(%)\tAverageJitter(s)\t"
-                 "BandwidthUtilization(%)\tRetransmissions\n";
-
-    // Variables for Jain's Fairness Index
-    double sumThroughput = 0.0;
-    double sumSqThroughput = 0.0;
-    uint32_t numFlows = 0;
-
-    // Process each flow
-    for (auto it = stats.begin(); it != stats.end(); ++it)
-    {
-        FlowId flowId = it->first;
-        FlowMonitor::FlowStats flowStats = it->second;
-        Ipv4FlowClassifier::FiveTuple flow = classifier->FindFlow(flowId);
-
-        // Process flows between all nodes
-        // Identify flows based on source and destination addresses and ports
-        bool relevantFlow = false;
-
-        // Server ↔ Client 1
-        if ((flow.sourceAddress == serverRouterInterfaces.GetAddress(0) && flow.destinationAddress == routerClient1Interfaces.GetAddress(1) && flow.sourcePort == portSC1) ||
-            (flow.sourceAddress == routerClient1Interfaces.GetAddress(1) && flow.destinationAddress == serverRouterInterfaces.GetAddress(0) && flow.destinationPort == portSC1 + 10))
-        {
-            relevantFlow = true;
-        }
-        // Server ↔ Client 2
-        else if ((flow.sourceAddress == serverRouterInterfaces.GetAddress(0) && flow.destinationAddress == routerClient2Interfaces.GetAddress(1) && flow.sourcePort == portSC2) ||
-                 (flow.sourceAddress == routerClient2Interfaces.GetAddress(1) && flow.destinationAddress == serverRouterInterfaces.GetAddress(0) && flow.destinationPort == portSC2 + 10))
-        {
-            relevantFlow = true;
-        }
-        // Client 1 ↔ Client 2
-        else if ((flow.sourceAddress == routerClient1Interfaces.GetAddress(1) && flow.destinationAddress == routerClient2Interfaces.GetAddress(1) && flow.sourcePort == portC1C2) ||
-                 (flow.sourceAddress == routerClient2Interfaces.GetAddress(1) && flow.destinationAddress == routerClient1Interfaces.GetAddress(1) && flow.sourcePort == portC1C2 + 10))
-        {
-            relevantFlow = true;
-        }
-
-        if (relevantFlow)
-        {
-            // Calculate metrics
-            double timeDuration = flowStats.timeLastRxPacket.GetSeconds() - flowStats.timeFirstTxPacket.GetSeconds();
-            double throughput = (flowStats.rxBytes * 8.0) / timeDuration / 1e6; // Mbps
-
-            // Goodput (assuming no overhead for simplification)
-            double goodput = throughput; // Adjust if overhead is known
-
-            // Average Delay
-            double averageDelay = 0.0;
-            if (flowStats.rxPackets > 0)
-            {
-                averageDelay = flowStats.delaySum.GetSeconds() / flowStats.rxPackets;
-            }
-
-            // Packet Loss Ratio
-            double packetLossRatio = 0.0;
-            if (flowStats.txPackets > 0)
-            {
-                packetLossRatio = ((double)(flowStats.txPackets - flowStats.rxPackets) / flowStats.txPackets) * 100.0;
-            }
-
-            // Packet Delivery Ratio
-            double packetDeliveryRatio = 0.0;
-            if (flowStats.txPackets > 0)
-            {
-                packetDeliveryRatio = ((double)flowStats.rxPackets / flowStats.txPackets) * 100.0;
-            }
-
-            // Average Jitter
-            double averageJitter = 0.0;
-            if (flowStats.rxPackets > 1)
-            {
-                averageJitter = flowStats.jitterSum.GetSeconds() / (flowStats.rxPackets - 1);
-            }
-
-            // Bandwidth Utilization
-            double linkCapacity = 60.0; // Mbps
-            double bandwidthUtilization = (throughput / linkCapacity) * 100.0;
-
-            // Retransmissions (simplified estimation)
-            uint64_t retransmissions = 0;
-            if (flowStats.txPackets > flowStats.rxPackets)
-            {
-                retransmissions = flowStats.txPackets - flowStats.rxPackets;
-            }
-
-            // Update variables for Jain's Fairness Index
-            sumThroughput += throughput;
-            sumSqThroughput += throughput * throughput;
-            numFlows++;
-
-            // Write metrics to CSV
-            outFile << flowId << ","
-                    << flow.sourceAddress << "," << flow.destinationAddress << ","
-                    << flowStats.txPackets << "," << flowStats.rxPackets << ","
-                    << throughput << "," << goodput << ","
-                    << averageDelay << "," << packetLossRatio << ","
-                    << packetDeliveryRatio << "," << averageJitter << ","
-                    << bandwidthUtilization << "," << retransmissions << "\n";
-
-            // Print metrics to terminal
-            std::cout << flowId << "\t"
-                      << flow.sourceAddress << "\t"
-                      << flow.destinationAddress << "\t"
-                      << flowStats.txPackets << "\t\t"
-                      << flowStats.rxPackets << "\t\t"
-                      << throughput << "\t\t"
-                      << goodput << "\t\t"
-                      << averageDelay << "\t\t"
-                      << packetLossRatio << "\t\t"
-                      << packetDeliveryRatio << "\t\t"
-                      << averageJitter << "\t\t"
-                      << bandwidthUtilization << "\t\t"
-                      << retransmissions << "\n";
-        }
-    }
-
-    outFile.close();
-
-    // Calculate Jain's Fairness Index
-    double fairnessIndex = 0.0;
-    if (numFlows > 0)
-    {
-        fairnessIndex = (sumThroughput * sumThroughput) / (numFlows * sumSqThroughput);
-    }
-
-    // Print Jain's Fairness Index
-    std::cout << "\nJain's Fairness Index: " << fairnessIndex << std::endl;
-
     // Serialize flow monitor data to XML (optional)
     flowmon->SerializeToXmlFile("all_paths_flowmonitor_case_7.xml", true, true);
 
@@ -1286,7 +891,7 @@ VideoStreamServerHelper videoServer (5000);
     Simulator::Destroy();
 
     // Notify user
-    std::cout << "\nSimulation completed. Metrics have been saved to flowmon_metrics_all_paths.csv.\n";
+    std::cout << "\nSimulation completed. Metrics have been saved to flowmon_metrics_all_paths_case_7.csv.\n";
   }
   else if (CASE==8){
     // 1. Create nodes
@@ -1428,9 +1033,24 @@ VideoStreamServerHelper videoServer (5000);
         anim.UpdateNodeColor(clientNodes.Get(i), 0, 0, 255); // Blue
     }
 
-    // 9. Run the simulation
+    // 9. Sample the throughput of every flow and client session every 500 ms
+    FlowMonitorHelper flowmonHelper;
+    Ptr<FlowMonitor> flowmon = flowmonHelper.InstallAll();
+
+    Ptr<FlowThroughputSampler> sampler = CreateObject<FlowThroughputSampler>();
+    sampler->SetAttribute("Window", TimeValue(MilliSeconds(500)));
+    sampler->SetAttribute("OutputFile", StringValue("throughput_samples_case_8.csv"));
+    sampler->SetMonitor(flowmon);
+    for (uint32_t i = 0; i < clientApps.GetN(); ++i)
+    {
+        sampler->AddSession(clientApps.Get(i));
+    }
+    sampler->Start(Seconds(1.0));
+
+    // 10. Run the simulation
     Simulator::Stop(Seconds(100.0));
     Simulator::Run();
+    sampler->Stop();
     Simulator::Destroy();
   }
   else if (CASE==9){
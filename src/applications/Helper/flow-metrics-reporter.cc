@@ -0,0 +1,214 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "flow-metrics-reporter.h"
+#include "ns3/log.h"
+
+#include <fstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowMetricsReporter");
+
+FlowMetricsReporter::FlowMetricsReporter (Ptr<FlowMonitor> monitor, Ptr<FlowClassifier> classifier)
+  : m_monitor (monitor),
+    m_classifier (DynamicCast<Ipv4FlowClassifier> (classifier)),
+    m_selection (ALL_FLOWS),
+    m_linkCapacity (DataRate (0)),
+    m_sumThroughput (0.0),
+    m_sumSqThroughput (0.0),
+    m_fairFlows (0)
+{
+  NS_ASSERT_MSG (m_classifier, "FlowMetricsReporter requires an Ipv4FlowClassifier");
+}
+
+void
+FlowMetricsReporter::AddServerPort (uint16_t port)
+{
+  m_serverPorts.insert (port);
+}
+
+void
+FlowMetricsReporter::SetFlowSelection (FlowSelection selection)
+{
+  m_selection = selection;
+}
+
+void
+FlowMetricsReporter::AddAddressPair (Ipv4Address a, Ipv4Address b)
+{
+  m_pairs.push_back (std::make_pair (a, b));
+}
+
+void
+FlowMetricsReporter::SetLinkCapacity (DataRate capacity)
+{
+  m_linkCapacity = capacity;
+}
+
+bool
+FlowMetricsReporter::IsSelected (const Ipv4FlowClassifier::FiveTuple &tuple) const
+{
+  if (!m_pairs.empty ())
+  {
+    bool matched = false;
+    for (auto &pair : m_pairs)
+    {
+      if ((tuple.sourceAddress == pair.first && tuple.destinationAddress == pair.second) ||
+          (tuple.sourceAddress == pair.second && tuple.destinationAddress == pair.first))
+      {
+        matched = true;
+        break;
+      }
+    }
+    if (!matched)
+    {
+      return false;
+    }
+  }
+
+  if (m_serverPorts.empty ())
+  {
+    return true;
+  }
+
+  bool fromServer = m_serverPorts.count (tuple.sourcePort) > 0;
+  bool toServer = m_serverPorts.count (tuple.destinationPort) > 0;
+  switch (m_selection)
+  {
+    case VIDEO_FLOWS:
+      return fromServer;
+    case FEEDBACK_FLOWS:
+      return toServer;
+    default:
+      return fromServer || toServer;
+  }
+}
+
+void
+FlowMetricsReporter::Collect (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_monitor->CheckForLostPackets ();
+  const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+
+  m_flows.clear ();
+  m_flows.reserve (stats.size ());
+  m_sumThroughput = 0.0;
+  m_sumSqThroughput = 0.0;
+  m_fairFlows = 0;
+
+  double capacity = m_linkCapacity.GetBitRate () / 1e6;
+  for (auto &flow : stats)
+  {
+    const FlowMonitor::FlowStats &flowStats = flow.second;
+    Ipv4FlowClassifier::FiveTuple tuple = m_classifier->FindFlow (flow.first);
+    if (!IsSelected (tuple))
+    {
+      continue;
+    }
+
+    FlowMetrics metrics;
+    metrics.m_flowId = flow.first;
+    metrics.m_tuple = tuple;
+    metrics.m_txPackets = flowStats.txPackets;
+    metrics.m_rxPackets = flowStats.rxPackets;
+    metrics.m_rxBytes = flowStats.rxBytes;
+    metrics.m_duration = (flowStats.timeLastRxPacket - flowStats.timeFirstTxPacket).GetSeconds ();
+    metrics.m_lostPackets = flowStats.txPackets > flowStats.rxPackets ? flowStats.txPackets - flowStats.rxPackets : 0;
+
+    // A flow with a single packet (or none) has no meaningful rate
+    bool hasRate = flowStats.rxPackets > 0 && metrics.m_duration > 0.0;
+    metrics.m_throughput = hasRate ? flowStats.rxBytes * 8.0 / metrics.m_duration / 1e6 : 0.0;
+    metrics.m_averageDelay = flowStats.rxPackets > 0 ? flowStats.delaySum.GetSeconds () / flowStats.rxPackets : 0.0;
+    metrics.m_averageJitter = flowStats.rxPackets > 1 ? flowStats.jitterSum.GetSeconds () / (flowStats.rxPackets - 1) : 0.0;
+    metrics.m_lossRatio = flowStats.txPackets > 0 ? 100.0 * metrics.m_lostPackets / flowStats.txPackets : 0.0;
+    metrics.m_deliveryRatio = flowStats.txPackets > 0 ? 100.0 * flowStats.rxPackets / flowStats.txPackets : 0.0;
+    metrics.m_utilization = capacity > 0.0 ? 100.0 * metrics.m_throughput / capacity : 0.0;
+
+    // Starved flows count in the fairness index, single-instant flows do not
+    if (hasRate || flowStats.rxPackets == 0)
+    {
+      m_sumThroughput += metrics.m_throughput;
+      m_sumSqThroughput += metrics.m_throughput * metrics.m_throughput;
+      m_fairFlows++;
+    }
+    m_flows.push_back (metrics);
+  }
+}
+
+const std::vector<FlowMetricsReporter::FlowMetrics> &
+FlowMetricsReporter::GetFlowMetrics (void) const
+{
+  return m_flows;
+}
+
+double
+FlowMetricsReporter::GetFairnessIndex (void) const
+{
+  if (m_fairFlows == 0 || m_sumSqThroughput <= 0.0)
+  {
+    return 0.0;
+  }
+  return (m_sumThroughput * m_sumThroughput) / (m_fairFlows * m_sumSqThroughput);
+}
+
+double
+FlowMetricsReporter::GetAggregateThroughput (void) const
+{
+  return m_sumThroughput;
+}
+
+bool
+FlowMetricsReporter::WriteCsv (std::string fileName) const
+{
+  std::ofstream outFile (fileName, std::ios::out);
+  if (!outFile.is_open ())
+  {
+    NS_LOG_ERROR ("Could not open " << fileName << " for writing metrics.");
+    return false;
+  }
+
+  outFile << "FlowID,Source,SourcePort,Destination,DestinationPort,TxPackets,RxPackets,RxBytes,Duration(s),"
+             "Throughput(Mbps),AverageDelay(s),PacketLossRatio(%),PacketDeliveryRatio(%),AverageJitter(s),"
+             "BandwidthUtilization(%),LostPackets\n";
+  for (auto &flow : m_flows)
+  {
+    outFile << flow.m_flowId << ","
+            << flow.m_tuple.sourceAddress << "," << flow.m_tuple.sourcePort << ","
+            << flow.m_tuple.destinationAddress << "," << flow.m_tuple.destinationPort << ","
+            << flow.m_txPackets << "," << flow.m_rxPackets << "," << flow.m_rxBytes << ","
+            << flow.m_duration << "," << flow.m_throughput << ","
+            << flow.m_averageDelay << "," << flow.m_lossRatio << ","
+            << flow.m_deliveryRatio << "," << flow.m_averageJitter << ","
+            << flow.m_utilization << "," << flow.m_lostPackets << "\n";
+  }
+  return true;
+}
+
+void
+FlowMetricsReporter::Print (std::ostream &os) const
+{
+  os << "FlowID\tSource\t\tDestination\tTxPackets\tRxPackets\tThroughput(Mbps)\tAverageDelay(s)\t"
+        "PacketLossRatio(%)\tPacketDeliveryRatio(%)\tAverageJitter(s)\tBandwidthUtilization(%)\tLostPackets\n";
+  for (auto &flow : m_flows)
+  {
+    os << flow.m_flowId << "\t"
+       << flow.m_tuple.sourceAddress << ":" << flow.m_tuple.sourcePort << "\t"
+       << flow.m_tuple.destinationAddress << ":" << flow.m_tuple.destinationPort << "\t"
+       << flow.m_txPackets << "\t\t"
+       << flow.m_rxPackets << "\t\t"
+       << flow.m_throughput << "\t\t"
+       << flow.m_averageDelay << "\t\t"
+       << flow.m_lossRatio << "\t\t"
+       << flow.m_deliveryRatio << "\t\t"
+       << flow.m_averageJitter << "\t\t"
+       << flow.m_utilization << "\t\t"
+       << flow.m_lostPackets << "\n";
+  }
+  os << "\nFlows: " << m_flows.size ()
+     << ", aggregate throughput: " << GetAggregateThroughput () << " Mbps"
+     << ", Jain's Fairness Index: " << GetFairnessIndex () << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef FLOW_METRICS_REPORTER_H
+#define FLOW_METRICS_REPORTER_H
+
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-flow-classifier.h"
+
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @brief Compute per-flow and aggregate metrics from a FlowMonitor.
+ *
+ * All the metrics (throughput, delay, jitter, loss and Jain's fairness
+ * index) are computed in a single pass over the monitor statistics, and
+ * only for the flows accepted by the configured filters. Video flows are
+ * the ones whose source port is a registered server port, feedback flows
+ * the ones whose destination port is.
+ */
+class FlowMetricsReporter
+{
+public:
+  /**
+   * @brief Which flows are accepted with respect to the server ports.
+   */
+  enum FlowSelection
+  {
+    ALL_FLOWS,      //!< Every flow
+    VIDEO_FLOWS,    //!< Flows sent from a server port
+    FEEDBACK_FLOWS  //!< Flows sent to a server port
+  };
+
+  /**
+   * @brief The metrics of a single flow.
+   */
+  typedef struct FlowMetrics
+  {
+    FlowId m_flowId; //!< Flow identifier
+    Ipv4FlowClassifier::FiveTuple m_tuple; //!< Five tuple of the flow
+    uint32_t m_txPackets; //!< Number of transmitted packets
+    uint32_t m_rxPackets; //!< Number of received packets
+    uint64_t m_rxBytes; //!< Number of received bytes
+    double m_duration; //!< Seconds between the first transmission and the last reception
+    double m_throughput; //!< Throughput in Mbps (0 when the duration is not positive)
+    double m_averageDelay; //!< Average delay in seconds
+    double m_averageJitter; //!< Average jitter in seconds
+    double m_lossRatio; //!< Packet loss ratio in percent
+    double m_deliveryRatio; //!< Packet delivery ratio in percent
+    double m_utilization; //!< Throughput relative to the link capacity in percent
+    uint32_t m_lostPackets; //!< Transmitted packets that were not received
+  } FlowMetrics;
+
+  /**
+   * @brief Construct a new FlowMetricsReporter object.
+   *
+   * @param monitor the flow monitor to read the statistics from
+   * @param classifier the IPv4 flow classifier of the monitor
+   */
+  FlowMetricsReporter (Ptr<FlowMonitor> monitor, Ptr<FlowClassifier> classifier);
+
+  /**
+   * @brief Register the port of a video server.
+   *
+   * @param port the port the server listens on
+   */
+  void AddServerPort (uint16_t port);
+
+  /**
+   * @brief Select the flows according to the registered server ports.
+   *
+   * Without any registered server port, all the flows are selected.
+   *
+   * @param selection the flows to select
+   */
+  void SetFlowSelection (FlowSelection selection);
+
+  /**
+   * @brief Only accept the flows between two addresses, in either direction.
+   *
+   * Several pairs can be added; a flow is accepted if it matches any of them.
+   *
+   * @param a the first address
+   * @param b the second address
+   */
+  void AddAddressPair (Ipv4Address a, Ipv4Address b);
+
+  /**
+   * @brief Set the link capacity used for the bandwidth utilization.
+   *
+   * @param capacity the link capacity (utilization is 0 if not set)
+   */
+  void SetLinkCapacity (DataRate capacity);
+
+  /**
+   * @brief Compute the metrics of the selected flows.
+   */
+  void Collect (void);
+
+  /**
+   * @brief Get the metrics of the selected flows.
+   *
+   * @return the per-flow metrics computed by the last Collect
+   */
+  const std::vector<FlowMetrics> &GetFlowMetrics (void) const;
+
+  /**
+   * @brief Get Jain's fairness index over the selected flows.
+   *
+   * Flows that received packets within a zero duration do not have a
+   * throughput and are left out of the index.
+   *
+   * @return the fairness index (0 if there is no flow)
+   */
+  double GetFairnessIndex (void) const;
+
+  /**
+   * @brief Get the sum of the throughput of the selected flows.
+   *
+   * @return the aggregate throughput in Mbps
+   */
+  double GetAggregateThroughput (void) const;
+
+  /**
+   * @brief Write the per-flow metrics to a CSV file.
+   *
+   * @param fileName the name of the file
+   * @return true if the file was written
+   */
+  bool WriteCsv (std::string fileName) const;
+
+  /**
+   * @brief Print the per-flow metrics and the summary.
+   *
+   * @param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+private:
+  /**
+   * @brief Check if a flow is accepted by the filters.
+   *
+   * @param tuple the five tuple of the flow
+   * @return true if the flow is selected
+   */
+  bool IsSelected (const Ipv4FlowClassifier::FiveTuple &tuple) const;
+
+  Ptr<FlowMonitor> m_monitor; //!< Flow monitor
+  Ptr<Ipv4FlowClassifier> m_classifier; //!< Flow classifier
+  FlowSelection m_selection; //!< Flows selected with respect to the server ports
+  std::set<uint16_t> m_serverPorts; //!< Ports of the video servers
+  std::vector<std::pair<Ipv4Address, Ipv4Address>> m_pairs; //!< Accepted address pairs
+  DataRate m_linkCapacity; //!< Link capacity for the utilization
+
+  std::vector<FlowMetrics> m_flows; //!< Metrics of the selected flows
+  double m_sumThroughput; //!< Sum of the throughput of the fair-share flows
+  double m_sumSqThroughput; //!< Sum of the squared throughput of the fair-share flows
+  uint32_t m_fairFlows; //!< Number of flows in the fairness index
+};
+
+} // namespace ns3
+
+#endif /* FLOW_METRICS_REPORTER_H */
@@ -3,8 +3,12 @@
 #include "video-stream-helper.h"
 #include "ns3/video-stream-server.h"
 #include "ns3/video-stream-client.h"
+#include "ns3/video-stream-proxy.h"
+#include "ns3/video-stream-router.h"
 #include "ns3/uinteger.h"
 #include "ns3/names.h"
+#include "ns3/integer.h"
+#include "ns3/double.h"
 
 namespace ns3{
 
@@ -74,6 +78,25 @@ VideoStreamClientHelper::SetAttribute(std::string name, const AttributeValue &va
   m_factory.Set (name, value);
 }
 
+void
+VideoStreamClientHelper::SetContentPopularity (uint32_t titles, double exponent)
+{
+  m_popularity = CreateObject<ZipfRandomVariable> ();
+  m_popularity->SetAttribute ("N", IntegerValue (titles));
+  m_popularity->SetAttribute ("Alpha", DoubleValue (exponent));
+}
+
+int64_t
+VideoStreamClientHelper::AssignStreams (int64_t stream)
+{
+  if (m_popularity == 0)
+  {
+    return 0;
+  }
+  m_popularity->SetStream (stream);
+  return 1;
+}
+
 ApplicationContainer 
 VideoStreamClientHelper::Install (Ptr<Node> node) const
 {
@@ -103,6 +126,115 @@ Ptr<Application>
 VideoStreamClientHelper::InstallPriv (Ptr<Node> node) const
 {
   Ptr<Application> app = m_factory.Create<VideoStreamClient> ();
+  if (m_popularity != 0)
+  {
+    // the Zipf variable draws ranks from 1, content IDs start at 0
+    app->SetAttribute ("ContentId", UintegerValue (m_popularity->GetInteger () - 1));
+  }
+  node->AddApplication (app);
+
+  return app;
+}
+
+VideoStreamProxyHelper::VideoStreamProxyHelper (Address origin, uint16_t originPort, uint16_t port)
+{
+  m_factory.SetTypeId (VideoStreamProxy::GetTypeId ());
+  SetAttribute ("RemoteAddress", AddressValue (origin));
+  SetAttribute ("RemotePort", UintegerValue (originPort));
+  SetAttribute ("Port", UintegerValue (port));
+}
+
+void
+VideoStreamProxyHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer 
+VideoStreamProxyHelper::Install (Ptr<Node> node) const
+{
+  return ApplicationContainer (InstallPriv (node));
+}
+
+ApplicationContainer 
+VideoStreamProxyHelper::Install (std::string nodeName) const
+{
+  Ptr<Node> node = Names::Find<Node> (nodeName);
+  return ApplicationContainer (InstallPriv (node));
+}
+
+ApplicationContainer 
+VideoStreamProxyHelper::Install (NodeContainer c) const
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin(); i != c.End(); i++)
+  {
+    apps.Add (InstallPriv (*i));
+  }
+  
+  return apps;
+}
+
+Ptr<Application>
+VideoStreamProxyHelper::InstallPriv (Ptr<Node> node) const
+{
+  Ptr<Application> app = m_factory.Create<VideoStreamProxy> ();
+  node->AddApplication (app);
+
+  return app;
+}
+
+VideoStreamRouterHelper::VideoStreamRouterHelper (uint16_t port)
+{
+  m_factory.SetTypeId (VideoStreamRouter::GetTypeId ());
+  SetAttribute ("Port", UintegerValue (port));
+}
+
+void
+VideoStreamRouterHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+void
+VideoStreamRouterHelper::AddServer (Ipv4Address address, uint16_t port)
+{
+  m_servers.push_back (std::make_pair (address, port));
+}
+
+ApplicationContainer 
+VideoStreamRouterHelper::Install (Ptr<Node> node) const
+{
+  return ApplicationContainer (InstallPriv (node));
+}
+
+ApplicationContainer 
+VideoStreamRouterHelper::Install (std::string nodeName) const
+{
+  Ptr<Node> node = Names::Find<Node> (nodeName);
+  return ApplicationContainer (InstallPriv (node));
+}
+
+ApplicationContainer 
+VideoStreamRouterHelper::Install (NodeContainer c) const
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin(); i != c.End(); i++)
+  {
+    apps.Add (InstallPriv (*i));
+  }
+  
+  return apps;
+}
+
+Ptr<Application>
+VideoStreamRouterHelper::InstallPriv (Ptr<Node> node) const
+{
+  Ptr<VideoStreamRouter> app = m_factory.Create<VideoStreamRouter> ();
+  for (const auto &server : m_servers)
+  {
+    app->AddServer (server.first, server.second);
+  }
   node->AddApplication (app);
 
   return app;
@@ -9,6 +9,10 @@
 #include "ns3/object-factory.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
+#include "ns3/random-variable-stream.h"
+
+#include <utility>
+#include <vector>
 
 namespace ns3 {
 
@@ -81,6 +85,7 @@ private:
    */
   Ptr<Application> InstallPriv (Ptr<Node> node) const;
   ObjectFactory m_factory; 
+  Ptr<ZipfRandomVariable> m_popularity; //!< Title popularity, null to keep the ContentId attribute
 
 public:
   /**
@@ -104,6 +109,24 @@ public:
    * @param value the value of the attribute to set
    */
   void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * @brief Choose the title of each created client with a Zipf popularity model.
+   * 
+   * The most popular title is content ID 0. This overrides the ContentId attribute.
+   * 
+   * @param titles the number of titles in the catalog
+   * @param exponent the Zipf exponent, larger values concentrate the requests on fewer titles
+   */
+  void SetContentPopularity (uint32_t titles, double exponent);
+
+  /**
+   * @brief Assign a fixed random variable stream number to the popularity model.
+   * 
+   * @param stream first stream index to use
+   * @return the number of stream indices assigned by this helper
+   */
+  int64_t AssignStreams (int64_t stream);
   
   /**
    * @brief Create a VideoStreamClientApplication on the specified node.
@@ -130,6 +153,133 @@ public:
   ApplicationContainer Install (NodeContainer c) const;
 };
 
+/**
+ * @brief Create an edge proxy application that caches the frames of an origin server.
+ */
+class VideoStreamProxyHelper
+{
+private:
+  /**
+   * @brief Install an ns3::VideoStreamProxy on the node configured with all the 
+   * attributes set with SetAttribute.
+   * 
+   * @param node the node on which an VideoStreamProxy will be installed
+   * @return Ptr<Application> 
+   */
+  Ptr<Application> InstallPriv (Ptr<Node> node) const;
+  ObjectFactory m_factory;
+
+public:
+  /**
+   * @brief Construct a new VideoStreamProxyHelper object. 
+   * 
+   * @param origin the IP address of the origin server
+   * @param originPort the port number of the origin server
+   * @param port the port the proxy will receive incoming packets
+   */
+  VideoStreamProxyHelper (Address origin, uint16_t originPort, uint16_t port);
+  
+  /**
+   * @brief Record an attribute to be set in each application after it is created.
+   * 
+   * @param name the name of the attribute to set
+   * @param value the value of the attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * @brief Create a VideoStreamProxyApplication on the specified node.
+   * 
+   * @param node the node on which to create the application
+   * @return ApplicationContainer holding the created application
+   */
+  ApplicationContainer Install (Ptr<Node> node) const;
+
+  /**
+   * @brief Create a VideoStreamProxyApplication on the specified node.
+   * 
+   * @param nodeName the node on which to create the application
+   * @return ApplicationContainer holding the created application
+   */
+  ApplicationContainer Install (std::string nodeName) const;
+  
+  /**
+   * @brief Create a VideoStreamProxyApplication on the specified node.
+   * 
+   * @param c the nodes on which to create the applications
+   * @return ApplicationContainer with one application per node in the NodeContainer
+   */
+  ApplicationContainer Install (NodeContainer c) const;
+};
+
+/**
+ * @brief Create a request router application that redirects the clients to servers.
+ */
+class VideoStreamRouterHelper
+{
+private:
+  /**
+   * @brief Install an ns3::VideoStreamRouter on the node configured with all the 
+   * attributes set with SetAttribute and the servers added with AddServer.
+   * 
+   * @param node the node on which an VideoStreamRouter will be installed
+   * @return Ptr<Application> 
+   */
+  Ptr<Application> InstallPriv (Ptr<Node> node) const;
+  ObjectFactory m_factory;
+  std::vector<std::pair<Ipv4Address, uint16_t>> m_servers;
+
+public:
+  /**
+   * @brief Construct a new VideoStreamRouterHelper object. 
+   * 
+   * @param port the port the router will receive incoming packets
+   */
+  VideoStreamRouterHelper (uint16_t port);
+  
+  /**
+   * @brief Record an attribute to be set in each application after it is created.
+   * 
+   * @param name the name of the attribute to set
+   * @param value the value of the attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * @brief Record a server added to each application after it is created.
+   * 
+   * Servers with a RouterAddress are also learnt from their load reports.
+   * 
+   * @param address the IP address of the server
+   * @param port the port number of the server
+   */
+  void AddServer (Ipv4Address address, uint16_t port);
+
+  /**
+   * @brief Create a VideoStreamRouterApplication on the specified node.
+   * 
+   * @param node the node on which to create the application
+   * @return ApplicationContainer holding the created application
+   */
+  ApplicationContainer Install (Ptr<Node> node) const;
+
+  /**
+   * @brief Create a VideoStreamRouterApplication on the specified node.
+   * 
+   * @param nodeName the node on which to create the application
+   * @return ApplicationContainer holding the created application
+   */
+  ApplicationContainer Install (std::string nodeName) const;
+  
+  /**
+   * @brief Create a VideoStreamRouterApplication on the specified node.
+   * 
+   * @param c the nodes on which to create the applications
+   * @return ApplicationContainer with one application per node in the NodeContainer
+   */
+  ApplicationContainer Install (NodeContainer c) const;
+};
+
 } // namespace ns3
 
 #endif /* VIDEO_STREAM_HELPER_H */
\ No newline at end of file
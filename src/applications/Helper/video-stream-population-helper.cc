@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "video-stream-population-helper.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/video-stream-client.h"
+
+#include <fstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamPopulationHelper");
+
+VideoStreamPopulationHelper::VideoStreamPopulationHelper (Address ip, uint16_t port)
+  : m_clientHelper (ip, port),
+    m_remote (ip),
+    m_arrivalProcess (SIMULTANEOUS),
+    m_spacing (Seconds (0)),
+    m_packetInterval (1)
+{
+  m_interArrival = CreateObject<ExponentialRandomVariable> ();
+}
+
+void
+VideoStreamPopulationHelper::SetClientAttribute (std::string name, const AttributeValue &value)
+{
+  m_clientHelper.SetAttribute (name, value);
+}
+
+void
+VideoStreamPopulationHelper::SetContentPopularity (uint32_t titles, double exponent)
+{
+  m_clientHelper.SetContentPopularity (titles, exponent);
+}
+
+void
+VideoStreamPopulationHelper::SetSimultaneousArrivals (void)
+{
+  m_arrivalProcess = SIMULTANEOUS;
+}
+
+void
+VideoStreamPopulationHelper::SetStaggeredArrivals (Time spacing)
+{
+  m_arrivalProcess = STAGGERED;
+  m_spacing = spacing;
+}
+
+void
+VideoStreamPopulationHelper::SetPoissonArrivals (double rate)
+{
+  NS_ABORT_MSG_IF (rate <= 0.0, "The arrival rate must be positive");
+  m_arrivalProcess = POISSON;
+  m_interArrival->SetAttribute ("Mean", DoubleValue (1.0 / rate));
+}
+
+void
+VideoStreamPopulationHelper::SetArrivalTrace (std::string fileName)
+{
+  std::ifstream fileStream (fileName);
+  NS_ABORT_MSG_IF (!fileStream.is_open (), "Could not open " << fileName);
+
+  m_arrivalProcess = TRACE;
+  m_arrivalTrace.clear ();
+  double offset;
+  while (fileStream >> offset)
+  {
+    m_arrivalTrace.push_back (Seconds (offset));
+  }
+  NS_LOG_INFO ("Arrival trace size: " << m_arrivalTrace.size ());
+}
+
+void
+VideoStreamPopulationHelper::SetSessionLength (Ptr<RandomVariableStream> length)
+{
+  m_sessionLength = length;
+}
+
+void
+VideoStreamPopulationHelper::SetFluidModel (Ptr<VideoStreamFluidModel> model, uint32_t packetInterval)
+{
+  NS_ABORT_MSG_IF (packetInterval == 0, "The packet interval must be positive");
+  m_fluidModel = model;
+  m_packetInterval = packetInterval;
+}
+
+bool
+VideoStreamPopulationHelper::NextArrival (uint32_t index, Time offset, Time &arrival)
+{
+  switch (m_arrivalProcess)
+  {
+    case STAGGERED:
+      arrival = m_spacing * static_cast<int64_t> (index);
+      return true;
+    case POISSON:
+      arrival = offset + Seconds (m_interArrival->GetValue ());
+      return true;
+    case TRACE:
+      if (index >= m_arrivalTrace.size ())
+      {
+        return false;
+      }
+      arrival = m_arrivalTrace[index];
+      return true;
+    default:
+      arrival = Seconds (0);
+      return true;
+  }
+}
+
+ApplicationContainer
+VideoStreamPopulationHelper::Install (NodeContainer c, uint32_t clients, Time start, Time stop)
+{
+  NS_ABORT_MSG_IF (c.GetN () == 0, "No node to install the clients on");
+
+  ApplicationContainer apps;
+  Time offset = Seconds (0);
+  for (uint32_t i = 0; i < clients; i++)
+  {
+    if (!NextArrival (i, offset, offset))
+    {
+      NS_LOG_WARN ("The arrival trace only has " << i << " of the " << clients << " clients");
+      break;
+    }
+    Time arrival = start + offset;
+    if (arrival >= stop)
+    {
+      break;
+    }
+    Time end = stop;
+    if (m_sessionLength != 0)
+    {
+      end = std::min (stop, arrival + Seconds (m_sessionLength->GetValue ()));
+    }
+
+    if (m_fluidModel != 0 && i % m_packetInterval != 0)
+    {
+      m_fluidModel->AddFluidSession (c.Get (i % c.GetN ()), m_remote, arrival, end);
+      continue;
+    }
+    ApplicationContainer app = m_clientHelper.Install (c.Get (i % c.GetN ()));
+    app.Start (arrival);
+    app.Stop (end);
+    apps.Add (app);
+    if (m_fluidModel != 0)
+    {
+      m_fluidModel->AddPacketSession (DynamicCast<VideoStreamClient> (app.Get (0)), m_remote, arrival, end);
+    }
+  }
+  NS_LOG_INFO ("Installed " << apps.GetN () << " clients on " << c.GetN () << " nodes");
+  return apps;
+}
+
+int64_t
+VideoStreamPopulationHelper::AssignStreams (int64_t stream)
+{
+  m_interArrival->SetStream (stream);
+  return 1 + m_clientHelper.AssignStreams (stream + 1);
+}
+
+} // namespace ns3
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_POPULATION_HELPER_H
+#define VIDEO_STREAM_POPULATION_HELPER_H
+
+#include <stdint.h>
+#include "ns3/application-container.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "video-stream-helper.h"
+#include "ns3/video-stream-fluid-model.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @brief Install a population of video stream clients with an arrival process.
+ *
+ * Clients are spread round-robin over the given nodes, so a node can run
+ * many sessions; each one binds its own ephemeral port and the server tells
+ * them apart by address and port. Every client starts at its arrival time
+ * and stops after its session length or at the end of the population,
+ * whichever comes first. Clients that would arrive after the end are not
+ * installed.
+ *
+ * With a fluid model, only some clients are applications: the others are
+ * fluid sessions with the same arrival and end, sharing the links with them.
+ */
+class VideoStreamPopulationHelper
+{
+public:
+  /**
+   * @brief How the arrival times of the clients are generated.
+   */
+  enum ArrivalProcess
+  {
+    SIMULTANEOUS, //!< Every client arrives at the start
+    STAGGERED, //!< Clients arrive at a fixed spacing
+    POISSON, //!< Exponential inter-arrival times
+    TRACE //!< Arrival times read from a file
+  };
+
+  /**
+   * @brief Construct a new VideoStreamPopulationHelper object.
+   *
+   * @param ip the IP address of the remote server
+   * @param port the port number of the remote server
+   */
+  VideoStreamPopulationHelper (Address ip, uint16_t port);
+
+  /**
+   * @brief Record an attribute to be set in each client after it is created.
+   *
+   * @param name the name of the attribute to set
+   * @param value the value of the attribute to set
+   */
+  void SetClientAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * @brief Choose the title of each client with a Zipf popularity model.
+   *
+   * @param titles the number of titles in the catalog
+   * @param exponent the Zipf exponent
+   */
+  void SetContentPopularity (uint32_t titles, double exponent);
+
+  /**
+   * @brief Start every client at the same time (the default).
+   */
+  void SetSimultaneousArrivals (void);
+
+  /**
+   * @brief Start the clients one after the other.
+   *
+   * @param spacing the time between two arrivals
+   */
+  void SetStaggeredArrivals (Time spacing);
+
+  /**
+   * @brief Start the clients following a Poisson process.
+   *
+   * @param rate the mean number of arrivals per second
+   */
+  void SetPoissonArrivals (double rate);
+
+  /**
+   * @brief Start the clients at the times listed in a file.
+   *
+   * The file holds one arrival time in seconds per line, relative to the
+   * start of the population. Lines are used in order, so at most as many
+   * clients as lines are installed.
+   *
+   * @param fileName the name of the arrival trace
+   */
+  void SetArrivalTrace (std::string fileName);
+
+  /**
+   * @brief Set the distribution of the session lengths in seconds.
+   *
+   * Without a distribution, every session lasts until the end of the population.
+   *
+   * @param length the random variable drawing the session lengths
+   */
+  void SetSessionLength (Ptr<RandomVariableStream> length);
+
+  /**
+   * @brief Simulate most clients with a fluid model.
+   *
+   * Client i is a packet-level VideoStreamClient when i is a multiple of
+   * packetInterval, and a fluid session of the model otherwise.
+   *
+   * @param model the fluid model
+   * @param packetInterval one client in packetInterval runs at the packet level
+   */
+  void SetFluidModel (Ptr<VideoStreamFluidModel> model, uint32_t packetInterval);
+
+  /**
+   * @brief Install the clients.
+   *
+   * @param c the nodes running the clients, used round-robin
+   * @param clients the number of clients to install
+   * @param start the start of the population
+   * @param stop the end of the population
+   * @return ApplicationContainer with the installed packet-level clients in arrival order
+   */
+  ApplicationContainer Install (NodeContainer c, uint32_t clients, Time start, Time stop);
+
+  /**
+   * @brief Assign a fixed random variable stream number to the random
+   * variables used by this helper.
+   *
+   * The session length distribution is set by the user, who assigns its stream.
+   * The popularity model, if any, uses the stream after the arrival process.
+   *
+   * @param stream first stream index to use
+   * @return the number of stream indices assigned by this helper
+   */
+  int64_t AssignStreams (int64_t stream);
+
+private:
+  /**
+   * @brief Draw the time between the start and the next arrival.
+   *
+   * @param index the index of the client
+   * @param offset the offset of the previous arrival
+   * @param arrival the offset of the arrival
+   * @return false if there are no more arrivals
+   */
+  bool NextArrival (uint32_t index, Time offset, Time &arrival);
+
+  VideoStreamClientHelper m_clientHelper; //!< Helper creating each client
+  Address m_remote; //!< Address of the server
+  ArrivalProcess m_arrivalProcess; //!< Arrival process
+  Time m_spacing; //!< Spacing of staggered arrivals
+  Ptr<ExponentialRandomVariable> m_interArrival; //!< Poisson inter-arrival times
+  std::vector<Time> m_arrivalTrace; //!< Arrival offsets read from a trace
+  Ptr<RandomVariableStream> m_sessionLength; //!< Session lengths, null for sessions lasting until the end
+  Ptr<VideoStreamFluidModel> m_fluidModel; //!< Fluid model of most clients, null for packet-level clients only
+  uint32_t m_packetInterval; //!< One client in m_packetInterval runs at the packet level
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_POPULATION_HELPER_H */
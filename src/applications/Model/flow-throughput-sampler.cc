@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/callback.h"
+#include "ns3/packet.h"
+#include "ns3/application.h"
+#include "flow-throughput-sampler.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FlowThroughputSampler");
+
+NS_OBJECT_ENSURE_REGISTERED (FlowThroughputSampler);
+
+TypeId
+FlowThroughputSampler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FlowThroughputSampler")
+    .SetParent<Object> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<FlowThroughputSampler> ()
+    .AddAttribute ("Window", "The length of a sampling window",
+                    TimeValue (Seconds (1.0)),
+                    MakeTimeAccessor (&FlowThroughputSampler::m_window),
+                    MakeTimeChecker ())
+    .AddAttribute ("BufferSize", "The number of samples buffered before they are written to the file",
+                    UintegerValue (4096),
+                    MakeUintegerAccessor (&FlowThroughputSampler::m_bufferSize),
+                    MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("OutputFile", "The CSV file the samples are written to",
+                    StringValue ("throughput-samples.csv"),
+                    MakeStringAccessor (&FlowThroughputSampler::m_outputFile),
+                    MakeStringChecker ())
+  ;
+  return tid;
+}
+
+FlowThroughputSampler::FlowThroughputSampler ()
+{
+  NS_LOG_FUNCTION (this);
+  m_head = 0;
+  m_count = 0;
+}
+
+FlowThroughputSampler::~FlowThroughputSampler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FlowThroughputSampler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+  m_monitor = 0;
+  Object::DoDispose ();
+}
+
+void
+FlowThroughputSampler::SetMonitor (Ptr<FlowMonitor> monitor)
+{
+  NS_LOG_FUNCTION (this << monitor);
+  m_monitor = monitor;
+}
+
+uint32_t
+FlowThroughputSampler::AddSession (Ptr<Application> client)
+{
+  NS_LOG_FUNCTION (this << client);
+  // deque elements keep their address when new sessions are appended
+  m_sessionBytes.push_back (0);
+  bool connected = client->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&FlowThroughputSampler::SessionRx, &m_sessionBytes.back ()));
+  NS_ASSERT_MSG (connected, "The application does not provide an Rx trace source");
+  return m_sessionBytes.size () - 1;
+}
+
+void
+FlowThroughputSampler::Start (Time start)
+{
+  NS_LOG_FUNCTION (this << start);
+
+  m_buffer.assign (m_bufferSize, Sample ());
+  m_head = 0;
+  m_count = 0;
+  if (!m_stream.is_open ())
+  {
+    m_stream.open (m_outputFile, std::ios::out);
+    if (!m_stream.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open " << m_outputFile);
+    }
+    m_stream << "Time(s),Kind,Id,Bytes,Throughput(Mbps)\n";
+  }
+
+  Time delay = start > Simulator::Now () ? start - Simulator::Now () : Seconds (0);
+  Simulator::Cancel (m_sampleEvent);
+  m_sampleEvent = Simulator::Schedule (delay + m_window, &FlowThroughputSampler::CloseWindow, this);
+}
+
+void
+FlowThroughputSampler::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_sampleEvent);
+  if (m_stream.is_open ())
+  {
+    Flush ();
+    m_stream.close ();
+  }
+}
+
+void
+FlowThroughputSampler::SessionRx (uint64_t *counter, Ptr<const Packet> packet, const Address &from)
+{
+  *counter += packet->GetSize ();
+}
+
+void
+FlowThroughputSampler::CloseWindow (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_monitor != 0)
+  {
+    const FlowMonitor::FlowStatsContainer &stats = m_monitor->GetFlowStats ();
+    for (auto &flow : stats)
+    {
+      if (flow.first >= m_lastFlowBytes.size ())
+      {
+        m_lastFlowBytes.resize (flow.first + 1, 0);
+      }
+      uint64_t bytes = flow.second.rxBytes - m_lastFlowBytes[flow.first];
+      m_lastFlowBytes[flow.first] = flow.second.rxBytes;
+      if (bytes > 0)
+      {
+        Push (FLOW, flow.first, bytes);
+      }
+    }
+  }
+
+  uint32_t index = 0;
+  for (auto &bytes : m_sessionBytes)
+  {
+    if (bytes > 0)
+    {
+      Push (SESSION, index, bytes);
+      bytes = 0;
+    }
+    index++;
+  }
+
+  m_sampleEvent = Simulator::Schedule (m_window, &FlowThroughputSampler::CloseWindow, this);
+}
+
+void
+FlowThroughputSampler::Push (uint8_t kind, uint32_t id, uint64_t bytes)
+{
+  if (m_count == m_buffer.size ())
+  {
+    Flush ();
+  }
+  Sample &sample = m_buffer[(m_head + m_count) % m_buffer.size ()];
+  sample.m_time = Simulator::Now ().GetNanoSeconds ();
+  sample.m_kind = kind;
+  sample.m_id = id;
+  sample.m_bytes = bytes;
+  m_count++;
+}
+
+void
+FlowThroughputSampler::Flush (void)
+{
+  NS_LOG_FUNCTION (this << m_count);
+
+  double window = m_window.GetSeconds ();
+  while (m_count > 0)
+  {
+    const Sample &sample = m_buffer[m_head];
+    m_stream << sample.m_time / 1e9 << ","
+             << (sample.m_kind == FLOW ? "flow" : "session") << ","
+             << sample.m_id << ","
+             << sample.m_bytes << ","
+             << sample.m_bytes * 8.0 / window / 1e6 << "\n";
+    m_head = (m_head + 1) % m_buffer.size ();
+    m_count--;
+  }
+  m_stream.flush ();
+}
+
+} // namespace ns3
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef FLOW_THROUGHPUT_SAMPLER_H
+#define FLOW_THROUGHPUT_SAMPLER_H
+
+#include "ns3/object.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/flow-monitor.h"
+
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class Application;
+class Packet;
+
+/**
+ * @brief Periodically sample the throughput of flows and video sessions.
+ *
+ * Every window, the number of bytes received by each FlowMonitor flow and
+ * by each registered session since the previous window is stored in a
+ * preallocated ring buffer. The buffer is flushed to a CSV file whenever
+ * it becomes full, so the memory footprint does not grow with the length
+ * of the simulation. Windows in which a flow or session received nothing
+ * are not written.
+ */
+class FlowThroughputSampler : public Object
+{
+public:
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FlowThroughputSampler ();
+
+  virtual ~FlowThroughputSampler ();
+
+  /**
+   * @brief Kind of sampled entity.
+   */
+  enum SampleKind
+  {
+    FLOW = 0,   //!< FlowMonitor flow
+    SESSION = 1 //!< Video stream client session
+  };
+
+  /**
+   * @brief Set the flow monitor whose flows are sampled.
+   *
+   * @param monitor the flow monitor
+   */
+  void SetMonitor (Ptr<FlowMonitor> monitor);
+
+  /**
+   * @brief Sample the bytes received by a video stream client.
+   *
+   * The application must provide an "Rx" trace source.
+   *
+   * @param client the client application
+   * @return the session index used in the output
+   */
+  uint32_t AddSession (Ptr<Application> client);
+
+  /**
+   * @brief Start sampling.
+   *
+   * @param start the time of the beginning of the first window
+   */
+  void Start (Time start);
+
+  /**
+   * @brief Stop sampling and flush the buffered samples.
+   */
+  void Stop (void);
+
+  /**
+   * @brief Write the buffered samples to the output file.
+   */
+  void Flush (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * @brief One sample of the ring buffer.
+   */
+  typedef struct Sample
+  {
+    int64_t m_time; //!< End of the window in nanoseconds
+    uint32_t m_id; //!< Flow ID or session index
+    uint8_t m_kind; //!< SampleKind
+    uint64_t m_bytes; //!< Bytes received during the window
+  } Sample;
+
+  /**
+   * @brief Count the bytes of a packet received by a session.
+   *
+   * @param counter the byte counter of the session
+   * @param packet the received packet
+   * @param from the sender address
+   */
+  static void SessionRx (uint64_t *counter, Ptr<const Packet> packet, const Address &from);
+
+  /**
+   * @brief Close the current window and schedule the next one.
+   */
+  void CloseWindow (void);
+
+  /**
+   * @brief Append a sample to the ring buffer, flushing it when full.
+   *
+   * @param kind the kind of sampled entity
+   * @param id the flow ID or session index
+   * @param bytes the bytes received during the window
+   */
+  void Push (uint8_t kind, uint32_t id, uint64_t bytes);
+
+  Time m_window; //!< Sampling window
+  uint32_t m_bufferSize; //!< Number of samples held before flushing
+  std::string m_outputFile; //!< Name of the output file
+
+  Ptr<FlowMonitor> m_monitor; //!< Sampled flow monitor
+  std::vector<uint64_t> m_lastFlowBytes; //!< Flow bytes at the end of the previous window, indexed by flow ID
+  std::deque<uint64_t> m_sessionBytes; //!< Bytes received by each session during the current window
+
+  std::vector<Sample> m_buffer; //!< Ring buffer of samples
+  uint32_t m_head; //!< Index of the oldest buffered sample
+  uint32_t m_count; //!< Number of buffered samples
+  std::ofstream m_stream; //!< Output stream
+  EventId m_sampleEvent; //!< Event closing the current window
+};
+
+} // namespace ns3
+
+#endif /* FLOW_THROUGHPUT_SAMPLER_H */
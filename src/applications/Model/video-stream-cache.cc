@@ -0,0 +1,226 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "video-stream-cache.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamCache");
+
+VideoStreamCache::VideoStreamCache (uint64_t capacity, Policy policy)
+{
+  Reset (capacity, policy);
+}
+
+void
+VideoStreamCache::Reset (uint64_t capacity, Policy policy)
+{
+  NS_LOG_FUNCTION (this << capacity << policy);
+  m_capacity = capacity;
+  m_policy = policy;
+  m_entries.clear ();
+  for (uint32_t i = 0; i < LIST_COUNT; i++)
+  {
+    m_lists[i].clear ();
+    m_listBytes[i] = 0;
+  }
+  m_lfuOrder.clear ();
+  m_target = 0;
+  m_tick = 0;
+  m_usedBytes = 0;
+  m_hits = 0;
+  m_misses = 0;
+  m_hitBytes = 0;
+  m_evictions = 0;
+}
+
+bool
+VideoStreamCache::Lookup (uint64_t key, uint32_t &size)
+{
+  auto iter = m_entries.find (key);
+  if (iter == m_entries.end () || iter->second.m_list >= RECENT_GHOST)
+  {
+    m_misses++;
+    return false;
+  }
+  Touch (key, iter->second);
+  size = iter->second.m_size;
+  m_hits++;
+  m_hitBytes += size;
+  return true;
+}
+
+bool
+VideoStreamCache::Peek (uint64_t key, uint32_t &size) const
+{
+  auto iter = m_entries.find (key);
+  if (iter == m_entries.end () || iter->second.m_list >= RECENT_GHOST)
+  {
+    return false;
+  }
+  size = iter->second.m_size;
+  return true;
+}
+
+void
+VideoStreamCache::Insert (uint64_t key, uint32_t size)
+{
+  if (size > m_capacity)
+  {
+    return;
+  }
+
+  uint8_t list = RECENT;
+  bool frequentGhost = false;
+  auto iter = m_entries.find (key);
+  if (iter != m_entries.end ())
+  {
+    if (iter->second.m_list < RECENT_GHOST)
+    {
+      Touch (key, iter->second);
+      return;
+    }
+    // ARC ghost hit: move the target towards the list that would have kept the frame
+    double recentGhost = m_listBytes[RECENT_GHOST];
+    double frequentGhostBytes = m_listBytes[FREQUENT_GHOST];
+    if (iter->second.m_list == RECENT_GHOST)
+    {
+      uint64_t delta = std::max (1.0, frequentGhostBytes / recentGhost) * size;
+      m_target = std::min (m_capacity, m_target + delta);
+    }
+    else
+    {
+      uint64_t delta = std::max (1.0, recentGhost / frequentGhostBytes) * size;
+      m_target = m_target > delta ? m_target - delta : 0;
+      frequentGhost = true;
+    }
+    Erase (key);
+    list = FREQUENT;
+  }
+
+  MakeRoom (size, frequentGhost);
+
+  Entry &entry = m_entries[key];
+  entry.m_size = size;
+  entry.m_frequency = 1;
+  entry.m_tick = ++m_tick;
+  entry.m_list = list;
+  entry.m_position = m_lists[list].insert (m_lists[list].end (), key);
+  m_listBytes[list] += size;
+  m_usedBytes += size;
+  if (m_policy == LFU)
+  {
+    m_lfuOrder.insert (std::make_tuple (entry.m_frequency, entry.m_tick, key));
+  }
+  if (m_policy == ARC)
+  {
+    TrimGhosts ();
+  }
+}
+
+double
+VideoStreamCache::GetHitRatio (void) const
+{
+  uint64_t lookups = m_hits + m_misses;
+  return lookups > 0 ? static_cast<double> (m_hits) / lookups : 0.0;
+}
+
+void
+VideoStreamCache::Touch (uint64_t key, Entry &entry)
+{
+  switch (m_policy)
+  {
+    case LFU:
+      m_lfuOrder.erase (std::make_tuple (entry.m_frequency, entry.m_tick, key));
+      entry.m_frequency++;
+      entry.m_tick = ++m_tick;
+      m_lfuOrder.insert (std::make_tuple (entry.m_frequency, entry.m_tick, key));
+      break;
+    case ARC:
+      MoveTo (key, entry, FREQUENT);
+      break;
+    default:
+      MoveTo (key, entry, RECENT);
+      break;
+  }
+}
+
+void
+VideoStreamCache::MoveTo (uint64_t key, Entry &entry, uint8_t list)
+{
+  m_lists[list].splice (m_lists[list].end (), m_lists[entry.m_list], entry.m_position);
+  m_listBytes[entry.m_list] -= entry.m_size;
+  m_listBytes[list] += entry.m_size;
+  entry.m_list = list;
+}
+
+void
+VideoStreamCache::Erase (uint64_t key)
+{
+  auto iter = m_entries.find (key);
+  Entry &entry = iter->second;
+  m_lists[entry.m_list].erase (entry.m_position);
+  m_listBytes[entry.m_list] -= entry.m_size;
+  if (entry.m_list < RECENT_GHOST)
+  {
+    m_usedBytes -= entry.m_size;
+    if (m_policy == LFU)
+    {
+      m_lfuOrder.erase (std::make_tuple (entry.m_frequency, entry.m_tick, key));
+    }
+  }
+  m_entries.erase (iter);
+}
+
+void
+VideoStreamCache::MakeRoom (uint32_t size, bool frequentGhost)
+{
+  while (m_usedBytes > 0 && m_usedBytes + size > m_capacity)
+  {
+    EvictOne (frequentGhost);
+  }
+}
+
+void
+VideoStreamCache::EvictOne (bool frequentGhost)
+{
+  m_evictions++;
+  if (m_policy == LFU)
+  {
+    Erase (std::get<2> (*m_lfuOrder.begin ()));
+    return;
+  }
+  if (m_policy == LRU)
+  {
+    Erase (m_lists[RECENT].front ());
+    return;
+  }
+
+  bool fromRecent = !m_lists[RECENT].empty () &&
+    (m_lists[FREQUENT].empty () || m_listBytes[RECENT] > m_target ||
+     (frequentGhost && m_listBytes[RECENT] == m_target));
+  uint8_t list = fromRecent ? RECENT : FREQUENT;
+  uint64_t key = m_lists[list].front ();
+  Entry &entry = m_entries[key];
+  m_usedBytes -= entry.m_size;
+  MoveTo (key, entry, fromRecent ? RECENT_GHOST : FREQUENT_GHOST);
+}
+
+void
+VideoStreamCache::TrimGhosts (void)
+{
+  while (m_listBytes[RECENT] + m_listBytes[RECENT_GHOST] > m_capacity && !m_lists[RECENT_GHOST].empty ())
+  {
+    Erase (m_lists[RECENT_GHOST].front ());
+  }
+  uint64_t total = m_listBytes[RECENT] + m_listBytes[FREQUENT] + m_listBytes[RECENT_GHOST] + m_listBytes[FREQUENT_GHOST];
+  while (total > 2 * m_capacity && !m_lists[FREQUENT_GHOST].empty ())
+  {
+    total -= m_entries[m_lists[FREQUENT_GHOST].front ()].m_size;
+    Erase (m_lists[FREQUENT_GHOST].front ());
+  }
+}
+
+} // namespace ns3
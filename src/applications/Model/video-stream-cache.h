@@ -0,0 +1,202 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_CACHE_H
+#define VIDEO_STREAM_CACHE_H
+
+#include <stdint.h>
+#include <list>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * @brief Frame cache with a byte budget.
+ *
+ * Entries are identified by a key built with GetKey and hold the size of a
+ * frame. When an insertion exceeds the budget, entries are evicted by the
+ * replacement policy: least recently used (LRU), least frequently used with
+ * LRU among equal counts (LFU), or the adaptive replacement cache (ARC),
+ * which balances recency and frequency using the history of recently
+ * evicted keys. ARC is adapted to entries of different sizes by measuring
+ * its lists and its target in bytes.
+ */
+class VideoStreamCache
+{
+public:
+  static const uint16_t MAX_VIDEO_LEVEL = 255; //!< Highest video level a key holds
+
+  /**
+   * @brief Replacement policy.
+   */
+  enum Policy
+  {
+    LRU = 0, //!< Least recently used
+    LFU = 1, //!< Least frequently used
+    ARC = 2 //!< Adaptive replacement cache
+  };
+
+  /**
+   * @brief Construct a new VideoStreamCache object.
+   *
+   * @param capacity the byte budget
+   * @param policy the replacement policy
+   */
+  VideoStreamCache (uint64_t capacity = 0, Policy policy = LRU);
+
+  /**
+   * @brief Empty the cache and change its budget and policy.
+   *
+   * @param capacity the byte budget
+   * @param policy the replacement policy
+   */
+  void Reset (uint64_t capacity, Policy policy);
+
+  /**
+   * @brief Build the key of a frame.
+   *
+   * @param contentId the content ID of the title, below 2^24
+   * @param videoLevel the video level, at most MAX_VIDEO_LEVEL
+   * @param frame the frame number
+   * @return the key
+   */
+  static uint64_t GetKey (uint32_t contentId, uint16_t videoLevel, uint32_t frame)
+  {
+    return (static_cast<uint64_t> (contentId & 0xffffff) << 40) | (static_cast<uint64_t> (videoLevel & MAX_VIDEO_LEVEL) << 32) | frame;
+  }
+
+  /**
+   * @brief Look up a frame, counting a hit or a miss.
+   *
+   * @param key the key of the frame
+   * @param size the size of the frame, set on a hit
+   * @return true on a hit
+   */
+  bool Lookup (uint64_t key, uint32_t &size);
+
+  /**
+   * @brief Whether a frame is cached, without counting a hit or a miss or
+   * updating the replacement order.
+   *
+   * @param key the key of the frame
+   * @param size the size of the frame, set if cached
+   * @return true if cached
+   */
+  bool Peek (uint64_t key, uint32_t &size) const;
+
+  /**
+   * @brief Insert a frame, evicting others as needed.
+   *
+   * Frames larger than the budget are not cached.
+   *
+   * @param key the key of the frame
+   * @param size the size of the frame in bytes
+   */
+  void Insert (uint64_t key, uint32_t size);
+
+  uint64_t GetCapacity (void) const { return m_capacity; } //!< @return the byte budget
+  uint64_t GetUsedBytes (void) const { return m_usedBytes; } //!< @return the bytes of the cached frames
+  uint64_t GetHits (void) const { return m_hits; } //!< @return the number of hits
+  uint64_t GetMisses (void) const { return m_misses; } //!< @return the number of misses
+  uint64_t GetHitBytes (void) const { return m_hitBytes; } //!< @return the bytes of the hits
+  uint64_t GetEvictions (void) const { return m_evictions; } //!< @return the number of evicted frames
+
+  /**
+   * @brief Get the hit ratio.
+   *
+   * @return the ratio of the lookups that were hits, 0 without lookups
+   */
+  double GetHitRatio (void) const;
+
+private:
+  /**
+   * @brief List an entry belongs to.
+   *
+   * LRU and LFU only use RECENT. ARC keeps the entries seen once in RECENT,
+   * those seen again in FREQUENT and the keys of evicted entries in the
+   * matching ghost list.
+   */
+  enum ListId
+  {
+    RECENT = 0, //!< Resident, T1 in ARC
+    FREQUENT = 1, //!< Resident, T2 in ARC
+    RECENT_GHOST = 2, //!< Evicted from RECENT, B1 in ARC
+    FREQUENT_GHOST = 3, //!< Evicted from FREQUENT, B2 in ARC
+    LIST_COUNT //!< Number of lists
+  };
+
+  /**
+   * @brief Cache entry.
+   */
+  typedef struct Entry
+  {
+    uint32_t m_size; //!< Size of the frame in bytes
+    uint32_t m_frequency; //!< Number of accesses (LFU)
+    uint64_t m_tick; //!< Time of the last access (LFU)
+    uint8_t m_list; //!< ListId
+    std::list<uint64_t>::iterator m_position; //!< Position in its list
+  } Entry;
+
+  /**
+   * @brief Record an access to a resident entry.
+   *
+   * @param key the key of the entry
+   * @param entry the entry
+   */
+  void Touch (uint64_t key, Entry &entry);
+
+  /**
+   * @brief Move an entry to the most recently used end of a list.
+   *
+   * @param key the key of the entry
+   * @param entry the entry
+   * @param list the destination list
+   */
+  void MoveTo (uint64_t key, Entry &entry, uint8_t list);
+
+  /**
+   * @brief Remove an entry.
+   *
+   * @param key the key of the entry
+   */
+  void Erase (uint64_t key);
+
+  /**
+   * @brief Evict entries until a frame fits in the budget.
+   *
+   * @param size the size of the frame to insert
+   * @param frequentGhost whether the frame was found in the FREQUENT ghost list (ARC)
+   */
+  void MakeRoom (uint32_t size, bool frequentGhost);
+
+  /**
+   * @brief Evict one resident entry.
+   *
+   * @param frequentGhost whether the frame to insert was found in the FREQUENT ghost list (ARC)
+   */
+  void EvictOne (bool frequentGhost);
+
+  /**
+   * @brief Drop the oldest ghost keys beyond the ARC history budget.
+   */
+  void TrimGhosts (void);
+
+  uint64_t m_capacity; //!< Byte budget
+  Policy m_policy; //!< Replacement policy
+  std::unordered_map<uint64_t, Entry> m_entries; //!< Resident and ghost entries
+  std::list<uint64_t> m_lists[LIST_COUNT]; //!< Keys of each list, least recently used first
+  uint64_t m_listBytes[LIST_COUNT]; //!< Bytes of each list
+  std::set<std::tuple<uint32_t, uint64_t, uint64_t>> m_lfuOrder; //!< Frequency, last access and key of each entry (LFU)
+  uint64_t m_target; //!< Target size of RECENT in bytes (ARC)
+  uint64_t m_tick; //!< Access counter (LFU)
+  uint64_t m_usedBytes; //!< Bytes of the resident entries
+  uint64_t m_hits; //!< Number of hits
+  uint64_t m_misses; //!< Number of misses
+  uint64_t m_hitBytes; //!< Bytes of the hits
+  uint64_t m_evictions; //!< Number of evicted entries
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_CACHE_H */
@@ -11,15 +11,36 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/string.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
 #include "video-stream-client.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("VideoStreamClientApplication");
 
 NS_OBJECT_ENSURE_REGISTERED (VideoStreamClient);
 
+// Link hints
+static const double LINK_UPGRADE_MARGIN = 1.2; //!< Link rate over the bitrate of the next level needed to upgrade
+static const double LINK_FADING_SHARE = 0.9; //!< Throughput over the bitrate of the level below which a fading link is left
+static const double LINK_SNR_DROP = 1.0; //!< SNR drop in dB between two checks that shows a fading link
+
 TypeId
 VideoStreamClient::GetTypeId (void)
 {
@@ -27,7 +48,7 @@ VideoStreamClient::GetTypeId (void)
     .SetParent<Application> ()
     .SetGroupName ("Applications")
     .AddConstructor<VideoStreamClient> ()
-    .AddAttribute ("RemoteAddress", "The destination address of the outbound packets",
+    .AddAttribute ("RemoteAddress", "The address of the server, or of a request router redirecting the session to a server",
                     AddressValue (),
                     MakeAddressAccessor (&VideoStreamClient::m_peerAddress),
                     MakeAddressChecker ())
@@ -35,12 +56,127 @@ VideoStreamClient::GetTypeId (void)
                     UintegerValue (6969),
                     MakeUintegerAccessor (&VideoStreamClient::m_peerPort),
                     MakeUintegerChecker<uint16_t> ())
-    
+    .AddAttribute ("InitialVideoLevel", "The video level the client starts with and requests from the server",
+                    UintegerValue (3),
+                    MakeUintegerAccessor (&VideoStreamClient::m_videoLevel),
+                    MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("MaxVideoLevel", "The highest video level the client plays, announced to the server in the HELLO; "
+                   "0 for the highest level of the ladder of the server",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamClient::m_maxVideoLevel),
+                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("MaxHeight", "The height in lines of the tallest rendition the client displays, announced to the server "
+                   "in the HELLO, which offers no level above it; 0 for any",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamClient::m_maxHeight),
+                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("BufferCapacity", "The number of frames the client buffers, announced to the server in the HELLO, 0 if unbounded",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamClient::m_bufferCapacity),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("StartFrame", "The frame of the title the playback starts from",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamClient::m_startFrame),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("HelloTimeout", "The time before an unanswered HELLO or SEEK is repeated, doubled at each retry, 0 to never repeat them",
+                    TimeValue (MilliSeconds (200)),
+                    MakeTimeAccessor (&VideoStreamClient::m_helloTimeout),
+                    MakeTimeChecker ())
+    .AddAttribute ("MaxHelloRetries", "The number of times an unanswered HELLO or SEEK is repeated before the client gives up",
+                    UintegerValue (5),
+                    MakeUintegerAccessor (&VideoStreamClient::m_maxHelloRetries),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FailoverServers", "The servers the session fails over to, in order, as ADDRESS[:PORT] separated by semicolons; "
+                   "the port defaults to 6969",
+                    StringValue (""),
+                    MakeStringAccessor (&VideoStreamClient::SetFailoverServers, &VideoStreamClient::GetFailoverServers),
+                    MakeStringChecker ())
+    .AddAttribute ("FailoverTimeout", "The time without packets in an established session, or the last unanswered HELLO, "
+                   "after which the session moves to the next failover server and resumes after the last complete frame; "
+                   "0 to never fail over",
+                    TimeValue (MilliSeconds (500)),
+                    MakeTimeAccessor (&VideoStreamClient::m_failoverTimeout),
+                    MakeTimeChecker ())
+    .AddAttribute ("Multipath", "Whether the session opens a subflow on every other IPv4 interface with a route to the server, "
+                   "over which the server spreads the fragments by the rate and the delay of each path; "
+                   "the paths are measured with the receiver reports, so ReportInterval must not be 0",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&VideoStreamClient::m_multipath),
+                    MakeBooleanChecker ())
+    .AddAttribute ("StartThreshold", "The number of buffered frames that starts the playback before the initial delay of 3 seconds, "
+                   "at least one second of frames; 0 to always wait for the initial delay",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamClient::m_startThreshold),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Adaptive", "Whether the client adapts the video level to the buffer",
+                    BooleanValue (true),
+                    MakeBooleanAccessor (&VideoStreamClient::m_adaptive),
+                    MakeBooleanChecker ())
+    .AddAttribute ("LinkMonitor", "The monitor of the link of the node the client reads its link hints from, lowering the video level "
+                   "before the buffer runs dry when the PHY rate and the retry rate show the link can no longer carry it, "
+                   "or when the throughput falls behind the level as the SNR drops, and holding the upgrades the link could not carry; "
+                   "none to adapt to the buffer only",
+                    PointerValue (),
+                    MakePointerAccessor (&VideoStreamClient::m_linkMonitor),
+                    MakePointerChecker<VideoStreamLinkMonitor> ())
+    .AddAttribute ("LinkHintInterval", "The time between two checks of the link hints",
+                    TimeValue (MilliSeconds (500)),
+                    MakeTimeAccessor (&VideoStreamClient::m_linkHintInterval),
+                    MakeTimeChecker (MilliSeconds (1)))
+    .AddAttribute ("LinkEfficiency", "The share of the PHY rate of the link left to the stream after the MAC overhead "
+                   "and the other stations, before the retransmissions",
+                    DoubleValue (0.5),
+                    MakeDoubleAccessor (&VideoStreamClient::m_linkEfficiency),
+                    MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("ContentId", "The ID of the title requested from the server's catalog",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamClient::m_contentId),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("TargetLatency", "The largest latency to live of a live stream; frames that would be played later are skipped",
+                    TimeValue (MilliSeconds (500)),
+                    MakeTimeAccessor (&VideoStreamClient::m_targetLatency),
+                    MakeTimeChecker ())
+    .AddAttribute ("ReportInterval", "The time between two receiver reports to the server, 0 to disable them",
+                    TimeValue (Seconds (0.0)),
+                    MakeTimeAccessor (&VideoStreamClient::m_reportInterval),
+                    MakeTimeChecker ())
+    .AddAttribute ("PacketWindowSize", "The size of the window used to detect lost packets. This value should be a multiple of 8.",
+                    UintegerValue (32),
+                    MakeUintegerAccessor (&VideoStreamClient::SetPacketWindowSize, &VideoStreamClient::GetPacketWindowSize),
+                    MakeUintegerChecker<uint16_t> (8, 256))
+    .AddAttribute ("EventLogFile", "The binary file the events are recorded to, empty to disable the event log",
+                    StringValue (""),
+                    MakeStringAccessor (&VideoStreamClient::m_eventLogFile),
+                    MakeStringChecker ())
+    .AddAttribute ("EventLogBufferSize", "The number of events buffered before they are written to the event log",
+                    UintegerValue (1024),
+                    MakeUintegerAccessor (&VideoStreamClient::m_eventLogBufferSize),
+                    MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Rx", "A packet has been received",
+                     MakeTraceSourceAccessor (&VideoStreamClient::m_rxTrace),
+                     "ns3::Packet::AddressTracedCallback")
+    .AddTraceSource ("LatencyToLive", "A live frame has been played",
+                     MakeTraceSourceAccessor (&VideoStreamClient::m_latencyTrace),
+                     "ns3::VideoStreamClient::LatencyTracedCallback")
+    .AddTraceSource ("LostPackets", "The number of lost packets",
+                     MakeTraceSourceAccessor (&VideoStreamClient::m_lostPackets),
+                     "ns3::TracedValueCallback::Uint32")
+    .AddTraceSource ("ReorderDepth", "A packet arrived after a later one, "
+                     "the value is its distance to the highest sequence number received",
+                     MakeTraceSourceAccessor (&VideoStreamClient::m_reorderTrace),
+                     "ns3::VideoStreamClient::ReorderTracedCallback")
+    .AddTraceSource ("OneWayDelay", "A packet has been received, the value is its one-way delay",
+                     MakeTraceSourceAccessor (&VideoStreamClient::m_delayTrace),
+                     "ns3::VideoStreamClient::LatencyTracedCallback")
+    .AddTraceSource ("LinkState", "The link hints were checked",
+                     MakeTraceSourceAccessor (&VideoStreamClient::m_linkStateTrace),
+                     "ns3::VideoStreamClient::LinkStateTracedCallback")
   ;
   return tid;
 }
 
 VideoStreamClient::VideoStreamClient ()
+  : m_lossCounter (0)
 {
   NS_LOG_FUNCTION (this);
   m_initialDelay = 3;
@@ -48,10 +184,62 @@ VideoStreamClient::VideoStreamClient ()
   m_currentBufferSize = 0;
   m_frameSize = 0;
   m_frameRate = 25;
-  m_videoLevel = 3;
   m_stopCounter = 0;
   m_lastRecvFrame = 1e6;
   m_rebufferCounter = 0;
+  m_receivedFrames = 0;
+  m_stallCount = 0;
+  m_rejected = false;
+  m_redirected = false;
+  m_nextFailoverServer = 0;
+  m_resumeFrame = 0;
+  m_frameCompleted = false;
+  m_lastCompleteFrame = 0;
+  m_titleCompleted = false;
+  m_sequenceOffset = 0;
+  m_failovers = 0;
+  m_failoverPending = false;
+  m_multipath = false;
+  m_recentFrames = 0;
+  m_offeredLevel = std::numeric_limits<uint16_t>::max ();
+  m_helloAttempts = 0;
+  m_sessionAcked = false;
+  m_firstFrameReceived = false;
+  m_playbackStarted = false;
+  m_seekFrame = 0;
+  m_trickPlay = false;
+  m_seekPending = false;
+  m_seeking = false;
+  m_seekAttempts = 0;
+  m_seekCount = 0;
+  m_failedSeeks = 0;
+  m_receivedVideoLevel = 0;
+  m_reportBytes = 0;
+  m_reportPackets = 0;
+  m_sequenceStarted = false;
+  m_expectedSequence = 0;
+  m_highestSequence = 0;
+  std::fill (m_trendSums, m_trendSums + 5, 0.0);
+  m_firstSequence = 0;
+  m_lastSequence = 0;
+  m_deliveredPackets = 0;
+  m_lostPackets = 0;
+  m_reorderedPackets = 0;
+  m_maxReorderDepth = 0;
+  m_stalled = false;
+  m_live = false;
+  m_completeLiveFrames = 0;
+  m_playedFrames = 0;
+  m_lastPlayedFrame = 0;
+  m_onTimeFrames = 0;
+  m_lateFrames = 0;
+  m_skippedFrames = 0;
+  m_linkEfficiency = 0.5;
+  m_hintBytes = 0;
+  m_throughputEstimate = 0.0;
+  m_lastHintSnr = std::numeric_limits<double>::lowest ();
+  m_linkLimited = false;
+  m_linkSwitches = 0;
   m_bufferEvent = EventId();
   m_sendEvent = EventId();
 }
@@ -77,10 +265,330 @@ VideoStreamClient::SetRemote (Address addr)
   m_peerAddress = addr;
 }
 
+void
+VideoStreamClient::AddFailoverServer (Ipv4Address address, uint16_t port)
+{
+  NS_LOG_FUNCTION (this << address << port);
+  m_failoverServers.push_back (InetSocketAddress (address, port));
+}
+
+void
+VideoStreamClient::SetFailoverServers (std::string servers)
+{
+  NS_LOG_FUNCTION (this << servers);
+  m_failoverServers.clear ();
+  std::istringstream list (servers);
+  std::string server;
+  while (std::getline (list, server, ';'))
+  {
+    server.erase (0, server.find_first_not_of (" \t\r\n"));
+    server.erase (server.find_last_not_of (" \t\r\n") + 1);
+    if (server.empty ())
+    {
+      continue;
+    }
+    std::string::size_type colon = server.find (':');
+    unsigned long port = 6969;
+    if (colon != std::string::npos)
+    {
+      std::string digits = server.substr (colon + 1);
+      char *end;
+      port = std::strtoul (digits.c_str (), &end, 10);
+      if (digits.empty () || !std::isdigit (static_cast<unsigned char> (digits[0])) || *end != '\0' || port > 65535)
+      {
+        NS_FATAL_ERROR ("Malformed failover server \"" << server << "\", expected ADDRESS[:PORT]");
+      }
+    }
+    AddFailoverServer (Ipv4Address (server.substr (0, colon).c_str ()), port);
+  }
+}
+
+std::string
+VideoStreamClient::GetFailoverServers (void) const
+{
+  std::ostringstream os;
+  for (uint32_t i = 0; i < m_failoverServers.size (); i++)
+  {
+    os << (i > 0 ? ";" : "") << m_failoverServers[i].GetIpv4 () << ":" << m_failoverServers[i].GetPort ();
+  }
+  return os.str ();
+}
+
+uint32_t
+VideoStreamClient::GetReceivedFrames (void) const
+{
+  return m_receivedFrames;
+}
+
+uint32_t
+VideoStreamClient::GetStallCount (void) const
+{
+  return m_stallCount;
+}
+
+uint16_t
+VideoStreamClient::GetVideoLevel (void) const
+{
+  return m_videoLevel;
+}
+
+uint16_t
+VideoStreamClient::GetReceivedVideoLevel (void) const
+{
+  return m_receivedVideoLevel;
+}
+
+void
+VideoStreamClient::SetPacketWindowSize (uint16_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_lossCounter.SetBitMapSize (size);
+}
+
+uint16_t
+VideoStreamClient::GetPacketWindowSize (void) const
+{
+  return m_lossCounter.GetBitMapSize ();
+}
+
+uint32_t
+VideoStreamClient::GetLostPackets (void) const
+{
+  return m_lostPackets;
+}
+
+double
+VideoStreamClient::GetLossRate (void) const
+{
+  if (m_deliveredPackets == 0)
+  {
+    return 0.0;
+  }
+  uint32_t sent = m_lastSequence - m_firstSequence + 1;
+  return static_cast<double> (m_lostPackets) / sent;
+}
+
+uint32_t
+VideoStreamClient::GetReorderedPackets (void) const
+{
+  return m_reorderedPackets;
+}
+
+uint32_t
+VideoStreamClient::GetMaxReorderDepth (void) const
+{
+  return m_maxReorderDepth;
+}
+
+Time
+VideoStreamClient::GetOneWayDelay (void) const
+{
+  return m_oneWayDelay;
+}
+
+Time
+VideoStreamClient::GetMeanOneWayDelay (void) const
+{
+  if (m_deliveredPackets == 0)
+  {
+    return Seconds (0.0);
+  }
+  return m_delaySum / static_cast<int64_t> (m_deliveredPackets);
+}
+
+const VideoStreamHistogram &
+VideoStreamClient::GetFrameLatencyHistogram (void) const
+{
+  return m_frameLatency;
+}
+
+const VideoStreamHistogram &
+VideoStreamClient::GetFragmentGapHistogram (void) const
+{
+  return m_fragmentGap;
+}
+
+const VideoStreamHistogram &
+VideoStreamClient::GetStallHistogram (void) const
+{
+  return m_stallDuration;
+}
+
+Time
+VideoStreamClient::GetTimeToFirstFrame (void) const
+{
+  return m_timeToFirstFrame;
+}
+
+Time
+VideoStreamClient::GetStartupDelay (void) const
+{
+  return m_startupDelay;
+}
+
+uint32_t
+VideoStreamClient::GetSeekCount (void) const
+{
+  return m_seekCount;
+}
+
+uint32_t
+VideoStreamClient::GetFailedSeekCount (void) const
+{
+  return m_failedSeeks;
+}
+
+const VideoStreamHistogram &
+VideoStreamClient::GetSeekLatencyHistogram (void) const
+{
+  return m_seekLatency;
+}
+
+const VideoStreamLadder &
+VideoStreamClient::GetLadder (void) const
+{
+  return m_ladder;
+}
+
+uint32_t
+VideoStreamClient::GetContentId (void) const
+{
+  return m_contentId;
+}
+
+bool
+VideoStreamClient::IsRejected (void) const
+{
+  return m_rejected;
+}
+
+bool
+VideoStreamClient::IsRedirected (void) const
+{
+  return m_redirected;
+}
+
+uint32_t
+VideoStreamClient::GetHelloAttempts (void) const
+{
+  return m_helloAttempts;
+}
+
+Time
+VideoStreamClient::GetHandshakeTime (void) const
+{
+  return m_handshakeTime;
+}
+
+uint32_t
+VideoStreamClient::GetFailoverCount (void) const
+{
+  return m_failovers;
+}
+
+const VideoStreamHistogram &
+VideoStreamClient::GetFailoverGapHistogram (void) const
+{
+  return m_failoverGap;
+}
+
+Time
+VideoStreamClient::GetFailoverStallTime (void) const
+{
+  return m_failoverStallTime;
+}
+
+uint32_t
+VideoStreamClient::GetPathCount (void) const
+{
+  return m_paths.size ();
+}
+
+bool
+VideoStreamClient::IsPathJoined (uint32_t path) const
+{
+  return path == 0 || m_paths.at (path).m_joined;
+}
+
+uint64_t
+VideoStreamClient::GetPathReceivedBytes (uint32_t path) const
+{
+  return m_paths.at (path).m_receivedBytes;
+}
+
+double
+VideoStreamClient::GetPathShare (uint32_t path) const
+{
+  uint64_t bytes = 0;
+  for (const PathInfo &info : m_paths)
+  {
+    bytes += info.m_receivedBytes;
+  }
+  return bytes > 0 ? static_cast<double> (m_paths.at (path).m_receivedBytes) / bytes : 0.0;
+}
+
+DataRate
+VideoStreamClient::GetAggregateThroughput (void) const
+{
+  Time duration = m_lastPacketTime - m_firstPacketTime;
+  if (m_deliveredPackets == 0 || !duration.IsStrictlyPositive ())
+  {
+    return DataRate (0);
+  }
+  uint64_t bytes = 0;
+  for (const PathInfo &info : m_paths)
+  {
+    bytes += info.m_receivedBytes;
+  }
+  return DataRate (bytes * 8 / duration.GetSeconds ());
+}
+
+Time
+VideoStreamClient::GetLatencyToLive (void) const
+{
+  return m_latencyToLive;
+}
+
+Time
+VideoStreamClient::GetMeanLatencyToLive (void) const
+{
+  if (m_playedFrames == 0)
+  {
+    return Seconds (0.0);
+  }
+  return m_latencySum / static_cast<int64_t> (m_playedFrames);
+}
+
+uint32_t
+VideoStreamClient::GetLateFrames (void) const
+{
+  return m_lateFrames;
+}
+
+uint32_t
+VideoStreamClient::GetSkippedFrames (void) const
+{
+  return m_skippedFrames;
+}
+
+Ptr<VideoStreamLinkMonitor>
+VideoStreamClient::GetLinkMonitor (void) const
+{
+  return m_linkMonitor;
+}
+
+uint32_t
+VideoStreamClient::GetLinkSwitchCount (void) const
+{
+  return m_linkSwitches;
+}
+
 void
 VideoStreamClient::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_eventLog.Close ();
+  m_linkMonitor = 0;
   Application::DoDispose ();
 }
 
@@ -132,8 +640,23 @@ VideoStreamClient::StartApplication (void)
   }
 
   m_socket->SetRecvCallback (MakeCallback (&VideoStreamClient::HandleRead, this));
+  m_paths.assign (1, PathInfo ());
+  m_paths[0].m_socket = m_socket;
+  m_eventLog.Open (m_eventLogFile, m_eventLogBufferSize, GetNode ()->GetId ());
+  // the levels above MaxVideoLevel are known once the server sends its ladder
+  m_offeredLevel = m_maxVideoLevel > 0 ? m_maxVideoLevel : std::numeric_limits<uint16_t>::max ();
+  m_videoLevel = std::min (m_videoLevel, m_offeredLevel);
+  m_startTime = Simulator::Now ();
+  m_resumeFrame = m_startFrame;
   m_sendEvent = Simulator::Schedule (MilliSeconds (1.0), &VideoStreamClient::Send, this);
   m_bufferEvent = Simulator::Schedule (Seconds (m_initialDelay), &VideoStreamClient::ReadFromBuffer, this);
+  if (m_linkMonitor != 0)
+  {
+    m_hintBytes = 0;
+    m_throughputEstimate = 0.0;
+    m_lastHintSnr = std::numeric_limits<double>::lowest ();
+    m_linkEvent = Simulator::Schedule (m_linkHintInterval, &VideoStreamClient::CheckLinkHints, this);
+  }
 }
 
 void
@@ -143,12 +666,157 @@ VideoStreamClient::StopApplication ()
 
   if (m_socket != 0)
   {
+    if (!m_rejected)
+    {
+      // let the server end the session and admit another client
+      SendBye ();
+    }
     m_socket->Close ();
     m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket>> ());
     m_socket = 0;
   }
+  for (uint32_t index = 1; index < m_paths.size (); index++)
+  {
+    NS_LOG_INFO ("Path " << index << " from " << m_paths[index].m_local << " carried " << GetPathShare (index) * 100 << "% of the bytes");
+    m_paths[index].m_socket->Close ();
+    m_paths[index].m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket>> ());
+  }
+  if (m_paths.size () > 1)
+  {
+    NS_LOG_INFO ("Path 0 carried " << GetPathShare (0) * 100 << "% of the bytes, aggregate throughput " << GetAggregateThroughput ());
+  }
 
+  Simulator::Cancel (m_sendEvent);
+  Simulator::Cancel (m_seekEvent);
   Simulator::Cancel (m_bufferEvent);
+  Simulator::Cancel (m_reportEvent);
+  Simulator::Cancel (m_deliveryEvent);
+  Simulator::Cancel (m_joinEvent);
+  Simulator::Cancel (m_linkEvent);
+  if (m_stalled)
+  {
+    // a stall still in progress ends with the session
+    EndStall ();
+  }
+  m_eventLog.Close ();
+}
+
+Ptr<Ipv4Route>
+VideoStreamClient::GetServerRoute (Ptr<NetDevice> device) const
+{
+  Ptr<Ipv4> ipv4 = GetNode ()->GetObject<Ipv4> ();
+  if (!Ipv4Address::IsMatchingType (m_peerAddress) || ipv4 == 0 || ipv4->GetRoutingProtocol () == 0)
+  {
+    return 0;
+  }
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address::ConvertFrom (m_peerAddress));
+  Socket::SocketErrno error;
+  return ipv4->GetRoutingProtocol ()->RouteOutput (0, header, device, error);
+}
+
+uint16_t
+VideoStreamClient::GetLinkMtu (void) const
+{
+  Ptr<Ipv4Route> route = GetServerRoute (0);
+  if (route == 0 || route->GetOutputDevice () == 0)
+  {
+    return 0;
+  }
+  return route->GetOutputDevice ()->GetMtu ();
+}
+
+void
+VideoStreamClient::OpenSubflows (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<Ipv4Route> sessionRoute = GetServerRoute (0);
+  if (sessionRoute == 0)
+  {
+    NS_LOG_WARN ("Multipath needs an IPv4 server address with a route");
+    return;
+  }
+  Ptr<Ipv4> ipv4 = GetNode ()->GetObject<Ipv4> ();
+  for (uint32_t interface = 0; interface < ipv4->GetNInterfaces (); interface++)
+  {
+    Ptr<NetDevice> device = ipv4->GetNetDevice (interface);
+    if (device == sessionRoute->GetOutputDevice () || !ipv4->IsUp (interface) || ipv4->GetNAddresses (interface) == 0)
+    {
+      continue;
+    }
+    Ipv4Address local = ipv4->GetAddress (interface, 0).GetLocal ();
+    if (local.IsLocalhost () || GetServerRoute (device) == 0)
+    {
+      continue;
+    }
+    PathInfo path = PathInfo ();
+    path.m_socket = Socket::CreateSocket (GetNode (), TypeId::LookupByName ("ns3::UdpSocketFactory"));
+    if (path.m_socket->Bind (InetSocketAddress (local, 0)) == -1)
+    {
+      NS_FATAL_ERROR ("Failed to bind socket");
+    }
+    // the packets of the subflow leave from its interface whatever the route of the session
+    path.m_socket->BindToNetDevice (device);
+    path.m_socket->Connect (InetSocketAddress (Ipv4Address::ConvertFrom (m_peerAddress), m_peerPort));
+    path.m_socket->SetRecvCallback (MakeCallback (&VideoStreamClient::HandleRead, this));
+    path.m_local = local;
+    m_paths.push_back (path);
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client opened path " << m_paths.size () - 1 << " from " << local);
+  }
+}
+
+void
+VideoStreamClient::SendJoin (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // the server knows the session by the source address of its route and the port of its socket
+  Ptr<Ipv4Route> sessionRoute = GetServerRoute (0);
+  Address session;
+  if (sessionRoute == 0 || m_socket->GetSockName (session) == -1)
+  {
+    return;
+  }
+  bool pending = false;
+  for (uint32_t index = 1; index < m_paths.size (); index++)
+  {
+    PathInfo &path = m_paths[index];
+    if (path.m_joined || path.m_joinAttempts > m_maxHelloRetries)
+    {
+      continue;
+    }
+    VideoStreamHeader header;
+    header.SetMessageType (VideoStreamHeader::JOIN);
+    header.SetContentId (m_contentId);
+    VideoStreamJoinHeader join;
+    join.SetSessionAddress (sessionRoute->GetSource ());
+    join.SetSessionPort (InetSocketAddress::ConvertFrom (session).GetPort ());
+    join.SetPath (index);
+    Ptr<Packet> joinPacket = Create<Packet> ();
+    joinPacket->AddHeader (join);
+    joinPacket->AddHeader (header);
+    path.m_socket->Send (joinPacket);
+    path.m_joinAttempts++;
+    pending = true;
+  }
+  if (pending)
+  {
+    m_joinEvent = Simulator::Schedule (m_helloTimeout.IsStrictlyPositive () ? m_helloTimeout : Seconds (1.0), &VideoStreamClient::SendJoin, this);
+  }
+}
+
+uint32_t
+VideoStreamClient::GetPath (Ptr<Socket> socket) const
+{
+  for (uint32_t index = 1; index < m_paths.size (); index++)
+  {
+    if (m_paths[index].m_socket == socket)
+    {
+      return index;
+    }
+  }
+  return 0;
 }
 
 void
@@ -157,33 +825,537 @@ VideoStreamClient::Send (void)
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_sendEvent.IsExpired ());
 
-  uint8_t dataBuffer[10];
-  sprintf((char *) dataBuffer, "%hu", 0);
-  Ptr<Packet> firstPacket = Create<Packet> (dataBuffer, 10);
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::HELLO);
+  header.SetContentId (m_contentId);
+  header.SetVideoLevel (m_videoLevel);
+  header.SetFrame (m_resumeFrame);
+  // lets a server sizing the fragments to the path MTU know the MTU of the last link
+  header.SetSequence (GetLinkMtu ());
+  VideoStreamSessionHeader session;
+  session.SetMaxVideoLevel (m_maxVideoLevel);
+  session.SetBufferCapacity (m_bufferCapacity);
+  session.SetAttempt (std::min<uint32_t> (m_helloAttempts, 255));
+  session.SetMaxHeight (m_maxHeight);
+  Ptr<Packet> firstPacket = Create<Packet> ();
+  firstPacket->AddHeader (session);
+  firstPacket->AddHeader (header);
   m_socket->Send (firstPacket);
+  m_eventLog.Add (VideoStreamEventLog::CLIENT_HELLO_SENT, 0, m_helloAttempts, firstPacket->GetSize (), m_videoLevel);
+  if (m_helloAttempts == 0)
+  {
+    m_firstHelloTime = Simulator::Now ();
+  }
+  m_helloAttempts++;
+  if (m_helloTimeout.IsStrictlyPositive ())
+  {
+    // exponential backoff, so that a congested server is not flooded with retries
+    m_sendEvent = Simulator::Schedule (m_helloTimeout * static_cast<int64_t> (1 << std::min<uint32_t> (m_helloAttempts - 1, 16)),
+                                       &VideoStreamClient::HelloTimeout, this);
+  }
 
   if (Ipv4Address::IsMatchingType (m_peerAddress))
   {
-    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client sent 10 bytes to " <<
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client sent hello for title " << m_contentId << " to " <<
                   Ipv4Address::ConvertFrom (m_peerAddress) << " port " << m_peerPort);
   }
   else if (Ipv6Address::IsMatchingType (m_peerAddress))
   {
-    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client sent 10 bytes to " <<
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client sent hello for title " << m_contentId << " to " <<
                   Ipv6Address::ConvertFrom (m_peerAddress) << " port " << m_peerPort);
   }
   else if (InetSocketAddress::IsMatchingType (m_peerAddress))
   {
-    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client sent 10 bytes to " <<
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client sent hello for title " << m_contentId << " to " <<
                   InetSocketAddress::ConvertFrom (m_peerAddress).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (m_peerAddress).GetPort ());
   }
   else if (Inet6SocketAddress::IsMatchingType (m_peerAddress))
   {
-    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client sent 10 bytes to " <<
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client sent hello for title " << m_contentId << " to " <<
                   Inet6SocketAddress::ConvertFrom (m_peerAddress).GetIpv6 () << " port " << Inet6SocketAddress::ConvertFrom (m_peerAddress).GetPort ());
   }
 }
 
+void
+VideoStreamClient::HelloTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_helloAttempts > m_maxHelloRetries)
+  {
+    if (m_failoverTimeout.IsStrictlyPositive () && Failover ())
+    {
+      return;
+    }
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client gave up after " << m_helloAttempts << " unanswered hellos");
+    m_eventLog.Add (VideoStreamEventLog::CLIENT_HELLO_TIMEOUT, 0, m_helloAttempts, 0, m_videoLevel);
+    return;
+  }
+  Send ();
+}
+
+void
+VideoStreamClient::EstablishSession (void)
+{
+  if (m_sessionAcked)
+  {
+    return;
+  }
+  m_sessionAcked = true;
+  Simulator::Cancel (m_sendEvent);
+  m_handshakeTime = Simulator::Now () - m_firstHelloTime;
+  m_lastDeliveryTime = Simulator::Now ();
+  if (m_failoverTimeout.IsStrictlyPositive () && m_nextFailoverServer < m_failoverServers.size ())
+  {
+    Simulator::Cancel (m_deliveryEvent);
+    m_deliveryEvent = Simulator::Schedule (m_failoverTimeout, &VideoStreamClient::CheckDelivery, this);
+  }
+  if (m_multipath)
+  {
+    if (m_paths.size () == 1)
+    {
+      OpenSubflows ();
+    }
+    Simulator::Cancel (m_joinEvent);
+    SendJoin ();
+  }
+  m_eventLog.Add (VideoStreamEventLog::CLIENT_SESSION_ACKED, 0, m_helloAttempts, m_handshakeTime.GetMicroSeconds (), m_videoLevel);
+  NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client session acknowledged after " << m_helloAttempts
+               << " hellos, level " << m_videoLevel << " of at most " << m_offeredLevel);
+  if (!m_live && !m_seeking && m_bufferEvent.IsExpired ())
+  {
+    // the playback gave up waiting for the first frames, start it again
+    m_stopCounter = 0;
+    m_bufferEvent = Simulator::Schedule (Seconds (m_initialDelay), &VideoStreamClient::ReadFromBuffer, this);
+  }
+}
+
+void
+VideoStreamClient::CheckDelivery (void)
+{
+  if (m_titleCompleted)
+  {
+    return;
+  }
+  Time silence = Simulator::Now () - m_lastDeliveryTime;
+  if (silence < m_failoverTimeout)
+  {
+    m_deliveryEvent = Simulator::Schedule (m_failoverTimeout - silence, &VideoStreamClient::CheckDelivery, this);
+    return;
+  }
+  NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client received nothing for " << silence.GetMilliSeconds () << "ms");
+  Failover ();
+}
+
+bool
+VideoStreamClient::Failover (void)
+{
+  if (m_nextFailoverServer >= m_failoverServers.size ())
+  {
+    return false;
+  }
+  // the previous server stops streaming if it still hears the client
+  SendBye ();
+  InetSocketAddress server = m_failoverServers[m_nextFailoverServer++];
+  m_failovers++;
+  if (m_seekPending)
+  {
+    // the next server starts at the position the client seeks to
+    m_resumeFrame = m_seekFrame;
+    m_seekPending = false;
+    Simulator::Cancel (m_seekEvent);
+  }
+  else if (m_frameCompleted)
+  {
+    m_resumeFrame = m_lastCompleteFrame + 1;
+  }
+  if (!m_failoverPending)
+  {
+    // a server failing before it sent anything extends the gap of the previous one
+    m_failoverStart = m_lastDeliveryTime;
+  }
+  m_failoverPending = true;
+  // the sequence numbers of the next server start from 0 again
+  m_sequenceOffset = m_deliveredPackets > 0 ? m_lastSequence + 1 : 0;
+  m_peerAddress = server.GetIpv4 ();
+  m_peerPort = server.GetPort ();
+  m_activeServer = server;
+  m_socket->Connect (server);
+  // the subflows join the next server once it acknowledges the session
+  Simulator::Cancel (m_joinEvent);
+  for (uint32_t index = 1; index < m_paths.size (); index++)
+  {
+    m_paths[index].m_socket->Connect (server);
+    m_paths[index].m_joined = false;
+    m_paths[index].m_joinAttempts = 0;
+  }
+  m_sessionAcked = false;
+  m_helloAttempts = 0;
+  NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client fails over to " << server.GetIpv4 ()
+               << " port " << server.GetPort () << " from frame " << m_resumeFrame);
+  m_eventLog.Add (VideoStreamEventLog::CLIENT_FAILOVER, 0, m_resumeFrame, m_failovers, m_videoLevel);
+  Simulator::Cancel (m_deliveryEvent);
+  Simulator::Cancel (m_sendEvent);
+  Send ();
+  return true;
+}
+
+void
+VideoStreamClient::SendBye (void)
+{
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::BYE);
+  header.SetContentId (m_contentId);
+  Ptr<Packet> byePacket = Create<Packet> ();
+  byePacket->AddHeader (header);
+  m_socket->Send (byePacket);
+}
+
+void
+VideoStreamClient::Seek (uint32_t frame)
+{
+  NS_LOG_FUNCTION (this << frame);
+  StartSeek (frame, false);
+}
+
+void
+VideoStreamClient::FastForward (uint32_t frame)
+{
+  NS_LOG_FUNCTION (this << frame);
+  StartSeek (frame, true);
+}
+
+void
+VideoStreamClient::StartSeek (uint32_t frame, bool trickPlay)
+{
+  if (m_socket == 0 || m_live || m_rejected)
+  {
+    NS_LOG_WARN ("Ignoring a seek outside of an on-demand session");
+    return;
+  }
+  m_seekCount++;
+  m_seekFrame = frame;
+  m_trickPlay = trickPlay;
+  m_seekStart = Simulator::Now ();
+  m_seekPending = true;
+  m_seeking = true;
+  m_titleCompleted = false;
+  m_eventLog.Add (VideoStreamEventLog::CLIENT_SEEK, 0, frame, m_currentBufferSize, m_videoLevel);
+  NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client seeks to frame " << frame
+               << (m_trickPlay ? " in fast forward" : "") << ", flushing " << m_currentBufferSize << " frames");
+
+  // the playback waits for the frames of the new position
+  Simulator::Cancel (m_bufferEvent);
+  m_currentBufferSize = 0;
+  m_lastBufferSize = 0;
+  m_lastRecvFrame = 1e6;
+  m_frameSize = 0;
+  m_stopCounter = 0;
+  m_rebufferCounter = 0;
+  if (m_stalled)
+  {
+    EndStall ();
+  }
+
+  Simulator::Cancel (m_seekEvent);
+  m_seekAttempts = 0;
+  SendSeek ();
+}
+
+void
+VideoStreamClient::SendSeek (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_seekAttempts > m_maxHelloRetries)
+  {
+    // the frames of the old position would be dropped forever, play them instead
+    m_seekPending = false;
+    m_seeking = false;
+    m_failedSeeks++;
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client gave up the seek to frame " << m_seekFrame
+                 << " after " << m_seekAttempts << " unanswered seeks");
+    m_eventLog.Add (VideoStreamEventLog::CLIENT_SEEK_FAILED, 0, m_seekFrame, m_seekAttempts, m_videoLevel);
+    m_bufferEvent = Simulator::Schedule (Seconds (1.0), &VideoStreamClient::ReadFromBuffer, this);
+    return;
+  }
+
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::SEEK);
+  header.SetFlags (m_trickPlay ? VideoStreamHeader::TRICK_PLAY : 0);
+  header.SetContentId (m_contentId);
+  header.SetVideoLevel (m_videoLevel);
+  header.SetFrame (m_seekFrame);
+  Ptr<Packet> seekPacket = Create<Packet> ();
+  seekPacket->AddHeader (header);
+  m_socket->Send (seekPacket);
+  m_seekAttempts++;
+  if (m_helloTimeout.IsStrictlyPositive ())
+  {
+    m_seekEvent = Simulator::Schedule (m_helloTimeout * static_cast<int64_t> (1 << std::min<uint32_t> (m_seekAttempts - 1, 16)),
+                                       &VideoStreamClient::SendSeek, this);
+  }
+}
+
+void
+VideoStreamClient::SendVideoLevel (Ptr<Socket> socket, const Address &to)
+{
+  NS_LOG_FUNCTION (this << m_videoLevel);
+
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::LEVEL);
+  header.SetContentId (m_contentId);
+  header.SetVideoLevel (m_videoLevel);
+  header.SetFrame (m_lastRecvFrame);
+  Ptr<Packet> levelPacket = Create<Packet> ();
+  levelPacket->AddHeader (header);
+  socket->SendTo (levelPacket, 0, to);
+}
+
+void
+VideoStreamClient::RecordReportSample (const VideoStreamHeader &header, uint32_t packetSize)
+{
+  if (m_reportEvent.IsExpired ())
+  {
+    m_reportStart = Simulator::Now ();
+    m_reportEvent = Simulator::Schedule (m_reportInterval, &VideoStreamClient::SendReport, this);
+  }
+
+  uint32_t sequence = header.GetSequence ();
+  bool firstPacket = !m_sequenceStarted;
+  if (firstPacket)
+  {
+    m_sequenceStarted = true;
+    m_expectedSequence = sequence;
+    m_highestSequence = sequence;
+  }
+  // an aggregated packet stands for several fragments and sequence numbers
+  m_highestSequence = std::max (m_highestSequence, sequence + header.GetFragments () - 1);
+  m_reportBytes += packetSize;
+  m_reportPackets += header.GetFragments ();
+
+  // transit jitter as in RFC 3550
+  Time transit = Simulator::Now () - header.GetTimestamp ();
+  if (!firstPacket)
+  {
+    m_packetJitter += (Abs (transit - m_packetTransit) - m_packetJitter) / 16;
+  }
+  m_packetTransit = transit;
+
+  double t = (Simulator::Now () - m_reportStart).GetSeconds ();
+  double d = transit.GetSeconds ();
+  m_trendSums[0] += 1;
+  m_trendSums[1] += t;
+  m_trendSums[2] += d;
+  m_trendSums[3] += t * d;
+  m_trendSums[4] += t * t;
+}
+
+void
+VideoStreamClient::RecordDelivery (const VideoStreamHeader &header)
+{
+  uint32_t sequence = header.GetSequence ();
+  uint16_t fragments = header.GetFragments ();
+  bool firstPacket = m_deliveredPackets == 0;
+  if (firstPacket)
+  {
+    m_firstSequence = sequence;
+    m_lastSequence = sequence;
+  }
+  m_deliveredPackets += fragments;
+
+  if (sequence < m_lastSequence)
+  {
+    uint32_t depth = m_lastSequence - sequence;
+    m_reorderedPackets++;
+    m_maxReorderDepth = std::max (m_maxReorderDepth, depth);
+    m_reorderTrace (depth);
+  }
+  m_lastSequence = std::max (m_lastSequence, sequence + fragments - 1);
+
+  for (uint32_t i = 0; i < fragments; i++)
+  {
+    m_lossCounter.NotifyReceived (sequence + i);
+  }
+  if (m_lossCounter.GetLost () != m_lostPackets)
+  {
+    m_lostPackets = m_lossCounter.GetLost ();
+  }
+
+  // the timestamp is the send time, or the production time of a live frame
+  m_oneWayDelay = Simulator::Now () - header.GetTimestamp ();
+  m_delaySum += m_oneWayDelay * static_cast<int64_t> (fragments);
+  m_delayTrace (m_oneWayDelay);
+
+  if (!firstPacket && header.GetFrame () == m_lastRecvFrame)
+  {
+    m_fragmentGap.Record (Simulator::Now () - m_lastPacketTime);
+  }
+  m_lastPacketTime = Simulator::Now ();
+  if (header.GetFlags () & VideoStreamHeader::LAST_FRAGMENT)
+  {
+    m_frameLatency.Record (m_oneWayDelay);
+  }
+}
+
+void
+VideoStreamClient::SendReport (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // loss from the sequence numbers expected in the interval
+  uint32_t expected = m_highestSequence + 1 - m_expectedSequence;
+  double lossFraction = expected > m_reportPackets ? static_cast<double> (expected - m_reportPackets) / expected : 0.0;
+
+  // least squares slope of the one-way delay over the interval
+  double n = m_trendSums[0];
+  double denominator = n * m_trendSums[4] - m_trendSums[1] * m_trendSums[1];
+  double trend = n > 1 && denominator > 0 ? (n * m_trendSums[3] - m_trendSums[1] * m_trendSums[2]) / denominator : 0.0;
+
+  VideoStreamReportHeader report;
+  report.SetDuration (Simulator::Now () - m_reportStart);
+  report.SetReceivedBytes (m_reportBytes);
+  report.SetHighestSequence (m_highestSequence);
+  report.SetLossFraction (lossFraction);
+  report.SetJitter (m_packetJitter);
+  report.SetDelayTrend (Seconds (trend));
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::REPORT);
+  header.SetContentId (m_contentId);
+  header.SetVideoLevel (m_videoLevel);
+  header.SetFrame (m_lastRecvFrame);
+  Ptr<Packet> reportPacket = Create<Packet> ();
+  reportPacket->AddHeader (report);
+  reportPacket->AddHeader (header);
+  m_socket->Send (reportPacket);
+  NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s client sent report " << report);
+  if (m_paths.size () > 1)
+  {
+    SendPathReports (Simulator::Now () - m_reportStart);
+  }
+
+  m_expectedSequence = m_highestSequence + 1;
+  m_reportBytes = 0;
+  m_reportPackets = 0;
+  std::fill (m_trendSums, m_trendSums + 5, 0.0);
+  m_reportStart = Simulator::Now ();
+  m_reportEvent = Simulator::Schedule (m_reportInterval, &VideoStreamClient::SendReport, this);
+}
+
+void
+VideoStreamClient::SendPathReports (Time duration)
+{
+  for (uint32_t index = 0; index < m_paths.size (); index++)
+  {
+    PathInfo &path = m_paths[index];
+    if (index == 0 || path.m_joined)
+    {
+      VideoStreamPathReportHeader report;
+      report.SetDuration (duration);
+      report.SetReceivedBytes (path.m_reportBytes);
+      report.SetDelay (path.m_reportPackets > 0 ? path.m_reportDelay / static_cast<int64_t> (path.m_reportPackets) : Seconds (0.0));
+      VideoStreamHeader header;
+      header.SetMessageType (VideoStreamHeader::PATH_REPORT);
+      header.SetContentId (m_contentId);
+      Ptr<Packet> reportPacket = Create<Packet> ();
+      reportPacket->AddHeader (report);
+      reportPacket->AddHeader (header);
+      path.m_socket->Send (reportPacket);
+      NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s client sent report " << report << " of path " << index);
+    }
+    path.m_reportBytes = 0;
+    path.m_reportPackets = 0;
+    path.m_reportDelay = Seconds (0.0);
+  }
+}
+
+void
+VideoStreamClient::CheckLinkHints (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_linkEvent = Simulator::Schedule (m_linkHintInterval, &VideoStreamClient::CheckLinkHints, this);
+  double throughput = m_hintBytes * 8.0 / m_linkHintInterval.GetSeconds ();
+  m_hintBytes = 0;
+  if (!m_sessionAcked || m_ladder.GetLevelCount () == 0 || m_linkMonitor->GetPhyRate ().GetBitRate () == 0)
+  {
+    return;
+  }
+  m_throughputEstimate = m_throughputEstimate > 0 ? 0.75 * m_throughputEstimate + 0.25 * throughput : throughput;
+  double snr = m_linkMonitor->GetSnr ();
+  double snrDrop = m_lastHintSnr - snr;
+  m_lastHintSnr = snr;
+  m_linkStateTrace (snr, m_linkMonitor->GetPhyRate (), m_linkMonitor->GetRetryRate (), m_videoLevel);
+
+  // the rate the link gives the stream at its current MCS, less the retransmissions
+  double linkRate = m_linkMonitor->GetPhyRate ().GetBitRate () * (1 - m_linkMonitor->GetRetryRate ()) * m_linkEfficiency;
+  uint16_t topLevel = std::min (m_offeredLevel, m_ladder.GetLevelCount ());
+  m_linkLimited = m_videoLevel < topLevel && GetLevelRate (m_videoLevel + 1) * LINK_UPGRADE_MARGIN > linkRate;
+
+  uint64_t levelRate = GetLevelRate (m_videoLevel);
+  bool linkShort = linkRate < levelRate;
+  bool fading = m_throughputEstimate < LINK_FADING_SHARE * levelRate && snrDrop > LINK_SNR_DROP;
+  if (!m_adaptive || m_videoLevel <= 1 || (!linkShort && !fading))
+  {
+    return;
+  }
+  // the highest level the link, and a fading link the throughput, can carry
+  double budget = fading ? std::min (linkRate, m_throughputEstimate) : linkRate;
+  uint16_t videoLevel = m_videoLevel - 1;
+  while (videoLevel > 1 && GetLevelRate (videoLevel) > budget)
+  {
+    videoLevel--;
+  }
+  NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client lowers the video level from " << m_videoLevel
+               << " to " << videoLevel << " on the link hints, link rate " << DataRate (linkRate)
+               << ", throughput " << DataRate (m_throughputEstimate));
+  m_videoLevel = videoLevel;
+  m_linkSwitches++;
+  m_linkLimited = true;
+  m_rebufferCounter = 0;
+  m_eventLog.Add (VideoStreamEventLog::CLIENT_LEVEL_CHANGED, 0, m_lastRecvFrame, m_currentBufferSize, m_videoLevel);
+  RecordLinkState ();
+  Address server;
+  m_socket->GetPeerName (server);
+  SendVideoLevel (m_socket, server);
+}
+
+uint64_t
+VideoStreamClient::GetLevelRate (uint16_t videoLevel) const
+{
+  if (videoLevel < 1 || videoLevel > m_ladder.GetLevelCount ())
+  {
+    return 0;
+  }
+  return m_ladder.GetRendition (videoLevel).m_bitRate.GetBitRate ();
+}
+
+void
+VideoStreamClient::RecordLinkState (void)
+{
+  if (m_linkMonitor == 0)
+  {
+    return;
+  }
+  double snr = m_linkMonitor->GetSnr ();
+  m_eventLog.Add (VideoStreamEventLog::CLIENT_LINK_STATE, 0, static_cast<uint32_t> (std::max (0.0, snr) * 100),
+                  m_linkMonitor->GetPhyRate ().GetBitRate () / 1000, m_videoLevel);
+  NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client at level " << m_videoLevel << " on a link with SNR "
+               << snr << "dB, mode " << m_linkMonitor->GetMode () << ", retry rate " << m_linkMonitor->GetRetryRate ());
+}
+
+void
+VideoStreamClient::EndStall (void)
+{
+  Time stall = Simulator::Now () - m_stallStart;
+  m_stallDuration.Record (stall);
+  if (m_failovers > 0 && m_stallStart >= m_failoverStart && (m_failoverPending || m_stallStart <= m_failoverEnd))
+  {
+    m_failoverStallTime += stall;
+  }
+  m_stalled = false;
+}
+
 uint32_t 
 VideoStreamClient::ReadFromBuffer (void)
 {
@@ -204,8 +1376,15 @@ VideoStreamClient::ReadFromBuffer (void)
     else
     {
       NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << " s: Not enough frames in the buffer, rebuffering!");
+      m_eventLog.Add (VideoStreamEventLog::CLIENT_REBUFFER, 0, m_lastRecvFrame, m_currentBufferSize, m_videoLevel);
       m_stopCounter = 0;  // reset the stopCounter
       m_rebufferCounter++;
+      m_stallCount++;
+      if (!m_stalled)
+      {
+        m_stalled = true;
+        m_stallStart = Simulator::Now ();
+      }
       m_bufferEvent = Simulator::Schedule (Seconds (1.0), &VideoStreamClient::ReadFromBuffer, this);
     }
 
@@ -214,9 +1393,28 @@ VideoStreamClient::ReadFromBuffer (void)
   }
   else
   {
-    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << " s: Play video frames from the buffer");
+    NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << " s: Play video frames from the buffer");
+    m_eventLog.Add (VideoStreamEventLog::CLIENT_PLAY, 0, m_lastRecvFrame, m_currentBufferSize, m_videoLevel);
+    if (!m_playbackStarted)
+    {
+      m_playbackStarted = true;
+      m_startupDelay = Simulator::Now () - m_startTime;
+      NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client started the playback after " << m_startupDelay.GetMilliSeconds () << "ms");
+    }
+    if (m_seeking)
+    {
+      m_seeking = false;
+      Time seekLatency = Simulator::Now () - m_seekStart;
+      m_seekLatency.Record (seekLatency);
+      m_eventLog.Add (VideoStreamEventLog::CLIENT_SEEK_RESUMED, 0, m_lastRecvFrame, seekLatency.GetMicroSeconds (), m_videoLevel);
+      NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client resumed the playback " << seekLatency.GetMilliSeconds () << "ms after a seek");
+    }
     if (m_stopCounter > 0) m_stopCounter = 0;    // reset the stopCounter
     if (m_rebufferCounter > 0) m_rebufferCounter = 0;   // reset the rebufferCounter
+    if (m_stalled)
+    {
+      EndStall ();
+    }
     m_currentBufferSize -= m_frameRate;
 
     m_bufferEvent = Simulator::Schedule (Seconds (1.0), &VideoStreamClient::ReadFromBuffer, this);
@@ -225,6 +1423,78 @@ VideoStreamClient::ReadFromBuffer (void)
   }
 }
 
+void
+VideoStreamClient::ScheduleLiveFrame (uint32_t frame, Time timestamp)
+{
+  NS_LOG_FUNCTION (this << frame << timestamp);
+
+  // adaptive jitter buffer, with the transit jitter smoothed as in RFC 3550
+  Time transit = Simulator::Now () - timestamp;
+  if (m_completeLiveFrames == 0)
+  {
+    m_minTransit = transit;
+    m_jitter = Seconds (0.0);
+  }
+  else
+  {
+    m_minTransit = Min (m_minTransit, transit);
+    m_jitter += (Abs (transit - m_lastTransit) - m_jitter) / 16;
+  }
+  m_lastTransit = transit;
+  m_completeLiveFrames++;
+  m_playoutDelay = Min (m_minTransit + m_jitter * static_cast<int64_t> (4), m_targetLatency);
+
+  Time playout = timestamp + m_playoutDelay;
+  if (Simulator::Now () > playout)
+  {
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s live frame " << frame << " arrived "
+                 << (Simulator::Now () - playout).GetMilliSeconds () << "ms after its playout time");
+    m_eventLog.Add (VideoStreamEventLog::CLIENT_LIVE_LATE, 0, frame, (Simulator::Now () - playout).GetMicroSeconds (), m_videoLevel);
+    m_lateFrames++;
+    m_onTimeFrames = 0;
+    // late frames count as rebuffering events for the level adaptation
+    m_rebufferCounter++;
+    if (m_currentBufferSize > 0)
+    {
+      m_currentBufferSize--;
+    }
+    return;
+  }
+  Simulator::Schedule (playout - Simulator::Now (), &VideoStreamClient::PlayLiveFrame, this, frame, timestamp);
+}
+
+void
+VideoStreamClient::PlayLiveFrame (uint32_t frame, Time timestamp)
+{
+  if (m_currentBufferSize > 0)
+  {
+    m_currentBufferSize--;
+  }
+  if (m_socket == 0 || (m_playedFrames > 0 && frame <= m_lastPlayedFrame))
+  {
+    // stopped, or overtaken by a later frame after the playout delay shrank
+    return;
+  }
+  if (m_playedFrames > 0)
+  {
+    m_skippedFrames += frame - m_lastPlayedFrame - 1;
+  }
+  if (!m_playbackStarted)
+  {
+    m_playbackStarted = true;
+    m_startupDelay = Simulator::Now () - m_startTime;
+  }
+  m_lastPlayedFrame = frame;
+  m_playedFrames++;
+  m_onTimeFrames++;
+  m_latencyToLive = Simulator::Now () - timestamp;
+  m_latencySum += m_latencyToLive;
+  m_latencyTrace (m_latencyToLive);
+  m_eventLog.Add (VideoStreamEventLog::CLIENT_LIVE_PLAY, 0, frame, m_latencyToLive.GetMicroSeconds (), m_videoLevel);
+  NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s client played live frame " << frame
+                << ", latency to live " << m_latencyToLive.GetMilliSeconds () << "ms");
+}
+
 void 
 VideoStreamClient::HandleRead (Ptr<Socket> socket)
 {
@@ -238,55 +1508,243 @@ VideoStreamClient::HandleRead (Ptr<Socket> socket)
     socket->GetSockName (localAddress);
     if (InetSocketAddress::IsMatchingType (from))
     {
-      uint8_t recvData[packet->GetSize()];
-      packet->CopyData (recvData, packet->GetSize ());
-      uint32_t frameNum;
-      sscanf ((char *) recvData, "%u", &frameNum);
+      m_rxTrace (packet, from);
+
+      VideoStreamHeader header;
+      if (packet->GetSize () < header.GetSerializedSize ())
+      {
+        continue;
+      }
+      packet->PeekHeader (header);
+      uint32_t path = GetPath (socket);
+      if (m_failovers > 0 && path == 0 && from != m_activeServer)
+      {
+        // late packets of a server the session failed over from
+        continue;
+      }
+      if (header.GetMessageType () == VideoStreamHeader::JOIN && path > 0 && !m_paths[path].m_joined)
+      {
+        m_paths[path].m_joined = true;
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client joined path " << path << " from " << m_paths[path].m_local);
+        m_eventLog.Add (VideoStreamEventLog::CLIENT_SUBFLOW_JOINED, 0, path, m_paths[path].m_joinAttempts, m_videoLevel);
+        continue;
+      }
+      if (path > 0 && header.GetMessageType () != VideoStreamHeader::DATA)
+      {
+        continue;
+      }
+      if (header.GetMessageType () == VideoStreamHeader::REDIRECT)
+      {
+        // only the first REDIRECT is followed, the answers to repeated HELLO would open more sessions
+        VideoStreamRedirectHeader redirect;
+        if (m_redirected || m_sessionAcked || packet->GetSize () < header.GetSerializedSize () + redirect.GetSerializedSize ())
+        {
+          continue;
+        }
+        packet->RemoveHeader (header);
+        packet->RemoveHeader (redirect);
+        m_redirected = true;
+        m_peerAddress = redirect.GetServerAddress ();
+        m_peerPort = redirect.GetServerPort ();
+        m_socket->Connect (InetSocketAddress (redirect.GetServerAddress (), m_peerPort));
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client was redirected to " << redirect.GetServerAddress () << " port " << m_peerPort);
+        m_eventLog.Add (VideoStreamEventLog::CLIENT_REDIRECTED, 0, m_helloAttempts, m_peerPort, m_videoLevel);
+        Simulator::Cancel (m_sendEvent);
+        Send ();
+        continue;
+      }
+      if (header.GetMessageType () == VideoStreamHeader::REJECT)
+      {
+        if (m_failoverTimeout.IsStrictlyPositive () && !m_sessionAcked && Failover ())
+        {
+          continue;
+        }
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client was rejected by the server");
+        m_eventLog.Add (VideoStreamEventLog::CLIENT_REJECTED, 0, 0, packet->GetSize (), m_videoLevel);
+        m_rejected = true;
+        Simulator::Cancel (m_sendEvent);
+        Simulator::Cancel (m_bufferEvent);
+        continue;
+      }
+      if (header.GetMessageType () == VideoStreamHeader::HELLO_ACK)
+      {
+        VideoStreamSessionHeader session;
+        if (packet->GetSize () >= header.GetSerializedSize () + session.GetSerializedSize ())
+        {
+          Ptr<Packet> ack = packet->Copy ();
+          ack->RemoveHeader (header);
+          ack->RemoveHeader (session);
+          // never adapt above what either side supports
+          if (session.GetMaxVideoLevel () > 0)
+          {
+            m_offeredLevel = std::max<uint16_t> (1, std::min (m_offeredLevel, session.GetMaxVideoLevel ()));
+          }
+          VideoStreamLadderHeader ladder;
+          if (ack->GetSize () >= ladder.GetSerializedSize ())
+          {
+            ack->RemoveHeader (ladder);
+            m_ladder = ladder.GetLadder ();
+          }
+        }
+        if (!m_sessionAcked && header.GetVideoLevel () >= 1 && header.GetVideoLevel () <= m_offeredLevel)
+        {
+          m_videoLevel = header.GetVideoLevel ();
+        }
+        EstablishSession ();
+        continue;
+      }
+      if (header.GetMessageType () != VideoStreamHeader::DATA)
+      {
+        continue;
+      }
+      // the messages to the server go through the session socket
+      Ptr<Socket> replySocket = socket;
+      Address replyTo = from;
+      if (path > 0)
+      {
+        replySocket = m_socket;
+        m_socket->GetPeerName (replyTo);
+      }
+      // the first frame stands for the acknowledgement of a server that sends none
+      EstablishSession ();
+      m_lastDeliveryTime = Simulator::Now ();
+      if (m_failoverPending)
+      {
+        m_failoverPending = false;
+        m_failoverEnd = Simulator::Now ();
+        Time gap = m_failoverEnd - m_failoverStart;
+        m_failoverGap.Record (gap);
+        m_eventLog.Add (VideoStreamEventLog::CLIENT_FAILOVER_RESUMED, 0, header.GetFrame (), gap.GetMicroSeconds (), m_videoLevel);
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client resumed at frame " << header.GetFrame ()
+                     << " " << gap.GetMilliSeconds () << "ms after the last packet of the failed server");
+      }
+      header.SetSequence (header.GetSequence () + m_sequenceOffset);
+      uint32_t frameNum = header.GetFrame ();
+      m_receivedVideoLevel = header.GetVideoLevel ();
+      if (m_deliveredPackets == 0)
+      {
+        m_firstPacketTime = Simulator::Now ();
+      }
+      RecordDelivery (header);
+      PathInfo &pathInfo = m_paths[path];
+      pathInfo.m_receivedBytes += packet->GetSize ();
+      m_hintBytes += packet->GetSize ();
+      pathInfo.m_reportBytes += packet->GetSize ();
+      pathInfo.m_reportPackets++;
+      pathInfo.m_reportDelay += m_oneWayDelay;
+      if (m_reportInterval.IsStrictlyPositive ())
+      {
+        RecordReportSample (header, packet->GetSize ());
+      }
+      if (!m_live && (header.GetFlags () & VideoStreamHeader::LIVE))
+      {
+        // live frames are played one by one at their playout time instead of from the buffer
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client joined a live stream at frame " << frameNum);
+        m_live = true;
+        Simulator::Cancel (m_bufferEvent);
+      }
+      if (m_seekPending)
+      {
+        if (!(header.GetFlags () & VideoStreamHeader::DISCONTINUITY))
+        {
+          // sent before the server received the SEEK
+          continue;
+        }
+        m_seekPending = false;
+        Simulator::Cancel (m_seekEvent);
+      }
 
-      if (frameNum == m_lastRecvFrame)
+      if (m_paths.size () > 1 && frameNum < m_lastRecvFrame && m_lastRecvFrame - frameNum < 64
+          && !(header.GetFlags () & VideoStreamHeader::DISCONTINUITY))
+      {
+        // a fragment overtaken on a faster path, its frame is counted once
+        uint64_t bit = static_cast<uint64_t> (1) << (m_lastRecvFrame - frameNum);
+        if (!(m_recentFrames & bit))
+        {
+          m_recentFrames |= bit;
+          m_currentBufferSize++;
+          m_receivedFrames++;
+        }
+      }
+      else if (frameNum == m_lastRecvFrame)
       {
         m_frameSize += packet->GetSize ();
       }
       else
       {
-        if (frameNum > 0)
+        if (frameNum > 0 && m_frameSize > 0)
         {
-          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client received frame " << frameNum-1 << " and " << m_frameSize << " bytes from " <<  InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (from).GetPort ());
+          m_eventLog.Add (VideoStreamEventLog::CLIENT_FRAME_RECEIVED, 0, frameNum - 1, m_frameSize, m_videoLevel);
+          NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s client received frame " << frameNum-1 << " and " << m_frameSize << " bytes from " <<  InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (from).GetPort ());
         }
 
         m_currentBufferSize++;
+        m_receivedFrames++;
+        m_recentFrames = frameNum > m_lastRecvFrame && frameNum - m_lastRecvFrame < 64 ? (m_recentFrames << (frameNum - m_lastRecvFrame)) | 1 : 1;
         m_lastRecvFrame = frameNum;
         m_frameSize = packet->GetSize ();
       }
+      if (header.GetFlags () & VideoStreamHeader::LAST_FRAGMENT)
+      {
+        m_frameCompleted = true;
+        m_lastCompleteFrame = frameNum;
+      }
+      if (header.GetFlags () & VideoStreamHeader::LAST_FRAME)
+      {
+        m_titleCompleted = true;
+      }
+      if (!m_firstFrameReceived && (header.GetFlags () & VideoStreamHeader::LAST_FRAGMENT))
+      {
+        m_firstFrameReceived = true;
+        m_timeToFirstFrame = Simulator::Now () - m_startTime;
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s client received its first frame after " << m_timeToFirstFrame.GetMilliSeconds () << "ms");
+      }
+      if (!m_live && (m_seeking || (!m_playbackStarted && m_startThreshold > 0))
+          && m_currentBufferSize >= std::max (m_startThreshold, m_frameRate))
+      {
+        // enough frames to play without waiting for the rest of the initial delay, or to resume after a seek
+        Simulator::Cancel (m_bufferEvent);
+        ReadFromBuffer ();
+      }
+      if (m_live && (header.GetFlags () & VideoStreamHeader::LAST_FRAGMENT))
+      {
+        ScheduleLiveFrame (frameNum, header.GetTimestamp ());
+      }
 
       // The rebuffering event has happend 3+ times, which suggest the client to lower the video quality.
-      if (m_rebufferCounter >= 3)
+      if (m_adaptive && m_rebufferCounter >= 3)
       {
         if (m_videoLevel > 1)
         {
           NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s: Lower the video quality level!");
           m_videoLevel--;
+          m_eventLog.Add (VideoStreamEventLog::CLIENT_LEVEL_CHANGED, 0, m_lastRecvFrame, m_currentBufferSize, m_videoLevel);
+          RecordLinkState ();
           // reflect the change to the server
-          uint8_t dataBuffer[10];
-          sprintf((char *) dataBuffer, "%hu", m_videoLevel);
-          Ptr<Packet> levelPacket = Create<Packet> (dataBuffer, 10);
-          socket->SendTo (levelPacket, 0, from);
+          SendVideoLevel (replySocket, replyTo);
           m_rebufferCounter = 0;
         }
       }
       
-      // If the current buffer size supports 5+ seconds video, we can try to increase the video quality level.
-      if (m_currentBufferSize > 5 * m_frameRate)
+      // If the current buffer size supports 5+ seconds video, or 5+ seconds of live frames were played
+      // on time, we can try to increase the video quality level, unless the link hints show the link could not carry it.
+      if (m_adaptive && !m_linkLimited && (m_live ? m_onTimeFrames > 5 * m_frameRate : m_currentBufferSize > 5 * m_frameRate))
       {
-        if (m_videoLevel < MAX_VIDEO_LEVEL)
+        if (m_videoLevel < m_offeredLevel)
         {
           m_videoLevel++;
+          m_eventLog.Add (VideoStreamEventLog::CLIENT_LEVEL_CHANGED, 0, m_lastRecvFrame, m_currentBufferSize, m_videoLevel);
+          RecordLinkState ();
           // reflect the change to the server
-          uint8_t dataBuffer[10];
-          sprintf((char *) dataBuffer, "%hu", m_videoLevel);
-          Ptr<Packet> levelPacket = Create<Packet> (dataBuffer, 10);
-          socket->SendTo (levelPacket, 0, from);
-          m_currentBufferSize = m_frameRate;
+          SendVideoLevel (replySocket, replyTo);
+          if (m_live)
+          {
+            m_onTimeFrames = 0;
+          }
+          else
+          {
+            m_currentBufferSize = m_frameRate;
+          }
           NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds() << "s: Increase the video quality level to " << m_videoLevel);
         }
       }
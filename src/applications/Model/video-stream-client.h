@@ -7,14 +7,26 @@
 #include "ns3/event-id.h"
 #include "ns3/ptr.h"
 #include "ns3/address.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+#include "ns3/packet-loss-counter.h"
+#include "video-stream-event-log.h"
+#include "video-stream-header.h"
+#include "video-stream-histogram.h"
+#include "video-stream-ladder.h"
+#include "video-stream-link-monitor.h"
 
-#define MAX_VIDEO_LEVEL 6
+#include <vector>
 
 namespace ns3 {
 
 class Socket;
 class Packet;
+class NetDevice;
+class Ipv4Route;
 
 /**
  * @brief A Video Stream Client
@@ -45,6 +57,360 @@ public:
    */
   void SetRemote (Address addr);
 
+  /**
+   * @brief Add a server the session fails over to, after the others added before.
+   * 
+   * @param address the IPv4 address of the server
+   * @param port the port of the server
+   */
+  void AddFailoverServer (Ipv4Address address, uint16_t port);
+
+  /**
+   * @brief Set the servers the session fails over to.
+   * 
+   * @param servers ADDRESS[:PORT] of each server, in order, separated by semicolons; the port defaults to 6969
+   */
+  void SetFailoverServers (std::string servers);
+
+  /**
+   * @brief Get the servers the session fails over to.
+   * 
+   * @return ADDRESS:PORT of each server, in order, separated by semicolons
+   */
+  std::string GetFailoverServers (void) const;
+
+  /**
+   * @brief Flush the buffer and ask the server to resume from the keyframe
+   * at or before a frame.
+   * 
+   * The frames sent before the server moved the session are dropped, and the
+   * playback resumes once StartThreshold frames, at least one second of them,
+   * are buffered again. On-demand sessions only.
+   * 
+   * @param frame the frame to play from
+   */
+  void Seek (uint32_t frame);
+
+  /**
+   * @brief Flush the buffer and ask the server for the keyframes only, from
+   * the keyframe at or before a frame. Seek resumes the normal playback.
+   * 
+   * @param frame the frame to fast forward from
+   */
+  void FastForward (uint32_t frame);
+
+  /**
+   * @brief Get the number of frames received so far.
+   * 
+   * @return the number of received frames
+   */
+  uint32_t GetReceivedFrames (void) const;
+
+  /**
+   * @brief Get the number of rebuffering events so far.
+   * 
+   * @return the number of stalls
+   */
+  uint32_t GetStallCount (void) const;
+
+  /**
+   * @brief Get the current video level.
+   * 
+   * @return the video level
+   */
+  uint16_t GetVideoLevel (void) const;
+
+  /**
+   * @brief Get the video level of the last received frame, which the server
+   * may have lowered below the requested one.
+   * 
+   * @return the received video level, 0 before the first frame
+   */
+  uint16_t GetReceivedVideoLevel (void) const;
+
+  /**
+   * @brief Set the size of the window used to detect lost packets.
+   * 
+   * @param size the window size in packets, a multiple of 8
+   */
+  void SetPacketWindowSize (uint16_t size);
+
+  /**
+   * @brief Get the size of the window used to detect lost packets.
+   * 
+   * @return the window size in packets
+   */
+  uint16_t GetPacketWindowSize (void) const;
+
+  /**
+   * @brief Get the number of lost packets.
+   * 
+   * A packet is lost when it has not arrived once the window has moved past
+   * its sequence number, so reordering within the window is not counted.
+   * 
+   * @return the number of lost packets
+   */
+  uint32_t GetLostPackets (void) const;
+
+  /**
+   * @brief Get the share of the packets of the session that were lost.
+   * 
+   * @return the lost packets over the packets sent up to the highest sequence number received
+   */
+  double GetLossRate (void) const;
+
+  /**
+   * @brief Get the number of packets that arrived after a later packet.
+   * 
+   * @return the number of reordered packets
+   */
+  uint32_t GetReorderedPackets (void) const;
+
+  /**
+   * @brief Get the largest reorder depth.
+   * 
+   * @return the largest distance in sequence numbers between a reordered packet and the highest received before it
+   */
+  uint32_t GetMaxReorderDepth (void) const;
+
+  /**
+   * @brief Get the one-way delay of the last packet.
+   * 
+   * @return the time between the timestamp and the reception of the packet
+   */
+  Time GetOneWayDelay (void) const;
+
+  /**
+   * @brief Get the mean one-way delay of the packets.
+   * 
+   * @return the mean delay, zero before the first packet
+   */
+  Time GetMeanOneWayDelay (void) const;
+
+  /**
+   * @brief Get the histogram of the frame completion latencies.
+   * 
+   * @return the time between the timestamp of each frame and the arrival of its last fragment
+   */
+  const VideoStreamHistogram &GetFrameLatencyHistogram (void) const;
+
+  /**
+   * @brief Get the histogram of the fragment inter-arrival times.
+   * 
+   * @return the time between two consecutive packets of the same frame
+   */
+  const VideoStreamHistogram &GetFragmentGapHistogram (void) const;
+
+  /**
+   * @brief Get the histogram of the stall durations.
+   * 
+   * @return the time between each rebuffering event and the next playback from the buffer
+   */
+  const VideoStreamHistogram &GetStallHistogram (void) const;
+
+  /**
+   * @brief Get the time from the start of the client to the first complete frame.
+   * 
+   * @return the time to first frame, zero before the first frame
+   */
+  Time GetTimeToFirstFrame (void) const;
+
+  /**
+   * @brief Get the time from the start of the client to the start of the playback.
+   * 
+   * @return the startup delay, zero before the playback starts
+   */
+  Time GetStartupDelay (void) const;
+
+  /**
+   * @brief Get the number of seeks, fast forwards included.
+   * 
+   * @return the number of calls to Seek and FastForward
+   */
+  uint32_t GetSeekCount (void) const;
+
+  /**
+   * @brief Get the number of seeks the server never answered.
+   * 
+   * @return the number of seeks given up after MaxHelloRetries unanswered SEEK
+   */
+  uint32_t GetFailedSeekCount (void) const;
+
+  /**
+   * @brief Get the histogram of the seek latencies.
+   * 
+   * @return the time between each seek and the next playback from the buffer
+   */
+  const VideoStreamHistogram &GetSeekLatencyHistogram (void) const;
+
+  /**
+   * @brief Get the bitrate ladder of the server.
+   * 
+   * @return the renditions announced in the HELLO_ACK, empty before it or if the server sent none
+   */
+  const VideoStreamLadder &GetLadder (void) const;
+
+  /**
+   * @brief Get the ID of the requested title.
+   * 
+   * @return the content ID
+   */
+  uint32_t GetContentId (void) const;
+
+  /**
+   * @brief Whether the server refused the session.
+   * 
+   * @return true if a REJECT was received
+   */
+  bool IsRejected (void) const;
+
+  /**
+   * @brief Check whether a request router redirected the session.
+   * 
+   * @return true if a REDIRECT was followed
+   */
+  bool IsRedirected (void) const;
+
+  /**
+   * @brief Get the number of HELLO sent.
+   * 
+   * @return the first HELLO and its retries
+   */
+  uint32_t GetHelloAttempts (void) const;
+
+  /**
+   * @brief Get the time from the first HELLO to the start of the session.
+   * 
+   * @return the handshake time, zero before the session is acknowledged
+   */
+  Time GetHandshakeTime (void) const;
+
+  /**
+   * @brief Get the number of failovers.
+   * 
+   * @return the number of times the session moved to the next failover server
+   */
+  uint32_t GetFailoverCount (void) const;
+
+  /**
+   * @brief Get the histogram of the failover gaps.
+   * 
+   * @return the time between the last packet of each failed server and the first packet of the next one
+   */
+  const VideoStreamHistogram &GetFailoverGapHistogram (void) const;
+
+  /**
+   * @brief Get the stall time caused by the failovers.
+   * 
+   * @return the total duration of the stalls that started during a failover gap
+   */
+  Time GetFailoverStallTime (void) const;
+
+  /**
+   * @brief Get the number of paths of the session.
+   * 
+   * @return 1, plus the subflows opened on the other interfaces with Multipath
+   */
+  uint32_t GetPathCount (void) const;
+
+  /**
+   * @brief Check whether the server accepted the subflow of a path.
+   * 
+   * @param path the path index, 0 being the session socket
+   * @return true if the server echoed the JOIN of the path, always for path 0
+   */
+  bool IsPathJoined (uint32_t path) const;
+
+  /**
+   * @brief Get the bytes received on a path.
+   * 
+   * @param path the path index, 0 being the session socket
+   * @return the bytes of the DATA packets received on the path
+   */
+  uint64_t GetPathReceivedBytes (uint32_t path) const;
+
+  /**
+   * @brief Get the share of a path in the received bytes.
+   * 
+   * @param path the path index, 0 being the session socket
+   * @return the bytes received on the path over the bytes received on every path, 0 before the first packet
+   */
+  double GetPathShare (uint32_t path) const;
+
+  /**
+   * @brief Get the throughput of every path together.
+   * 
+   * @return the bytes received on every path over the time from the first to the last packet
+   */
+  DataRate GetAggregateThroughput (void) const;
+
+  /**
+   * @brief Get the latency to live of the last played live frame.
+   * 
+   * @return the time between the production and the playout of the frame
+   */
+  Time GetLatencyToLive (void) const;
+
+  /**
+   * @brief Get the mean latency to live of the played live frames.
+   * 
+   * @return the mean latency, zero before a live frame is played
+   */
+  Time GetMeanLatencyToLive (void) const;
+
+  /**
+   * @brief Get the number of live frames that arrived after their playout time.
+   * 
+   * @return the number of late frames
+   */
+  uint32_t GetLateFrames (void) const;
+
+  /**
+   * @brief Get the number of live frames skipped between the played ones,
+   * because they were late or did not arrive.
+   * 
+   * @return the number of skipped frames
+   */
+  uint32_t GetSkippedFrames (void) const;
+
+  /**
+   * @brief Get the monitor of the link of the node.
+   * 
+   * @return the LinkMonitor, null without link hints
+   */
+  Ptr<VideoStreamLinkMonitor> GetLinkMonitor (void) const;
+
+  /**
+   * @brief Get the number of level changes made on the link hints.
+   * 
+   * @return the number of levels lowered before the buffer ran dry
+   */
+  uint32_t GetLinkSwitchCount (void) const;
+
+  /**
+   * TracedCallback signature for the latency to live of a played frame.
+   * 
+   * @param [in] latency the time between the production and the playout of the frame
+   */
+  typedef void (* LatencyTracedCallback) (Time latency);
+
+  /**
+   * TracedCallback signature for the reorder depth of a packet.
+   * 
+   * @param [in] depth the distance to the highest sequence number received before the packet
+   */
+  typedef void (* ReorderTracedCallback) (uint32_t depth);
+
+  /**
+   * TracedCallback signature for the state of the link.
+   * 
+   * @param [in] snr the smoothed SNR in dB
+   * @param [in] phyRate the data rate of the mode of the last data frame
+   * @param [in] retryRate the smoothed retry rate
+   * @param [in] videoLevel the video level of the client
+   */
+  typedef void (* LinkStateTracedCallback) (double snr, DataRate phyRate, double retryRate, uint16_t videoLevel);
+
 protected:
   virtual void DoDispose (void);
 
@@ -57,6 +423,144 @@ private:
    */
   void Send (void);
 
+  /**
+   * @brief Send the HELLO again, or give up once MaxHelloRetries were sent.
+   */
+  void HelloTimeout (void);
+
+  /**
+   * @brief Stop repeating the HELLO once the server acknowledged the session
+   * or started sending frames.
+   */
+  void EstablishSession (void);
+
+  /**
+   * @brief Get the route to the server.
+   * 
+   * @param device the device the route must leave from, 0 for any
+   * @return the route, 0 without IPv4 server address or route
+   */
+  Ptr<Ipv4Route> GetServerRoute (Ptr<NetDevice> device) const;
+
+  /**
+   * @brief Open a subflow on every other interface with a route to the server.
+   */
+  void OpenSubflows (void);
+
+  /**
+   * @brief Send a JOIN on the paths the server has not accepted yet, and schedule the next ones.
+   */
+  void SendJoin (void);
+
+  /**
+   * @brief Send the path reports of the report interval on their paths.
+   * 
+   * @param duration the duration of the report interval
+   */
+  void SendPathReports (Time duration);
+
+  /**
+   * @brief Get the path a socket belongs to.
+   * 
+   * @param socket the socket
+   * @return the path index, 0 for the session socket
+   */
+  uint32_t GetPath (Ptr<Socket> socket) const;
+
+  /**
+   * @brief Fail over if nothing arrived for FailoverTimeout, or check again
+   * FailoverTimeout after the last packet.
+   */
+  void CheckDelivery (void);
+
+  /**
+   * @brief Open the session again with the next failover server, from the
+   * frame after the last complete one.
+   * 
+   * @return false if there is no server left
+   */
+  bool Failover (void);
+
+  /**
+   * @brief Tell the server the session ends.
+   */
+  void SendBye (void);
+
+  /**
+   * @brief Flush the buffer and move the session to a new position.
+   * 
+   * @param frame the frame to play from
+   * @param trickPlay whether the server sends the keyframes only
+   */
+  void StartSeek (uint32_t frame, bool trickPlay);
+
+  /**
+   * @brief Send a SEEK to the server, and repeat it until the first frame of
+   * the new position arrives; after MaxHelloRetries unanswered SEEK, give the
+   * seek up and play on from the position the server streams.
+   */
+  void SendSeek (void);
+
+  /**
+   * @brief Get the MTU of the device the route to the server leaves from.
+   * 
+   * @return the MTU, 0 if there is no IPv4 route to the server
+   */
+  uint16_t GetLinkMtu (void) const;
+
+  /**
+   * @brief Report the current video level to the server.
+   * 
+   * @param socket the socket to send the report with
+   * @param to the address of the server
+   */
+  void SendVideoLevel (Ptr<Socket> socket, const Address &to);
+
+  /**
+   * @brief Account for a received packet in the next receiver report.
+   * 
+   * @param header the header of the packet
+   * @param packetSize the size of the packet
+   */
+  void RecordReportSample (const VideoStreamHeader &header, uint32_t packetSize);
+
+  /**
+   * @brief Update the loss, reordering and delay accounting and the
+   * histograms with a received packet.
+   * 
+   * @param header the header of the packet
+   */
+  void RecordDelivery (const VideoStreamHeader &header);
+
+  /**
+   * @brief Send a receiver report to the server and start the next report interval.
+   */
+  void SendReport (void);
+
+  /**
+   * @brief Lower the video level when the link hints show the link can no
+   * longer carry it, and hold the upgrades the link could not carry.
+   */
+  void CheckLinkHints (void);
+
+  /**
+   * @brief Get the bitrate of a video level of the ladder of the server.
+   * 
+   * @param videoLevel the video level
+   * @return the bitrate in bits per second, 0 for a level outside the ladder
+   */
+  uint64_t GetLevelRate (uint16_t videoLevel) const;
+
+  /**
+   * @brief Record the state of the link at a level change, in the log and the event log.
+   */
+  void RecordLinkState (void);
+
+  /**
+   * @brief Record the duration of the current stall and end it.
+   */
+  void EndStall (void);
+
   /**
    * @brief Read data from the frame buffer. If the buffer does not have 
    * enough frames, it will reschedule the reading event next second.
@@ -65,6 +569,26 @@ private:
    */
   uint32_t ReadFromBuffer (void);
 
+  /**
+   * @brief Schedule the playout of a complete live frame, or skip it if it is late.
+   * 
+   * The playout delay adapts to the transit time of the frames: it covers the
+   * smallest transit time plus four times the transit jitter, capped by the
+   * target latency.
+   * 
+   * @param frame the frame number
+   * @param timestamp the production time of the frame
+   */
+  void ScheduleLiveFrame (uint32_t frame, Time timestamp);
+
+  /**
+   * @brief Play a live frame.
+   * 
+   * @param frame the frame number
+   * @param timestamp the production time of the frame
+   */
+  void PlayLiveFrame (uint32_t frame, Time timestamp);
+
   /**
    * @brief Handle a packet reception.
    * 
@@ -74,22 +598,161 @@ private:
    */
   void HandleRead (Ptr<Socket> socket);
 
+  /**
+   * @brief The state of each path of the session.
+   */
+  typedef struct PathInfo
+  {
+    Ptr<Socket> m_socket; //!< Socket of the path, the session socket for path 0
+    Ipv4Address m_local; //!< Local address of a subflow
+    bool m_joined; //!< Whether the server echoed the JOIN of the path
+    uint32_t m_joinAttempts; //!< Number of JOIN sent to the current server
+    uint64_t m_receivedBytes; //!< Bytes received on the path
+    uint32_t m_reportBytes; //!< Bytes received on the path in the report interval
+    uint32_t m_reportPackets; //!< Packets received on the path in the report interval
+    Time m_reportDelay; //!< Sum of the one-way delays of the packets of the report interval
+  } PathInfo;
+
   Ptr<Socket> m_socket; //!< Socket
   Address m_peerAddress; //!< Remote peer address
   uint16_t m_peerPort; //!< Remote peer port
 
   uint16_t m_initialDelay; //!< Seconds to wait before displaying the content
+  uint32_t m_startThreshold; //!< Frames buffered before the playback starts, 0 to wait for the initial delay
+  Time m_startTime; //!< Start of the client
+  bool m_firstFrameReceived; //!< Whether a complete frame was received
+  Time m_timeToFirstFrame; //!< Time from the start to the first complete frame
+  bool m_playbackStarted; //!< Whether a frame was played
+  Time m_startupDelay; //!< Time from the start to the first played frame
+  uint32_t m_seekFrame; //!< Frame of the last seek
+  bool m_trickPlay; //!< Whether the last seek asked for the keyframes only
+  bool m_seekPending; //!< Whether the first frame of the last seek is still awaited
+  bool m_seeking; //!< Whether the playback waits for the buffer to refill after a seek
+  Time m_seekStart; //!< Time of the last seek
+  uint32_t m_seekAttempts; //!< Number of SEEK sent for the last seek
+  uint32_t m_seekCount; //!< Number of seeks
+  uint32_t m_failedSeeks; //!< Number of seeks given up
+  VideoStreamHistogram m_seekLatency; //!< Seek latencies
   uint16_t m_stopCounter; //!< Counter to decide if the video streaming finishes
   uint16_t m_rebufferCounter; //!< Counter of the rebuffering event
   uint16_t m_videoLevel; //!< The quality of the video from the server
+  bool m_adaptive; //!< Whether the client changes the video level
+  uint32_t m_contentId; //!< ID of the requested title
   uint32_t m_frameRate; //!< Number of frames per second to be played
   uint32_t m_frameSize; //!< Total size of packets from one frame
   uint32_t m_lastRecvFrame; //!< Last received frame number
+  uint64_t m_recentFrames; //!< Frames counted among the 64 up to the last received one, bit i standing for i frames before it
   uint32_t m_lastBufferSize; //!< Last size of the buffer
   uint32_t m_currentBufferSize; //!< Size of the frame buffer
+  uint32_t m_receivedFrames; //!< Number of received frames
+  uint32_t m_stallCount; //!< Number of rebuffering events since the start
+
+  bool m_rejected; //!< Whether the server refused the session
+  bool m_redirected; //!< Whether a request router redirected the session
+  uint16_t m_maxVideoLevel; //!< Highest video level the client plays, 0 for any
+  uint16_t m_maxHeight; //!< Tallest rendition the client displays, 0 for any
+  VideoStreamLadder m_ladder; //!< Renditions of the server
+  uint16_t m_offeredLevel; //!< Highest video level the server offers
+  uint32_t m_bufferCapacity; //!< Frames the client buffers, 0 if unbounded
+  uint32_t m_startFrame; //!< Frame the playback starts from
+  Time m_helloTimeout; //!< Time before the first HELLO is repeated, 0 to never repeat it
+  uint32_t m_maxHelloRetries; //!< Number of times the HELLO is repeated
+  uint32_t m_helloAttempts; //!< Number of HELLO sent
+  Time m_firstHelloTime; //!< Time the first HELLO was sent
+  bool m_sessionAcked; //!< Whether the server acknowledged the session
+  Time m_handshakeTime; //!< Time from the first HELLO to the acknowledgement
+  std::vector<InetSocketAddress> m_failoverServers; //!< Servers the session fails over to, in order
+  uint32_t m_nextFailoverServer; //!< Index of the next failover server
+  Time m_failoverTimeout; //!< Time without packets after which the session fails over
+  Address m_activeServer; //!< Server the session failed over to, the packets of the others are dropped
+  uint32_t m_resumeFrame; //!< Frame the HELLO asks for
+  bool m_frameCompleted; //!< Whether the last fragment of a frame was received
+  uint32_t m_lastCompleteFrame; //!< Last frame whose last fragment was received
+  bool m_titleCompleted; //!< Whether a fragment of the last frame of the title was received
+  Time m_lastDeliveryTime; //!< Arrival of the last frame fragment, or start of the session
+  uint32_t m_sequenceOffset; //!< Added to the sequence numbers of the current server, which restart at each failover
+  uint32_t m_failovers; //!< Number of failovers
+  bool m_failoverPending; //!< Whether the first packet of the last failover is still awaited
+  Time m_failoverStart; //!< Last packet of the failed server
+  Time m_failoverEnd; //!< First packet of the next server
+  VideoStreamHistogram m_failoverGap; //!< Failover gaps
+  Time m_failoverStallTime; //!< Duration of the stalls started during a failover gap
+  bool m_multipath; //!< Whether the session opens a subflow on the other interfaces
+  std::vector<PathInfo> m_paths; //!< Paths of the session, the session socket first
+  Time m_firstPacketTime; //!< Arrival time of the first packet
+  bool m_live; //!< Whether the server streams live frames
+  Time m_targetLatency; //!< Largest latency to live the playout delay may reach
+  Time m_playoutDelay; //!< Delay between the production and the playout of a live frame
+  Time m_minTransit; //!< Smallest transit time of a live frame
+  Time m_lastTransit; //!< Transit time of the last complete live frame
+  Time m_jitter; //!< Smoothed transit jitter of the live frames
+  uint32_t m_completeLiveFrames; //!< Number of complete live frames
+  uint32_t m_playedFrames; //!< Number of played live frames
+  uint32_t m_lastPlayedFrame; //!< Number of the last played live frame
+  uint32_t m_onTimeFrames; //!< Live frames played since the last late one
+  uint32_t m_lateFrames; //!< Number of late live frames
+  uint32_t m_skippedFrames; //!< Number of live frames skipped between the played ones
+  Time m_latencyToLive; //!< Latency to live of the last played frame
+  Time m_latencySum; //!< Sum of the latencies to live of the played frames
+  Time m_linkHintInterval; //!< Time between two checks of the link hints
+  double m_linkEfficiency; //!< Share of the PHY rate the stream can use
+  Ptr<VideoStreamLinkMonitor> m_linkMonitor; //!< Monitor of the link of the node, null without link hints
+  uint32_t m_hintBytes; //!< Bytes received since the last check of the link hints
+  double m_throughputEstimate; //!< Smoothed throughput in bits per second, 0 before the first estimate
+  double m_lastHintSnr; //!< SNR at the last check of the link hints
+  bool m_linkLimited; //!< Whether the link could not carry the next level
+  uint32_t m_linkSwitches; //!< Number of levels lowered on the link hints
+
+  uint16_t m_receivedVideoLevel; //!< Video level of the last received frame
+  Time m_reportInterval; //!< Time between two receiver reports, zero to disable them
+  Time m_reportStart; //!< Start of the current report interval
+  uint32_t m_reportBytes; //!< Bytes received in the report interval
+  uint32_t m_reportPackets; //!< Packets received in the report interval
+  bool m_sequenceStarted; //!< Whether a sequence number was received
+  uint32_t m_expectedSequence; //!< First sequence number expected in the report interval
+  uint32_t m_highestSequence; //!< Highest sequence number received
+  Time m_packetTransit; //!< Transit time of the last packet
+  Time m_packetJitter; //!< Smoothed transit jitter of the packets
+  double m_trendSums[5]; //!< Count, sum of t, sum of d, sum of t*d and sum of t*t for the delay trend regression
+
+  PacketLossCounter m_lossCounter; //!< Lost packets detection
+  uint32_t m_firstSequence; //!< First sequence number received
+  uint32_t m_lastSequence; //!< Highest sequence number received
+  uint32_t m_deliveredPackets; //!< Number of received packets
+  TracedValue<uint32_t> m_lostPackets; //!< Number of lost packets
+  uint32_t m_reorderedPackets; //!< Number of reordered packets
+  uint32_t m_maxReorderDepth; //!< Largest reorder depth
+  Time m_oneWayDelay; //!< One-way delay of the last packet
+  Time m_delaySum; //!< Sum of the one-way delays of the packets
+  Time m_lastPacketTime; //!< Arrival time of the last packet
+  bool m_stalled; //!< Whether the playback from the buffer is stalled
+  Time m_stallStart; //!< Start of the current stall
+  VideoStreamHistogram m_frameLatency; //!< Frame completion latencies
+  VideoStreamHistogram m_fragmentGap; //!< Fragment inter-arrival times
+  VideoStreamHistogram m_stallDuration; //!< Stall durations
+
+  std::string m_eventLogFile; //!< Name of the binary event log, empty to disable it
+  uint32_t m_eventLogBufferSize; //!< Number of events buffered before they are written
+  VideoStreamEventLog m_eventLog; //!< Binary event log
 
   EventId m_bufferEvent; //!< Event to read from the buffer
   EventId m_sendEvent; //!< Event to send data to the server
+  EventId m_seekEvent; //!< Event to repeat the SEEK
+  EventId m_reportEvent; //!< Event to send the next receiver report
+  EventId m_deliveryEvent; //!< Event to check the delivery of the session
+  EventId m_joinEvent; //!< Event to repeat the JOIN of the paths
+  EventId m_linkEvent; //!< Event to check the link hints
+
+  /// Callbacks for tracing the packet Rx events
+  TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace;
+  /// Callbacks for tracing the latency to live of the played frames
+  TracedCallback<Time> m_latencyTrace;
+  /// Callbacks for tracing the reorder depth of the reordered packets
+  TracedCallback<uint32_t> m_reorderTrace;
+  /// Callbacks for tracing the one-way delay of the packets
+  TracedCallback<Time> m_delayTrace;
+  /// Callbacks for tracing the state of the link
+  TracedCallback<double, DataRate, double, uint16_t> m_linkStateTrace;
 
 };
 
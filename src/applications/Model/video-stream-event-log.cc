@@ -0,0 +1,247 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "video-stream-event-log.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamEventLog");
+
+static const char MAGIC[4] = {'V', 'S', 'E', 'L'};
+
+static const char *g_eventNames[VideoStreamEventLog::EVENT_TYPE_COUNT] = {
+  "SERVER_SESSION_START",
+  "SERVER_FRAME_SENT",
+  "SERVER_LEVEL_CHANGED",
+  "SERVER_SEND_ERROR",
+  "CLIENT_HELLO_SENT",
+  "CLIENT_FRAME_RECEIVED",
+  "CLIENT_PLAY",
+  "CLIENT_REBUFFER",
+  "CLIENT_LEVEL_CHANGED",
+  "CLIENT_LIVE_PLAY",
+  "CLIENT_LIVE_LATE",
+  "SERVER_SESSION_REJECTED",
+  "SERVER_SESSION_QUEUED",
+  "SERVER_SESSION_END",
+  "CLIENT_REJECTED",
+  "CLIENT_SESSION_ACKED",
+  "CLIENT_HELLO_TIMEOUT",
+  "CLIENT_SEEK",
+  "CLIENT_SEEK_RESUMED",
+  "SERVER_SEEK",
+  "CLIENT_REDIRECTED",
+  "CLIENT_FAILOVER",
+  "CLIENT_FAILOVER_RESUMED",
+  "CLIENT_SUBFLOW_JOINED",
+  "SERVER_SUBFLOW_JOINED",
+  "CLIENT_LINK_STATE",
+  "CLIENT_SEEK_FAILED",
+};
+
+/**
+ * @brief Write an unsigned integer in little-endian order.
+ *
+ * @param buffer the destination
+ * @param value the value
+ * @param size the number of bytes to write
+ */
+static void
+WriteLe (uint8_t *buffer, uint64_t value, uint32_t size)
+{
+  for (uint32_t i = 0; i < size; i++)
+  {
+    buffer[i] = (value >> (8 * i)) & 0xff;
+  }
+}
+
+/**
+ * @brief Read an unsigned integer stored in little-endian order.
+ *
+ * @param buffer the source
+ * @param size the number of bytes to read
+ * @return the value
+ */
+static uint64_t
+ReadLe (const uint8_t *buffer, uint32_t size)
+{
+  uint64_t value = 0;
+  for (uint32_t i = 0; i < size; i++)
+  {
+    value |= static_cast<uint64_t> (buffer[i]) << (8 * i);
+  }
+  return value;
+}
+
+VideoStreamEventLog::VideoStreamEventLog ()
+  : m_file (0),
+    m_node (0),
+    m_count (0)
+{
+}
+
+VideoStreamEventLog::~VideoStreamEventLog ()
+{
+  Close ();
+}
+
+std::map<std::string, VideoStreamEventLog::SharedFile *> &
+VideoStreamEventLog::GetFiles (void)
+{
+  static std::map<std::string, SharedFile *> files;
+  return files;
+}
+
+void
+VideoStreamEventLog::Open (std::string fileName, uint32_t bufferSize, uint32_t node)
+{
+  NS_LOG_FUNCTION (this << fileName << bufferSize << node);
+
+  Close ();
+  if (fileName.empty ())
+  {
+    return;
+  }
+
+  std::map<std::string, SharedFile *> &files = GetFiles ();
+  auto iter = files.find (fileName);
+  if (iter == files.end ())
+  {
+    SharedFile *file = new SharedFile ();
+    file->m_users = 0;
+    file->m_stream.open (fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file->m_stream.is_open ())
+    {
+      delete file;
+      NS_FATAL_ERROR ("Could not open " << fileName);
+    }
+    uint8_t header[HEADER_SIZE] = {0};
+    std::copy (MAGIC, MAGIC + 4, header);
+    WriteLe (header + 4, VERSION, 2);
+    WriteLe (header + 6, RECORD_SIZE, 2);
+    file->m_stream.write (reinterpret_cast<const char *> (header), HEADER_SIZE);
+    iter = files.insert (std::make_pair (fileName, file)).first;
+  }
+
+  m_fileName = fileName;
+  m_file = iter->second;
+  m_file->m_users++;
+  m_node = node;
+  m_buffer.resize (std::max<uint32_t> (bufferSize, 1));
+  m_count = 0;
+}
+
+void
+VideoStreamEventLog::Close (void)
+{
+  if (m_file == 0)
+  {
+    return;
+  }
+  NS_LOG_FUNCTION (this);
+
+  Flush ();
+  if (--m_file->m_users == 0)
+  {
+    m_file->m_stream.close ();
+    delete m_file;
+    GetFiles ().erase (m_fileName);
+  }
+  m_file = 0;
+  m_buffer.clear ();
+  m_buffer.shrink_to_fit ();
+}
+
+void
+VideoStreamEventLog::Flush (void)
+{
+  if (m_file == 0 || m_count == 0)
+  {
+    return;
+  }
+  NS_LOG_FUNCTION (this << m_count);
+
+  std::vector<uint8_t> data (m_count * RECORD_SIZE, 0);
+  uint8_t *out = data.data ();
+  for (uint32_t i = 0; i < m_count; i++, out += RECORD_SIZE)
+  {
+    const Record &record = m_buffer[i];
+    WriteLe (out, static_cast<uint64_t> (record.m_time), 8);
+    WriteLe (out + 8, record.m_node, 4);
+    WriteLe (out + 12, record.m_session, 4);
+    WriteLe (out + 16, record.m_frame, 4);
+    WriteLe (out + 20, record.m_bytes, 4);
+    WriteLe (out + 24, record.m_type, 2);
+    WriteLe (out + 26, record.m_level, 2);
+  }
+  m_file->m_stream.write (reinterpret_cast<const char *> (data.data ()), data.size ());
+  m_count = 0;
+}
+
+const char *
+VideoStreamEventLog::GetEventName (uint16_t type)
+{
+  if (type >= EVENT_TYPE_COUNT)
+  {
+    return "UNKNOWN";
+  }
+  return g_eventNames[type];
+}
+
+bool
+VideoStreamEventLog::Decode (std::istream &in, std::ostream &out, bool csv)
+{
+  uint8_t header[HEADER_SIZE];
+  if (!in.read (reinterpret_cast<char *> (header), HEADER_SIZE) ||
+      !std::equal (MAGIC, MAGIC + 4, header) ||
+      ReadLe (header + 4, 2) != VERSION)
+  {
+    return false;
+  }
+  uint32_t recordSize = ReadLe (header + 6, 2);
+  if (recordSize < RECORD_SIZE)
+  {
+    return false;
+  }
+
+  if (csv)
+  {
+    out << "Time(s),Node,Session,Event,Frame,Bytes,Level\n";
+  }
+  std::vector<uint8_t> data (recordSize);
+  while (in.read (reinterpret_cast<char *> (data.data ()), recordSize))
+  {
+    const uint8_t *record = data.data ();
+    double time = static_cast<int64_t> (ReadLe (record, 8)) / 1e9;
+    uint64_t node = ReadLe (record + 8, 4);
+    uint64_t session = ReadLe (record + 12, 4);
+    uint64_t frame = ReadLe (record + 16, 4);
+    uint64_t bytes = ReadLe (record + 20, 4);
+    const char *name = GetEventName (ReadLe (record + 24, 2));
+    uint64_t level = ReadLe (record + 26, 2);
+    if (csv)
+    {
+      out << time << "," << node << "," << session << "," << name << ","
+          << frame << "," << bytes << "," << level << "\n";
+    }
+    else
+    {
+      out << std::fixed << std::setprecision (6) << std::setw (12) << time << "s"
+          << " node " << std::setw (5) << node
+          << " session " << std::setw (5) << session
+          << " " << std::left << std::setw (24) << name << std::right
+          << " frame " << std::setw (7) << frame
+          << " bytes " << std::setw (9) << bytes
+          << " level " << level << "\n";
+      out.unsetf (std::ios::floatfield);
+    }
+  }
+  // a trailing partial record means the log was truncated
+  return in.gcount () == 0;
+}
+
+} // namespace ns3
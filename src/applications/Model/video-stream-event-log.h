@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_EVENT_LOG_H
+#define VIDEO_STREAM_EVENT_LOG_H
+
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+
+#include <fstream>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @brief Compact binary recorder of video stream events.
+ *
+ * Each application owns one recorder. Events are stored as fixed-size
+ * records in a preallocated buffer that is written to the log file in one
+ * batch whenever it becomes full and when the recorder is closed, so
+ * nothing is formatted while the simulation runs. Recorders opened on the
+ * same file name share one output stream.
+ *
+ * The file starts with a 16-byte header ("VSEL", version, record size)
+ * followed by 32-byte little-endian records. Decode () turns a log back
+ * into text or CSV.
+ */
+class VideoStreamEventLog
+{
+public:
+  /**
+   * @brief Type of a recorded event.
+   */
+  enum EventType
+  {
+    SERVER_SESSION_START = 0, //!< The server accepted a client, the frame field holds the content ID
+    SERVER_FRAME_SENT = 1, //!< The server sent all the fragments of a frame
+    SERVER_LEVEL_CHANGED = 2, //!< The server received a new video level
+    SERVER_SEND_ERROR = 3, //!< The socket refused a fragment
+    CLIENT_HELLO_SENT = 4, //!< The client sent a HELLO, the frame field holds the attempt
+    CLIENT_FRAME_RECEIVED = 5, //!< The client received the last fragment of a frame
+    CLIENT_PLAY = 6, //!< The client played one second of video
+    CLIENT_REBUFFER = 7, //!< The client did not have enough frames to play
+    CLIENT_LEVEL_CHANGED = 8, //!< The client changed its video level
+    CLIENT_LIVE_PLAY = 9, //!< The client played a live frame, the bytes field holds the latency to live in microseconds
+    CLIENT_LIVE_LATE = 10, //!< A live frame arrived after its playout time and was skipped
+    SERVER_SESSION_REJECTED = 11, //!< The server refused a client, the frame field holds the content ID
+    SERVER_SESSION_QUEUED = 12, //!< The server queued a client until a session ends, the frame field holds the content ID
+    SERVER_SESSION_END = 13, //!< The server sent the last frame of a session or received a BYE
+    CLIENT_REJECTED = 14, //!< The server refused the session of the client
+    CLIENT_SESSION_ACKED = 15, //!< The server acknowledged the session, the bytes field holds the handshake time in microseconds
+    CLIENT_HELLO_TIMEOUT = 16, //!< The client stopped repeating an unacknowledged HELLO
+    CLIENT_SEEK = 17, //!< The client flushed its buffer and sent a SEEK, the frame field holds the target
+    CLIENT_SEEK_RESUMED = 18, //!< The client played again after a seek, the bytes field holds the seek latency in microseconds
+    SERVER_SEEK = 19, //!< The server moved a session, the frame field holds the keyframe it resumes from
+    CLIENT_REDIRECTED = 20, //!< The request router redirected the client, the bytes field holds the port of the server
+    CLIENT_FAILOVER = 21, //!< The client moved to the next failover server, the frame field holds the frame it resumes from
+    CLIENT_FAILOVER_RESUMED = 22, //!< The next server sent its first packet, the bytes field holds the failover gap in microseconds
+    CLIENT_SUBFLOW_JOINED = 23, //!< The server echoed the JOIN of a path, the frame field holds the path index
+    SERVER_SUBFLOW_JOINED = 24, //!< A path joined a session, the bytes field holds the path index
+    CLIENT_LINK_STATE = 25, //!< The link of the LinkMonitor at a level change, the frame field holds the SNR in hundredths of dB, the bytes field the PHY rate in kbps
+    CLIENT_SEEK_FAILED = 26, //!< The client gave up an unanswered seek, the frame field holds the target, the bytes field the SEEK sent
+    EVENT_TYPE_COUNT //!< Number of event types
+  };
+
+  /**
+   * @brief One recorded event.
+   */
+  typedef struct Record
+  {
+    int64_t m_time; //!< Simulation time in nanoseconds
+    uint32_t m_node; //!< ID of the node running the application
+    uint32_t m_session; //!< Session index within the application
+    uint32_t m_frame; //!< Frame number
+    uint32_t m_bytes; //!< Number of bytes
+    uint16_t m_type; //!< EventType
+    uint16_t m_level; //!< Video level
+  } Record;
+
+  static const uint32_t HEADER_SIZE = 16; //!< Size of the file header in bytes
+  static const uint32_t RECORD_SIZE = 32; //!< Size of a record in bytes
+  static const uint16_t VERSION = 1; //!< Version of the file format
+
+  VideoStreamEventLog ();
+
+  ~VideoStreamEventLog ();
+
+  /**
+   * @brief Start recording to a file.
+   *
+   * An empty file name leaves the recorder disabled.
+   *
+   * @param fileName the name of the log file
+   * @param bufferSize the number of records held before they are written
+   * @param node the ID of the node running the application
+   */
+  void Open (std::string fileName, uint32_t bufferSize, uint32_t node);
+
+  /**
+   * @brief Write the buffered records and release the file.
+   */
+  void Close (void);
+
+  /**
+   * @brief Write the buffered records to the file.
+   */
+  void Flush (void);
+
+  /**
+   * @brief Whether the recorder writes to a file.
+   *
+   * @return true if events are recorded
+   */
+  bool IsEnabled (void) const
+  {
+    return m_file != 0;
+  }
+
+  /**
+   * @brief Record an event at the current simulation time.
+   *
+   * @param type the event type
+   * @param session the session index
+   * @param frame the frame number
+   * @param bytes the number of bytes
+   * @param level the video level
+   */
+  void Add (EventType type, uint32_t session, uint32_t frame, uint32_t bytes, uint16_t level)
+  {
+    if (m_file == 0)
+    {
+      return;
+    }
+    if (m_count == m_buffer.size ())
+    {
+      Flush ();
+    }
+    Record &record = m_buffer[m_count++];
+    record.m_time = Simulator::Now ().GetNanoSeconds ();
+    record.m_node = m_node;
+    record.m_session = session;
+    record.m_frame = frame;
+    record.m_bytes = bytes;
+    record.m_type = type;
+    record.m_level = level;
+  }
+
+  /**
+   * @brief Get the name of an event type.
+   *
+   * @param type the event type
+   * @return the name, or "UNKNOWN"
+   */
+  static const char *GetEventName (uint16_t type);
+
+  /**
+   * @brief Convert a binary log to text or CSV.
+   *
+   * @param in the binary log
+   * @param out the output stream
+   * @param csv whether to write CSV instead of aligned text
+   * @return false if the input is not a valid log
+   */
+  static bool Decode (std::istream &in, std::ostream &out, bool csv);
+
+private:
+  /**
+   * @brief An output file shared by the recorders that opened it.
+   */
+  typedef struct SharedFile
+  {
+    std::ofstream m_stream; //!< Output stream
+    uint32_t m_users; //!< Number of open recorders
+  } SharedFile;
+
+  /**
+   * @brief Get the files currently open, indexed by name.
+   *
+   * @return the registry of open files
+   */
+  static std::map<std::string, SharedFile *> &GetFiles (void);
+
+  std::string m_fileName; //!< Name of the log file
+  SharedFile *m_file; //!< Log file, 0 when disabled
+  uint32_t m_node; //!< ID of the node running the application
+  std::vector<Record> m_buffer; //!< Buffered records
+  uint32_t m_count; //!< Number of buffered records
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_EVENT_LOG_H */
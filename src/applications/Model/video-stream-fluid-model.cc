@@ -0,0 +1,548 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+#include "ns3/socket.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "video-stream-client.h"
+#include "video-stream-fluid-model.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamFluidModel");
+
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamFluidModel);
+
+// Longest route followed from a server to a viewer
+static const uint32_t MAX_HOPS = 64;
+
+// Rates and buffers closer than this are equal
+static const double EPSILON = 1e-9;
+
+TypeId
+VideoStreamFluidModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamFluidModel")
+    .SetParent<Object> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamFluidModel> ()
+    .AddAttribute ("Step", "The time between two allocations of the rates",
+                    TimeValue (MilliSeconds (100)),
+                    MakeTimeAccessor (&VideoStreamFluidModel::m_step),
+                    MakeTimeChecker (MilliSeconds (1)))
+    .AddAttribute ("BitRate", "The bitrate of video level 1; level n is n times larger, as with the default ladder of the server",
+                    DataRateValue (DataRate ("2Mbps")),
+                    MakeDataRateAccessor (&VideoStreamFluidModel::m_bitRate),
+                    MakeDataRateChecker ())
+    .AddAttribute ("VideoLevel", "The video level of the fluid sessions",
+                    UintegerValue (3),
+                    MakeUintegerAccessor (&VideoStreamFluidModel::m_videoLevel),
+                    MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("InitialDelay", "The time from the arrival of a session to its first playback, at the earliest",
+                    TimeValue (Seconds (3.0)),
+                    MakeTimeAccessor (&VideoStreamFluidModel::m_initialDelay),
+                    MakeTimeChecker ())
+    .AddAttribute ("ResumeThreshold", "The video buffered before the playback starts or resumes",
+                    TimeValue (Seconds (1.0)),
+                    MakeTimeAccessor (&VideoStreamFluidModel::m_resumeThreshold),
+                    MakeTimeChecker ())
+    .AddAttribute ("TitleDuration", "The length of the title, 0 for sessions streaming until their end",
+                    TimeValue (Seconds (0.0)),
+                    MakeTimeAccessor (&VideoStreamFluidModel::m_titleDuration),
+                    MakeTimeChecker ())
+    .AddAttribute ("DefaultCapacity", "The capacity of the devices without a DataRate attribute",
+                    DataRateValue (DataRate ("1Gbps")),
+                    MakeDataRateAccessor (&VideoStreamFluidModel::m_defaultCapacity),
+                    MakeDataRateChecker ())
+    .AddAttribute ("MinResidualShare", "The smallest share of the capacity of a link left to the packets",
+                    DoubleValue (0.01),
+                    MakeDoubleAccessor (&VideoStreamFluidModel::m_minResidualShare),
+                    MakeDoubleChecker<double> (0.0, 1.0))
+  ;
+  return tid;
+}
+
+VideoStreamFluidModel::VideoStreamFluidModel ()
+  : m_activeSessions (0),
+    m_fluidSessions (0),
+    m_unroutedSessions (0),
+    m_stallCount (0),
+    m_deliveredBytes (0.0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VideoStreamFluidModel::~VideoStreamFluidModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+VideoStreamFluidModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_stepEvent);
+  for (Link &link : m_links)
+  {
+    link.m_fluidRate = 0;
+    ApplyCapacity (link);
+  }
+  m_links.clear ();
+  m_linkIndex.clear ();
+  m_sessions.clear ();
+  m_serverNodes.clear ();
+  Object::DoDispose ();
+}
+
+void
+VideoStreamFluidModel::AddFluidSession (Ptr<Node> client, Address server, Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << client << start << stop);
+  Session session;
+  session.m_node = client;
+  session.m_server = Ipv4Address::IsMatchingType (server) ? Ipv4Address::ConvertFrom (server) : InetSocketAddress::ConvertFrom (server).GetIpv4 ();
+  session.m_start = start;
+  session.m_stop = stop;
+  session.m_active = false;
+  session.m_demand = 0;
+  session.m_rate = 0;
+  session.m_buffer = 0;
+  session.m_received = 0;
+  session.m_playing = false;
+  session.m_started = false;
+  session.m_stallStart = 0;
+  m_sessions.push_back (session);
+  m_fluidSessions++;
+
+  uint32_t index = m_sessions.size () - 1;
+  Simulator::Schedule (start - Simulator::Now (), &VideoStreamFluidModel::StartSession, this, index);
+  Simulator::Schedule (stop - Simulator::Now (), &VideoStreamFluidModel::StopSession, this, index);
+}
+
+void
+VideoStreamFluidModel::AddPacketSession (Ptr<VideoStreamClient> client, Address server, Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << client << start << stop);
+  AddFluidSession (client->GetNode (), server, start, stop);
+  m_sessions.back ().m_client = client;
+  m_fluidSessions--;
+}
+
+uint32_t
+VideoStreamFluidModel::GetFluidSessions (void) const
+{
+  return m_fluidSessions;
+}
+
+uint32_t
+VideoStreamFluidModel::GetUnroutedSessions (void) const
+{
+  return m_unroutedSessions;
+}
+
+uint32_t
+VideoStreamFluidModel::GetStallCount (void) const
+{
+  return m_stallCount;
+}
+
+uint64_t
+VideoStreamFluidModel::GetDeliveredBytes (void) const
+{
+  return static_cast<uint64_t> (m_deliveredBytes);
+}
+
+const VideoStreamHistogram &
+VideoStreamFluidModel::GetStartupDelayHistogram (void) const
+{
+  return m_startupDelay;
+}
+
+const VideoStreamHistogram &
+VideoStreamFluidModel::GetStallHistogram (void) const
+{
+  return m_stallDuration;
+}
+
+void
+VideoStreamFluidModel::StartSession (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  Session &session = m_sessions[index];
+  if (!FindPath (session))
+  {
+    NS_LOG_WARN ("No route from " << session.m_server << " to node " << session.m_node->GetId ());
+    if (session.m_client == 0)
+    {
+      m_unroutedSessions++;
+    }
+    return;
+  }
+  session.m_active = true;
+  m_activeSessions++;
+
+  // the rates are allocated at the next step, which starts now if the model was idle
+  if (m_stepEvent.IsExpired ())
+  {
+    m_lastStep = Simulator::Now ();
+    m_stepEvent = Simulator::ScheduleNow (&VideoStreamFluidModel::Step, this);
+  }
+}
+
+void
+VideoStreamFluidModel::StopSession (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  Session &session = m_sessions[index];
+  if (!session.m_active)
+  {
+    return;
+  }
+  if (session.m_client == 0)
+  {
+    Advance (session, m_lastStep.GetSeconds (), Simulator::Now ().GetSeconds ());
+    if (!session.m_active)
+    {
+      return;
+    }
+  }
+  session.m_active = false;
+  session.m_rate = 0;
+  m_activeSessions--;
+}
+
+void
+VideoStreamFluidModel::Step (void)
+{
+  NS_LOG_FUNCTION (this);
+  double from = m_lastStep.GetSeconds ();
+  double to = Simulator::Now ().GetSeconds ();
+  for (Session &session : m_sessions)
+  {
+    if (session.m_active && session.m_client == 0)
+    {
+      Advance (session, from, to);
+    }
+  }
+  m_lastStep = Simulator::Now ();
+
+  Allocate ();
+  if (m_activeSessions > 0)
+  {
+    m_stepEvent = Simulator::Schedule (m_step, &VideoStreamFluidModel::Step, this);
+  }
+}
+
+void
+VideoStreamFluidModel::Advance (Session &session, double from, double to)
+{
+  double bitRate = m_bitRate.GetBitRate () * static_cast<double> (m_videoLevel);
+  if (to <= from || bitRate <= 0)
+  {
+    return;
+  }
+
+  // seconds of video received per second, constant over the step
+  double fill = session.m_rate / bitRate;
+  double title = m_titleDuration.GetSeconds ();
+  double received = session.m_received;
+  if (title > 0)
+  {
+    fill = std::min (fill, std::max (0.0, title - received) / (to - from));
+  }
+  session.m_received += fill * (to - from);
+  m_deliveredBytes += fill * (to - from) * bitRate / 8;
+
+  double threshold = m_resumeThreshold.GetSeconds ();
+  double t = from;
+  while (t < to)
+  {
+    if (session.m_playing)
+    {
+      double net = fill - 1;
+      double empty = net < 0 ? t + session.m_buffer / -net : to;
+      if (empty >= to)
+      {
+        session.m_buffer = std::max (0.0, session.m_buffer + net * (to - t));
+        t = to;
+      }
+      else
+      {
+        session.m_buffer = 0;
+        session.m_playing = false;
+        t = empty;
+        if (title > 0 && received + fill * (t - from) >= title - EPSILON)
+        {
+          // the title has been played to its end
+          session.m_active = false;
+          session.m_rate = 0;
+          m_activeSessions--;
+          return;
+        }
+        session.m_stallStart = t;
+        m_stallCount++;
+      }
+    }
+    else
+    {
+      // the end of a title shorter than the threshold plays once it is received
+      double missing = threshold - session.m_buffer;
+      if (title > 0)
+      {
+        missing = std::min (missing, title - received - fill * (t - from));
+      }
+      double ready = missing <= EPSILON ? t : (fill > 0 ? t + missing / fill : to);
+      if (!session.m_started)
+      {
+        ready = std::max (ready, (session.m_start + m_initialDelay).GetSeconds ());
+      }
+      if (ready >= to)
+      {
+        session.m_buffer += fill * (to - t);
+        t = to;
+      }
+      else
+      {
+        session.m_buffer += fill * (ready - t);
+        session.m_playing = true;
+        t = ready;
+        if (!session.m_started)
+        {
+          session.m_started = true;
+          m_startupDelay.Record (Seconds (ready) - session.m_start);
+        }
+        else
+        {
+          m_stallDuration.Record (Seconds (ready - session.m_stallStart));
+        }
+      }
+    }
+  }
+}
+
+void
+VideoStreamFluidModel::Allocate (void)
+{
+  // progressive filling: the growing sessions all gain the same rate until
+  // one reaches its bitrate or crosses a link with no capacity left
+  for (Link &link : m_links)
+  {
+    link.m_residual = link.m_capacity;
+    link.m_unfrozen = 0;
+  }
+  double title = m_titleDuration.GetSeconds ();
+  std::vector<uint32_t> growing;
+  for (uint32_t i = 0; i < m_sessions.size (); i++)
+  {
+    Session &session = m_sessions[i];
+    session.m_rate = 0;
+    if (!session.m_active)
+    {
+      continue;
+    }
+    uint16_t level = session.m_client == 0 ? m_videoLevel : session.m_client->GetVideoLevel ();
+    session.m_demand = m_bitRate.GetBitRate () * static_cast<double> (level);
+    if (session.m_client == 0 && title > 0 && session.m_received >= title - EPSILON)
+    {
+      // the whole title has been received
+      session.m_demand = 0;
+    }
+    for (uint32_t link : session.m_path)
+    {
+      m_links[link].m_unfrozen++;
+    }
+    growing.push_back (i);
+  }
+
+  while (!growing.empty ())
+  {
+    double increment = std::numeric_limits<double>::max ();
+    for (const Link &link : m_links)
+    {
+      if (link.m_unfrozen > 0)
+      {
+        increment = std::min (increment, link.m_residual / link.m_unfrozen);
+      }
+    }
+    for (uint32_t i : growing)
+    {
+      increment = std::min (increment, m_sessions[i].m_demand - m_sessions[i].m_rate);
+    }
+    for (uint32_t i : growing)
+    {
+      m_sessions[i].m_rate += increment;
+    }
+    for (Link &link : m_links)
+    {
+      link.m_residual = std::max (0.0, link.m_residual - increment * link.m_unfrozen);
+    }
+
+    // each round stops at least one session
+    std::vector<uint32_t> stillGrowing;
+    for (uint32_t i : growing)
+    {
+      Session &session = m_sessions[i];
+      bool saturated = session.m_rate >= session.m_demand - EPSILON;
+      for (uint32_t link : session.m_path)
+      {
+        saturated = saturated || m_links[link].m_residual <= EPSILON * m_links[link].m_capacity;
+      }
+      if (!saturated)
+      {
+        stillGrowing.push_back (i);
+        continue;
+      }
+      for (uint32_t link : session.m_path)
+      {
+        m_links[link].m_unfrozen--;
+      }
+    }
+    growing.swap (stillGrowing);
+  }
+
+  for (Link &link : m_links)
+  {
+    link.m_fluidRate = 0;
+  }
+  for (const Session &session : m_sessions)
+  {
+    if (session.m_active && session.m_client == 0)
+    {
+      for (uint32_t link : session.m_path)
+      {
+        m_links[link].m_fluidRate += session.m_rate;
+      }
+    }
+  }
+  for (Link &link : m_links)
+  {
+    ApplyCapacity (link);
+  }
+}
+
+void
+VideoStreamFluidModel::ApplyCapacity (Link &link)
+{
+  if (!link.m_adjustable)
+  {
+    return;
+  }
+  uint64_t left = static_cast<uint64_t> (std::max (link.m_capacity - link.m_fluidRate, link.m_capacity * m_minResidualShare));
+  if (left != link.m_dataRate)
+  {
+    link.m_dataRate = left;
+    link.m_device->SetAttribute ("DataRate", DataRateValue (DataRate (left)));
+  }
+}
+
+bool
+VideoStreamFluidModel::FindPath (Session &session)
+{
+  session.m_path.clear ();
+  Ptr<Node> node = GetNodeOf (session.m_server);
+  Ptr<Ipv4> clientIpv4 = session.m_node->GetObject<Ipv4> ();
+  if (node == 0 || clientIpv4 == 0 || clientIpv4->GetNInterfaces () < 2)
+  {
+    return false;
+  }
+  // interface 0 is the loopback
+  Ipv4Address destination = clientIpv4->GetAddress (1, 0).GetLocal ();
+
+  for (uint32_t hop = 0; hop < MAX_HOPS && node != session.m_node; hop++)
+  {
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+    if (ipv4 == 0 || ipv4->GetRoutingProtocol () == 0)
+    {
+      return false;
+    }
+    Ipv4Header header;
+    header.SetDestination (destination);
+    Socket::SocketErrno error;
+    Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol ()->RouteOutput (0, header, 0, error);
+    if (route == 0 || route->GetOutputDevice () == 0 || route->GetOutputDevice ()->GetChannel () == 0)
+    {
+      return false;
+    }
+    Ptr<NetDevice> device = route->GetOutputDevice ();
+    session.m_path.push_back (GetLink (device));
+
+    // the next node is the one on the channel owning the next hop
+    Ipv4Address nextHop = route->GetGateway () == Ipv4Address::GetAny () ? destination : route->GetGateway ();
+    Ptr<Channel> channel = device->GetChannel ();
+    Ptr<Node> next;
+    for (std::size_t i = 0; i < channel->GetNDevices () && next == 0; i++)
+    {
+      Ptr<NetDevice> peer = channel->GetDevice (i);
+      Ptr<Ipv4> peerIpv4 = peer->GetNode ()->GetObject<Ipv4> ();
+      if (peer != device && peerIpv4 != 0 && peerIpv4->GetInterfaceForAddress (nextHop) >= 0)
+      {
+        next = peer->GetNode ();
+      }
+    }
+    if (next == 0)
+    {
+      return false;
+    }
+    node = next;
+  }
+  return node == session.m_node;
+}
+
+uint32_t
+VideoStreamFluidModel::GetLink (Ptr<NetDevice> device)
+{
+  std::map<Ptr<NetDevice>, uint32_t>::iterator it = m_linkIndex.find (device);
+  if (it != m_linkIndex.end ())
+  {
+    return it->second;
+  }
+  Link link;
+  link.m_device = device;
+  DataRateValue rate;
+  link.m_adjustable = device->GetAttributeFailSafe ("DataRate", rate);
+  link.m_capacity = link.m_adjustable ? rate.Get ().GetBitRate () : m_defaultCapacity.GetBitRate ();
+  link.m_fluidRate = 0;
+  link.m_dataRate = static_cast<uint64_t> (link.m_capacity);
+  link.m_residual = 0;
+  link.m_unfrozen = 0;
+  m_links.push_back (link);
+  m_linkIndex[device] = m_links.size () - 1;
+  NS_LOG_INFO ("Link " << m_links.size () - 1 << " of node " << device->GetNode ()->GetId () << " with capacity " << link.m_capacity << " bit/s");
+  return m_links.size () - 1;
+}
+
+Ptr<Node>
+VideoStreamFluidModel::GetNodeOf (Ipv4Address address)
+{
+  std::map<Ipv4Address, Ptr<Node> >::iterator it = m_serverNodes.find (address);
+  if (it != m_serverNodes.end ())
+  {
+    return it->second;
+  }
+  Ptr<Node> owner;
+  for (NodeList::Iterator node = NodeList::Begin (); node != NodeList::End () && owner == 0; node++)
+  {
+    Ptr<Ipv4> ipv4 = (*node)->GetObject<Ipv4> ();
+    if (ipv4 != 0 && ipv4->GetInterfaceForAddress (address) >= 0)
+    {
+      owner = *node;
+    }
+  }
+  m_serverNodes[address] = owner;
+  return owner;
+}
+
+} // namespace ns3
@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_FLUID_MODEL_H
+#define VIDEO_STREAM_FLUID_MODEL_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "video-stream-histogram.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+class Node;
+class NetDevice;
+class VideoStreamClient;
+
+/**
+ * @brief Fluid model of video sessions sharing the links of a topology.
+ *
+ * Fluid sessions exchange no packets: every Step, the model gives each
+ * active session a rate, the max-min fair share of the links on its route
+ * from the server, capped by the bitrate of its video level. Between two
+ * steps the rates are constant, so the playback buffer of a session is
+ * integrated exactly: it fills at the rate over the bitrate, drains at one
+ * second per second while playing, stalls when it empties and plays again
+ * once it holds ResumeThreshold, like the client does.
+ *
+ * Packet sessions are VideoStreamClient applications running over the same
+ * topology. They take part in the max-min allocation with the bitrate of
+ * their current video level, and the data rate of each link is lowered by
+ * the rate given to the fluid sessions, so the packets see the capacity
+ * left by the fluid traffic. Only point-to-point style devices with a
+ * DataRate attribute carry fluid traffic; the capacity of other devices is
+ * DefaultCapacity and is never lowered.
+ *
+ * Routes are found with the routing protocols of the nodes when a session
+ * starts, from the server to the first address of the client node, so the
+ * routing tables must be populated by then. A session starts being served
+ * at the first step after its arrival, so Step bounds the precision of the
+ * startup delays.
+ */
+class VideoStreamFluidModel : public Object
+{
+public:
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VideoStreamFluidModel ();
+
+  virtual ~VideoStreamFluidModel ();
+
+  /**
+   * @brief Add a session simulated by the fluid model.
+   *
+   * @param client the node of the viewer
+   * @param server the address of the server
+   * @param start the arrival of the session
+   * @param stop the end of the session
+   */
+  void AddFluidSession (Ptr<Node> client, Address server, Time start, Time stop);
+
+  /**
+   * @brief Add a packet-level session that shares the links with the fluid sessions.
+   *
+   * @param client the client application
+   * @param server the address of the server
+   * @param start the start of the application
+   * @param stop the stop of the application
+   */
+  void AddPacketSession (Ptr<VideoStreamClient> client, Address server, Time start, Time stop);
+
+  /**
+   * @brief Get the number of fluid sessions.
+   *
+   * @return the number of sessions added with AddFluidSession
+   */
+  uint32_t GetFluidSessions (void) const;
+
+  /**
+   * @brief Get the number of fluid sessions without a route to their server.
+   *
+   * @return the number of sessions that were never served
+   */
+  uint32_t GetUnroutedSessions (void) const;
+
+  /**
+   * @brief Get the number of stalls of the fluid sessions.
+   *
+   * @return the number of times a playing buffer emptied
+   */
+  uint32_t GetStallCount (void) const;
+
+  /**
+   * @brief Get the bytes delivered to the fluid sessions.
+   *
+   * @return the number of bytes
+   */
+  uint64_t GetDeliveredBytes (void) const;
+
+  /**
+   * @brief Get the time from the arrival to the start of the playback of the fluid sessions.
+   *
+   * @return the histogram of the startup delays
+   */
+  const VideoStreamHistogram &GetStartupDelayHistogram (void) const;
+
+  /**
+   * @brief Get the duration of the stalls of the fluid sessions.
+   *
+   * @return the histogram of the stall durations
+   */
+  const VideoStreamHistogram &GetStallHistogram (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * @brief A link, identified by the device sending on it.
+   */
+  struct Link
+  {
+    Ptr<NetDevice> m_device; //!< Device sending on the link
+    double m_capacity; //!< Data rate of the device in bit/s
+    double m_fluidRate; //!< Rate given to the fluid sessions in bit/s
+    bool m_adjustable; //!< Whether the device has a DataRate attribute
+    uint64_t m_dataRate; //!< Data rate last set on the device in bit/s
+    double m_residual; //!< Capacity not allocated yet, during an allocation
+    uint32_t m_unfrozen; //!< Sessions whose rate can still grow, during an allocation
+  };
+
+  /**
+   * @brief A fluid or packet session.
+   */
+  struct Session
+  {
+    Ptr<Node> m_node; //!< Node of the viewer
+    Ptr<VideoStreamClient> m_client; //!< Client application, null for a fluid session
+    Ipv4Address m_server; //!< Address of the server
+    Time m_start; //!< Arrival
+    Time m_stop; //!< End
+    std::vector<uint32_t> m_path; //!< Links from the server to the viewer
+    bool m_active; //!< Whether the session is served
+    double m_demand; //!< Bitrate of the session in bit/s
+    double m_rate; //!< Rate allocated in bit/s
+    double m_buffer; //!< Seconds of video in the buffer
+    double m_received; //!< Seconds of video received
+    bool m_playing; //!< Whether the video is playing
+    bool m_started; //!< Whether the video has played once
+    double m_stallStart; //!< Time the last stall started, in seconds
+  };
+
+  /**
+   * @brief Start serving a session.
+   *
+   * @param index the index of the session
+   */
+  void StartSession (uint32_t index);
+
+  /**
+   * @brief Stop serving a session.
+   *
+   * @param index the index of the session
+   */
+  void StopSession (uint32_t index);
+
+  /**
+   * @brief Integrate the buffers up to now, then allocate the rates until the next step.
+   */
+  void Step (void);
+
+  /**
+   * @brief Integrate the buffer of a fluid session over the last step.
+   *
+   * @param session the session
+   * @param from the start of the step in seconds
+   * @param to the end of the step in seconds
+   */
+  void Advance (Session &session, double from, double to);
+
+  /**
+   * @brief Give the active sessions their max-min fair rates and lower
+   * the data rate of the links by the rate of the fluid sessions.
+   */
+  void Allocate (void);
+
+  /**
+   * @brief Set the data rate of a link to the capacity left to the packets.
+   *
+   * @param link the link
+   */
+  void ApplyCapacity (Link &link);
+
+  /**
+   * @brief Find the links from the server to the viewer of a session.
+   *
+   * @param session the session
+   * @return false if the route could not be followed
+   */
+  bool FindPath (Session &session);
+
+  /**
+   * @brief Get the index of the link of a device, adding it on first use.
+   *
+   * @param device the device sending on the link
+   * @return the index of the link
+   */
+  uint32_t GetLink (Ptr<NetDevice> device);
+
+  /**
+   * @brief Get the node owning an address.
+   *
+   * @param address the address
+   * @return the node, null if no node has the address
+   */
+  Ptr<Node> GetNodeOf (Ipv4Address address);
+
+  Time m_step; //!< Time between two allocations
+  DataRate m_bitRate; //!< Bitrate of video level 1
+  uint16_t m_videoLevel; //!< Video level of the fluid sessions
+  Time m_initialDelay; //!< Time before the first playback of a session
+  Time m_resumeThreshold; //!< Video buffered before the playback starts or resumes
+  Time m_titleDuration; //!< Length of the title, 0 for sessions lasting until their end
+  DataRate m_defaultCapacity; //!< Capacity of devices without a DataRate attribute
+  double m_minResidualShare; //!< Smallest share of a link left to the packets
+
+  std::vector<Session> m_sessions; //!< Fluid and packet sessions
+  std::vector<Link> m_links; //!< Links used by the sessions
+  std::map<Ptr<NetDevice>, uint32_t> m_linkIndex; //!< Index of the link of each device
+  std::map<Ipv4Address, Ptr<Node> > m_serverNodes; //!< Node of each server address
+  uint32_t m_activeSessions; //!< Sessions being served
+  uint32_t m_fluidSessions; //!< Sessions added with AddFluidSession
+  uint32_t m_unroutedSessions; //!< Fluid sessions without a route
+  Time m_lastStep; //!< Time of the last step
+  EventId m_stepEvent; //!< Next step
+
+  uint32_t m_stallCount; //!< Stalls of the fluid sessions
+  double m_deliveredBytes; //!< Bytes delivered to the fluid sessions
+  VideoStreamHistogram m_startupDelay; //!< Startup delays of the fluid sessions
+  VideoStreamHistogram m_stallDuration; //!< Stall durations of the fluid sessions
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_FLUID_MODEL_H */
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "video-stream-frame-generator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamFrameGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamFrameGenerator);
+
+// Draws of a frame
+static const uint32_t SCENE_CHANGE_STREAM = 0;
+static const uint32_t SCENE_COMPLEXITY_STREAM = 1;
+static const uint32_t FRAME_NOISE_STREAM = 3;
+
+/**
+ * @brief Mix the bits of a 64-bit integer (SplitMix64 finalizer).
+ *
+ * @param x the integer
+ * @return the mixed integer
+ */
+static uint64_t
+Mix (uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+TypeId
+VideoStreamFrameGenerator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamFrameGenerator")
+    .SetParent<Object> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamFrameGenerator> ()
+    .AddAttribute ("BitRate", "The mean bitrate of video level 1; level n is n times larger",
+                    DataRateValue (DataRate ("2Mbps")),
+                    MakeDataRateAccessor (&VideoStreamFrameGenerator::m_bitRate),
+                    MakeDataRateChecker ())
+    .AddAttribute ("FrameRate", "The number of frames per second the bitrate is spread over",
+                    DoubleValue (25.0),
+                    MakeDoubleAccessor (&VideoStreamFrameGenerator::m_frameRate),
+                    MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("GopLength", "The number of frames of a group of pictures, starting with an I frame",
+                    UintegerValue (25),
+                    MakeUintegerAccessor (&VideoStreamFrameGenerator::m_gopLength),
+                    MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BFrames", "The number of B frames between two reference frames",
+                    UintegerValue (2),
+                    MakeUintegerAccessor (&VideoStreamFrameGenerator::m_bFrames),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("IFrameScale", "The mean size of an I frame over the mean size of a P frame",
+                    DoubleValue (4.0),
+                    MakeDoubleAccessor (&VideoStreamFrameGenerator::m_iFrameScale),
+                    MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("BFrameScale", "The mean size of a B frame over the mean size of a P frame",
+                    DoubleValue (0.5),
+                    MakeDoubleAccessor (&VideoStreamFrameGenerator::m_bFrameScale),
+                    MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("SizeVariation", "The standard deviation of the logarithm of the size of a frame around the mean of its type",
+                    DoubleValue (0.2),
+                    MakeDoubleAccessor (&VideoStreamFrameGenerator::m_sizeVariation),
+                    MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("SceneChangeProbability", "The probability that a frame starts a new scene with an I frame",
+                    DoubleValue (0.01),
+                    MakeDoubleAccessor (&VideoStreamFrameGenerator::m_sceneChangeProbability),
+                    MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("SceneVariation", "The standard deviation of the logarithm of the complexity of a scene",
+                    DoubleValue (0.4),
+                    MakeDoubleAccessor (&VideoStreamFrameGenerator::m_sceneVariation),
+                    MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MaxSceneLength", "The largest number of frames of a scene",
+                    UintegerValue (250),
+                    MakeUintegerAccessor (&VideoStreamFrameGenerator::m_maxSceneLength),
+                    MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Seed", "The seed of the frame sizes",
+                    UintegerValue (1),
+                    MakeUintegerAccessor (&VideoStreamFrameGenerator::m_seed),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("TitleCount", "The number of titles, each with its own frame sizes",
+                    UintegerValue (1),
+                    MakeUintegerAccessor (&VideoStreamFrameGenerator::m_titleCount),
+                    MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+VideoStreamFrameGenerator::VideoStreamFrameGenerator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+VideoStreamFrameGenerator::~VideoStreamFrameGenerator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+VideoStreamFrameGenerator::GetTitleCount (void) const
+{
+  return m_titleCount;
+}
+
+double
+VideoStreamFrameGenerator::GetUniform (uint32_t contentId, uint32_t frame, uint32_t stream) const
+{
+  uint64_t x = Mix ((static_cast<uint64_t> (m_seed) << 32 | contentId) + 0x9e3779b97f4a7c15ULL);
+  x = Mix (x ^ (static_cast<uint64_t> (frame) << 8 | stream));
+  // 53 bits, never 0 nor 1
+  return ((x >> 11) + 0.5) / 9007199254740992.0;
+}
+
+double
+VideoStreamFrameGenerator::GetLognormal (uint32_t contentId, uint32_t frame, uint32_t stream, double sigma) const
+{
+  // Box-Muller
+  double u1 = GetUniform (contentId, frame, stream);
+  double u2 = GetUniform (contentId, frame, stream + 1);
+  double z = std::sqrt (-2.0 * std::log (u1)) * std::cos (2.0 * M_PI * u2);
+  return std::exp (sigma * z - sigma * sigma / 2);
+}
+
+uint32_t
+VideoStreamFrameGenerator::GetSceneStart (uint32_t contentId, uint32_t frame) const
+{
+  while (frame % m_maxSceneLength != 0 && GetUniform (contentId, frame, SCENE_CHANGE_STREAM) >= m_sceneChangeProbability)
+  {
+    frame--;
+  }
+  return frame;
+}
+
+VideoStreamFrameGenerator::FrameType
+VideoStreamFrameGenerator::GetFrameType (uint32_t contentId, uint32_t frame) const
+{
+  uint32_t position = (frame - GetSceneStart (contentId, frame)) % m_gopLength;
+  if (position == 0)
+  {
+    return I_FRAME;
+  }
+  return position % (m_bFrames + 1) == 0 ? P_FRAME : B_FRAME;
+}
+
+double
+VideoStreamFrameGenerator::GetMeanFrameSize (uint16_t videoLevel) const
+{
+  return m_bitRate.GetBitRate () / 8.0 / m_frameRate * videoLevel;
+}
+
+uint32_t
+VideoStreamFrameGenerator::GetFrameSize (uint32_t contentId, uint16_t videoLevel, uint32_t frame) const
+{
+  // the P frame size that gives a full GOP the mean frame size
+  uint32_t pFrames = (m_gopLength - 1) / (m_bFrames + 1);
+  uint32_t bFrames = m_gopLength - 1 - pFrames;
+  double gopScale = m_iFrameScale + pFrames + m_bFrameScale * bFrames;
+  double pFrameSize = gopScale > 0 ? GetMeanFrameSize (videoLevel) * m_gopLength / gopScale : 0.0;
+
+  uint32_t sceneStart = GetSceneStart (contentId, frame);
+  uint32_t position = (frame - sceneStart) % m_gopLength;
+  double typeScale = position == 0 ? m_iFrameScale : (position % (m_bFrames + 1) == 0 ? 1.0 : m_bFrameScale);
+  double size = pFrameSize * typeScale
+    * GetLognormal (contentId, sceneStart, SCENE_COMPLEXITY_STREAM, m_sceneVariation)
+    * GetLognormal (contentId, frame, FRAME_NOISE_STREAM, m_sizeVariation);
+  return static_cast<uint32_t> (std::max (1.0, std::round (size)));
+}
+
+} // namespace ns3
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_FRAME_GENERATOR_H
+#define VIDEO_STREAM_FRAME_GENERATOR_H
+
+#include "ns3/object.h"
+#include "ns3/data-rate.h"
+
+namespace ns3 {
+
+/**
+ * @brief Synthetic variable bitrate frame sizes.
+ *
+ * Each title is a sequence of scenes encoded in groups of pictures: an I
+ * frame starts every GOP and every scene, followed by P frames with BFrames
+ * B frames between two reference frames. The size of a frame is the mean
+ * size of its type, scaled by the complexity of its scene and by its own
+ * lognormal noise, so that the mean bitrate of a GOP at level 1 is BitRate;
+ * level n sends n times the level 1 sizes, like a frame file.
+ *
+ * Nothing is stored: the size of a frame is computed from the seed, the
+ * title and the frame number alone, so sessions of any length use constant
+ * memory and a frame always has the same size. A scene starts with
+ * probability SceneChangeProbability at each frame and at least every
+ * MaxSceneLength frames, which bounds the search for the start of the scene
+ * of a frame.
+ */
+class VideoStreamFrameGenerator : public Object
+{
+public:
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Type of a frame.
+   */
+  enum FrameType
+  {
+    I_FRAME = 0, //!< Intra-coded frame, starting a GOP
+    P_FRAME = 1, //!< Predicted frame
+    B_FRAME = 2 //!< Bidirectionally predicted frame
+  };
+
+  VideoStreamFrameGenerator ();
+
+  virtual ~VideoStreamFrameGenerator ();
+
+  /**
+   * @brief Get the number of titles.
+   *
+   * @return the number of content IDs with their own frame sizes
+   */
+  uint32_t GetTitleCount (void) const;
+
+  /**
+   * @brief Get the type of a frame.
+   *
+   * @param contentId the title
+   * @param frame the frame number
+   * @return the frame type
+   */
+  FrameType GetFrameType (uint32_t contentId, uint32_t frame) const;
+
+  /**
+   * @brief Get the size of a frame.
+   *
+   * @param contentId the title
+   * @param videoLevel the video level
+   * @param frame the frame number
+   * @return the frame size in bytes, at least 1
+   */
+  uint32_t GetFrameSize (uint32_t contentId, uint16_t videoLevel, uint32_t frame) const;
+
+  /**
+   * @brief Get the mean frame size of a video level.
+   *
+   * @param videoLevel the video level
+   * @return the mean size in bytes
+   */
+  double GetMeanFrameSize (uint16_t videoLevel) const;
+
+private:
+  /**
+   * @brief Get the first frame of the scene of a frame.
+   *
+   * @param contentId the title
+   * @param frame the frame number
+   * @return the frame starting the scene
+   */
+  uint32_t GetSceneStart (uint32_t contentId, uint32_t frame) const;
+
+  /**
+   * @brief Get a uniform number in (0, 1) drawn for a frame.
+   *
+   * @param contentId the title
+   * @param frame the frame number
+   * @param stream the draw, so that one frame has independent numbers
+   * @return the number
+   */
+  double GetUniform (uint32_t contentId, uint32_t frame, uint32_t stream) const;
+
+  /**
+   * @brief Get a lognormal factor of mean 1 drawn for a frame.
+   *
+   * @param contentId the title
+   * @param frame the frame number
+   * @param stream the first of the two draws used
+   * @param sigma the standard deviation of the logarithm
+   * @return the factor
+   */
+  double GetLognormal (uint32_t contentId, uint32_t frame, uint32_t stream, double sigma) const;
+
+  DataRate m_bitRate; //!< Mean bitrate at video level 1
+  double m_frameRate; //!< Frames per second
+  uint32_t m_gopLength; //!< Frames per GOP
+  uint32_t m_bFrames; //!< B frames between two reference frames
+  double m_iFrameScale; //!< Mean I frame size over mean P frame size
+  double m_bFrameScale; //!< Mean B frame size over mean P frame size
+  double m_sizeVariation; //!< Standard deviation of the logarithm of the frame size
+  double m_sceneChangeProbability; //!< Probability that a frame starts a scene
+  double m_sceneVariation; //!< Standard deviation of the logarithm of the scene complexity
+  uint32_t m_maxSceneLength; //!< Largest number of frames of a scene
+  uint32_t m_seed; //!< Seed of the frame sizes
+  uint32_t m_titleCount; //!< Number of titles
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_FRAME_GENERATOR_H */
@@ -0,0 +1,940 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "video-stream-header.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamHeader");
+
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamHeader);
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamReportHeader);
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamSessionHeader);
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamLadderHeader);
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamRedirectHeader);
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamLoadHeader);
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamJoinHeader);
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamPathReportHeader);
+
+VideoStreamHeader::VideoStreamHeader ()
+  : m_type (HELLO),
+    m_flags (0),
+    m_videoLevel (0),
+    m_contentId (0),
+    m_frame (0),
+    m_timestamp (0),
+    m_sequence (0),
+    m_fragments (1)
+{
+}
+
+TypeId
+VideoStreamHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VideoStreamHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VideoStreamHeader::SetMessageType (MessageType type)
+{
+  m_type = type;
+}
+
+VideoStreamHeader::MessageType
+VideoStreamHeader::GetMessageType (void) const
+{
+  return static_cast<MessageType> (m_type);
+}
+
+void
+VideoStreamHeader::SetFlags (uint8_t flags)
+{
+  m_flags = flags;
+}
+
+uint8_t
+VideoStreamHeader::GetFlags (void) const
+{
+  return m_flags;
+}
+
+void
+VideoStreamHeader::SetContentId (uint32_t contentId)
+{
+  m_contentId = contentId;
+}
+
+uint32_t
+VideoStreamHeader::GetContentId (void) const
+{
+  return m_contentId;
+}
+
+void
+VideoStreamHeader::SetVideoLevel (uint16_t videoLevel)
+{
+  m_videoLevel = videoLevel;
+}
+
+uint16_t
+VideoStreamHeader::GetVideoLevel (void) const
+{
+  return m_videoLevel;
+}
+
+void
+VideoStreamHeader::SetFrame (uint32_t frame)
+{
+  m_frame = frame;
+}
+
+uint32_t
+VideoStreamHeader::GetFrame (void) const
+{
+  return m_frame;
+}
+
+void
+VideoStreamHeader::SetTimestamp (Time timestamp)
+{
+  m_timestamp = timestamp.GetNanoSeconds ();
+}
+
+Time
+VideoStreamHeader::GetTimestamp (void) const
+{
+  return NanoSeconds (m_timestamp);
+}
+
+void
+VideoStreamHeader::SetSequence (uint32_t sequence)
+{
+  m_sequence = sequence;
+}
+
+uint32_t
+VideoStreamHeader::GetSequence (void) const
+{
+  return m_sequence;
+}
+
+void
+VideoStreamHeader::SetFragments (uint16_t fragments)
+{
+  m_fragments = fragments;
+}
+
+uint16_t
+VideoStreamHeader::GetFragments (void) const
+{
+  return m_fragments;
+}
+
+void
+VideoStreamHeader::Print (std::ostream &os) const
+{
+  os << "type=" << static_cast<uint32_t> (m_type)
+     << " flags=" << static_cast<uint32_t> (m_flags)
+     << " level=" << m_videoLevel
+     << " content=" << m_contentId
+     << " frame=" << m_frame
+     << " timestamp=" << m_timestamp << "ns"
+     << " seq=" << m_sequence
+     << " fragments=" << m_fragments;
+}
+
+uint32_t
+VideoStreamHeader::GetSerializedSize (void) const
+{
+  return SERIALIZED_SIZE;
+}
+
+void
+VideoStreamHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteU8 (m_type);
+  i.WriteU8 (m_flags);
+  i.WriteHtonU16 (m_videoLevel);
+  i.WriteHtonU32 (m_contentId);
+  i.WriteHtonU32 (m_frame);
+  i.WriteHtonU64 (m_timestamp);
+  i.WriteHtonU32 (m_sequence);
+  i.WriteHtonU16 (m_fragments);
+}
+
+uint32_t
+VideoStreamHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_type = i.ReadU8 ();
+  m_flags = i.ReadU8 ();
+  m_videoLevel = i.ReadNtohU16 ();
+  m_contentId = i.ReadNtohU32 ();
+  m_frame = i.ReadNtohU32 ();
+  m_timestamp = i.ReadNtohU64 ();
+  m_sequence = i.ReadNtohU32 ();
+  m_fragments = i.ReadNtohU16 ();
+  return GetSerializedSize ();
+}
+
+VideoStreamReportHeader::VideoStreamReportHeader ()
+  : m_duration (0),
+    m_receivedBytes (0),
+    m_highestSequence (0),
+    m_lossFraction (0),
+    m_jitter (0),
+    m_delayTrend (0)
+{
+}
+
+TypeId
+VideoStreamReportHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamReportHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamReportHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VideoStreamReportHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VideoStreamReportHeader::SetDuration (Time duration)
+{
+  m_duration = duration.GetMicroSeconds ();
+}
+
+Time
+VideoStreamReportHeader::GetDuration (void) const
+{
+  return MicroSeconds (m_duration);
+}
+
+void
+VideoStreamReportHeader::SetReceivedBytes (uint32_t bytes)
+{
+  m_receivedBytes = bytes;
+}
+
+uint32_t
+VideoStreamReportHeader::GetReceivedBytes (void) const
+{
+  return m_receivedBytes;
+}
+
+void
+VideoStreamReportHeader::SetHighestSequence (uint32_t sequence)
+{
+  m_highestSequence = sequence;
+}
+
+uint32_t
+VideoStreamReportHeader::GetHighestSequence (void) const
+{
+  return m_highestSequence;
+}
+
+void
+VideoStreamReportHeader::SetLossFraction (double lossFraction)
+{
+  m_lossFraction = std::min (255.0, std::max (0.0, lossFraction * 256));
+}
+
+double
+VideoStreamReportHeader::GetLossFraction (void) const
+{
+  return m_lossFraction / 256.0;
+}
+
+void
+VideoStreamReportHeader::SetJitter (Time jitter)
+{
+  m_jitter = jitter.GetMicroSeconds ();
+}
+
+Time
+VideoStreamReportHeader::GetJitter (void) const
+{
+  return MicroSeconds (m_jitter);
+}
+
+void
+VideoStreamReportHeader::SetDelayTrend (Time delayTrend)
+{
+  m_delayTrend = delayTrend.GetMicroSeconds ();
+}
+
+Time
+VideoStreamReportHeader::GetDelayTrend (void) const
+{
+  return MicroSeconds (m_delayTrend);
+}
+
+void
+VideoStreamReportHeader::Print (std::ostream &os) const
+{
+  os << "duration=" << m_duration << "us"
+     << " bytes=" << m_receivedBytes
+     << " highestSeq=" << m_highestSequence
+     << " loss=" << static_cast<uint32_t> (m_lossFraction) << "/256"
+     << " jitter=" << m_jitter << "us"
+     << " trend=" << m_delayTrend << "us/s";
+}
+
+uint32_t
+VideoStreamReportHeader::GetSerializedSize (void) const
+{
+  return SERIALIZED_SIZE;
+}
+
+void
+VideoStreamReportHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_duration);
+  i.WriteHtonU32 (m_receivedBytes);
+  i.WriteHtonU32 (m_highestSequence);
+  i.WriteU8 (m_lossFraction);
+  i.WriteHtonU32 (m_jitter);
+  i.WriteHtonU32 (static_cast<uint32_t> (m_delayTrend));
+}
+
+uint32_t
+VideoStreamReportHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_duration = i.ReadNtohU32 ();
+  m_receivedBytes = i.ReadNtohU32 ();
+  m_highestSequence = i.ReadNtohU32 ();
+  m_lossFraction = i.ReadU8 ();
+  m_jitter = i.ReadNtohU32 ();
+  m_delayTrend = static_cast<int32_t> (i.ReadNtohU32 ());
+  return GetSerializedSize ();
+}
+
+VideoStreamSessionHeader::VideoStreamSessionHeader ()
+  : m_maxVideoLevel (0),
+    m_bufferCapacity (0),
+    m_attempt (0),
+    m_totalFrames (0),
+    m_frameInterval (0),
+    m_maxHeight (0)
+{
+}
+
+TypeId
+VideoStreamSessionHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamSessionHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamSessionHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VideoStreamSessionHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VideoStreamSessionHeader::SetMaxVideoLevel (uint16_t videoLevel)
+{
+  m_maxVideoLevel = videoLevel;
+}
+
+uint16_t
+VideoStreamSessionHeader::GetMaxVideoLevel (void) const
+{
+  return m_maxVideoLevel;
+}
+
+void
+VideoStreamSessionHeader::SetBufferCapacity (uint32_t frames)
+{
+  m_bufferCapacity = frames;
+}
+
+uint32_t
+VideoStreamSessionHeader::GetBufferCapacity (void) const
+{
+  return m_bufferCapacity;
+}
+
+void
+VideoStreamSessionHeader::SetAttempt (uint8_t attempt)
+{
+  m_attempt = attempt;
+}
+
+uint8_t
+VideoStreamSessionHeader::GetAttempt (void) const
+{
+  return m_attempt;
+}
+
+void
+VideoStreamSessionHeader::SetTotalFrames (uint32_t frames)
+{
+  m_totalFrames = frames;
+}
+
+uint32_t
+VideoStreamSessionHeader::GetTotalFrames (void) const
+{
+  return m_totalFrames;
+}
+
+void
+VideoStreamSessionHeader::SetFrameInterval (Time interval)
+{
+  m_frameInterval = interval.GetMicroSeconds ();
+}
+
+Time
+VideoStreamSessionHeader::GetFrameInterval (void) const
+{
+  return MicroSeconds (m_frameInterval);
+}
+
+void
+VideoStreamSessionHeader::SetMaxHeight (uint16_t height)
+{
+  m_maxHeight = height;
+}
+
+uint16_t
+VideoStreamSessionHeader::GetMaxHeight (void) const
+{
+  return m_maxHeight;
+}
+
+void
+VideoStreamSessionHeader::Print (std::ostream &os) const
+{
+  os << "maxLevel=" << m_maxVideoLevel
+     << " buffer=" << m_bufferCapacity
+     << " attempt=" << static_cast<uint32_t> (m_attempt)
+     << " frames=" << m_totalFrames
+     << " interval=" << m_frameInterval << "us"
+     << " maxHeight=" << m_maxHeight;
+}
+
+uint32_t
+VideoStreamSessionHeader::GetSerializedSize (void) const
+{
+  return SERIALIZED_SIZE;
+}
+
+void
+VideoStreamSessionHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU16 (m_maxVideoLevel);
+  i.WriteHtonU32 (m_bufferCapacity);
+  i.WriteU8 (m_attempt);
+  i.WriteHtonU32 (m_totalFrames);
+  i.WriteHtonU32 (m_frameInterval);
+  i.WriteHtonU16 (m_maxHeight);
+}
+
+uint32_t
+VideoStreamSessionHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_maxVideoLevel = i.ReadNtohU16 ();
+  m_bufferCapacity = i.ReadNtohU32 ();
+  m_attempt = i.ReadU8 ();
+  m_totalFrames = i.ReadNtohU32 ();
+  m_frameInterval = i.ReadNtohU32 ();
+  m_maxHeight = i.ReadNtohU16 ();
+  return GetSerializedSize ();
+}
+
+VideoStreamLadderHeader::VideoStreamLadderHeader ()
+{
+}
+
+TypeId
+VideoStreamLadderHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamLadderHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamLadderHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VideoStreamLadderHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VideoStreamLadderHeader::SetLadder (const VideoStreamLadder &ladder)
+{
+  m_ladder.Clear ();
+  for (uint16_t videoLevel = 1; videoLevel <= ladder.GetLevelCount (); videoLevel++)
+  {
+    const VideoStreamLadder::Rendition &rendition = ladder.GetRendition (videoLevel);
+    m_ladder.AddRendition (rendition.m_bitRate, rendition.m_width, rendition.m_height);
+  }
+}
+
+const VideoStreamLadder &
+VideoStreamLadderHeader::GetLadder (void) const
+{
+  return m_ladder;
+}
+
+void
+VideoStreamLadderHeader::Print (std::ostream &os) const
+{
+  os << "ladder=" << m_ladder;
+}
+
+uint32_t
+VideoStreamLadderHeader::GetSerializedSize (void) const
+{
+  return 2 + RENDITION_SIZE * m_ladder.GetLevelCount ();
+}
+
+void
+VideoStreamLadderHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU16 (m_ladder.GetLevelCount ());
+  for (uint16_t videoLevel = 1; videoLevel <= m_ladder.GetLevelCount (); videoLevel++)
+  {
+    const VideoStreamLadder::Rendition &rendition = m_ladder.GetRendition (videoLevel);
+    i.WriteHtonU64 (rendition.m_bitRate.GetBitRate ());
+    i.WriteHtonU16 (rendition.m_width);
+    i.WriteHtonU16 (rendition.m_height);
+  }
+}
+
+uint32_t
+VideoStreamLadderHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_ladder.Clear ();
+  uint16_t levels = i.ReadNtohU16 ();
+  for (uint16_t videoLevel = 1; videoLevel <= levels; videoLevel++)
+  {
+    uint64_t bitRate = i.ReadNtohU64 ();
+    uint16_t width = i.ReadNtohU16 ();
+    uint16_t height = i.ReadNtohU16 ();
+    m_ladder.AddRendition (DataRate (bitRate), width, height);
+  }
+  return GetSerializedSize ();
+}
+
+VideoStreamRedirectHeader::VideoStreamRedirectHeader ()
+  : m_serverPort (0)
+{
+}
+
+TypeId
+VideoStreamRedirectHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamRedirectHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamRedirectHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VideoStreamRedirectHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VideoStreamRedirectHeader::SetServerAddress (Ipv4Address address)
+{
+  m_serverAddress = address;
+}
+
+Ipv4Address
+VideoStreamRedirectHeader::GetServerAddress (void) const
+{
+  return m_serverAddress;
+}
+
+void
+VideoStreamRedirectHeader::SetServerPort (uint16_t port)
+{
+  m_serverPort = port;
+}
+
+uint16_t
+VideoStreamRedirectHeader::GetServerPort (void) const
+{
+  return m_serverPort;
+}
+
+void
+VideoStreamRedirectHeader::Print (std::ostream &os) const
+{
+  os << "server=" << m_serverAddress << ":" << m_serverPort;
+}
+
+uint32_t
+VideoStreamRedirectHeader::GetSerializedSize (void) const
+{
+  return SERIALIZED_SIZE;
+}
+
+void
+VideoStreamRedirectHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_serverAddress.Get ());
+  i.WriteHtonU16 (m_serverPort);
+}
+
+uint32_t
+VideoStreamRedirectHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_serverAddress.Set (i.ReadNtohU32 ());
+  m_serverPort = i.ReadNtohU16 ();
+  return GetSerializedSize ();
+}
+
+VideoStreamLoadHeader::VideoStreamLoadHeader ()
+  : m_activeSessions (0),
+    m_queueLength (0),
+    m_maxSessions (0),
+    m_reservedRate (0),
+    m_egressBudget (0)
+{
+}
+
+TypeId
+VideoStreamLoadHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamLoadHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamLoadHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VideoStreamLoadHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VideoStreamLoadHeader::SetActiveSessions (uint32_t sessions)
+{
+  m_activeSessions = sessions;
+}
+
+uint32_t
+VideoStreamLoadHeader::GetActiveSessions (void) const
+{
+  return m_activeSessions;
+}
+
+void
+VideoStreamLoadHeader::SetQueueLength (uint32_t sessions)
+{
+  m_queueLength = sessions;
+}
+
+uint32_t
+VideoStreamLoadHeader::GetQueueLength (void) const
+{
+  return m_queueLength;
+}
+
+void
+VideoStreamLoadHeader::SetMaxSessions (uint32_t sessions)
+{
+  m_maxSessions = sessions;
+}
+
+uint32_t
+VideoStreamLoadHeader::GetMaxSessions (void) const
+{
+  return m_maxSessions;
+}
+
+void
+VideoStreamLoadHeader::SetReservedRate (DataRate rate)
+{
+  m_reservedRate = rate.GetBitRate ();
+}
+
+DataRate
+VideoStreamLoadHeader::GetReservedRate (void) const
+{
+  return DataRate (m_reservedRate);
+}
+
+void
+VideoStreamLoadHeader::SetEgressBudget (DataRate rate)
+{
+  m_egressBudget = rate.GetBitRate ();
+}
+
+DataRate
+VideoStreamLoadHeader::GetEgressBudget (void) const
+{
+  return DataRate (m_egressBudget);
+}
+
+void
+VideoStreamLoadHeader::Print (std::ostream &os) const
+{
+  os << "sessions=" << m_activeSessions
+     << " queue=" << m_queueLength
+     << " maxSessions=" << m_maxSessions
+     << " reserved=" << m_reservedRate << "bps"
+     << " budget=" << m_egressBudget << "bps";
+}
+
+uint32_t
+VideoStreamLoadHeader::GetSerializedSize (void) const
+{
+  return SERIALIZED_SIZE;
+}
+
+void
+VideoStreamLoadHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_activeSessions);
+  i.WriteHtonU32 (m_queueLength);
+  i.WriteHtonU32 (m_maxSessions);
+  i.WriteHtonU64 (m_reservedRate);
+  i.WriteHtonU64 (m_egressBudget);
+}
+
+uint32_t
+VideoStreamLoadHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_activeSessions = i.ReadNtohU32 ();
+  m_queueLength = i.ReadNtohU32 ();
+  m_maxSessions = i.ReadNtohU32 ();
+  m_reservedRate = i.ReadNtohU64 ();
+  m_egressBudget = i.ReadNtohU64 ();
+  return GetSerializedSize ();
+}
+
+VideoStreamJoinHeader::VideoStreamJoinHeader ()
+  : m_sessionPort (0),
+    m_path (0)
+{
+}
+
+TypeId
+VideoStreamJoinHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamJoinHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamJoinHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VideoStreamJoinHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VideoStreamJoinHeader::SetSessionAddress (Ipv4Address address)
+{
+  m_sessionAddress = address;
+}
+
+Ipv4Address
+VideoStreamJoinHeader::GetSessionAddress (void) const
+{
+  return m_sessionAddress;
+}
+
+void
+VideoStreamJoinHeader::SetSessionPort (uint16_t port)
+{
+  m_sessionPort = port;
+}
+
+uint16_t
+VideoStreamJoinHeader::GetSessionPort (void) const
+{
+  return m_sessionPort;
+}
+
+void
+VideoStreamJoinHeader::SetPath (uint8_t path)
+{
+  m_path = path;
+}
+
+uint8_t
+VideoStreamJoinHeader::GetPath (void) const
+{
+  return m_path;
+}
+
+void
+VideoStreamJoinHeader::Print (std::ostream &os) const
+{
+  os << "session=" << m_sessionAddress << ":" << m_sessionPort
+     << " path=" << static_cast<uint32_t> (m_path);
+}
+
+uint32_t
+VideoStreamJoinHeader::GetSerializedSize (void) const
+{
+  return SERIALIZED_SIZE;
+}
+
+void
+VideoStreamJoinHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_sessionAddress.Get ());
+  i.WriteHtonU16 (m_sessionPort);
+  i.WriteU8 (m_path);
+}
+
+uint32_t
+VideoStreamJoinHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_sessionAddress.Set (i.ReadNtohU32 ());
+  m_sessionPort = i.ReadNtohU16 ();
+  m_path = i.ReadU8 ();
+  return GetSerializedSize ();
+}
+
+VideoStreamPathReportHeader::VideoStreamPathReportHeader ()
+  : m_duration (0),
+    m_receivedBytes (0),
+    m_delay (0)
+{
+}
+
+TypeId
+VideoStreamPathReportHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamPathReportHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamPathReportHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+VideoStreamPathReportHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+VideoStreamPathReportHeader::SetDuration (Time duration)
+{
+  m_duration = duration.GetMicroSeconds ();
+}
+
+Time
+VideoStreamPathReportHeader::GetDuration (void) const
+{
+  return MicroSeconds (m_duration);
+}
+
+void
+VideoStreamPathReportHeader::SetReceivedBytes (uint32_t bytes)
+{
+  m_receivedBytes = bytes;
+}
+
+uint32_t
+VideoStreamPathReportHeader::GetReceivedBytes (void) const
+{
+  return m_receivedBytes;
+}
+
+void
+VideoStreamPathReportHeader::SetDelay (Time delay)
+{
+  m_delay = delay.GetMicroSeconds ();
+}
+
+Time
+VideoStreamPathReportHeader::GetDelay (void) const
+{
+  return MicroSeconds (m_delay);
+}
+
+void
+VideoStreamPathReportHeader::Print (std::ostream &os) const
+{
+  os << "duration=" << m_duration << "us"
+     << " bytes=" << m_receivedBytes
+     << " delay=" << m_delay << "us";
+}
+
+uint32_t
+VideoStreamPathReportHeader::GetSerializedSize (void) const
+{
+  return SERIALIZED_SIZE;
+}
+
+void
+VideoStreamPathReportHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteHtonU32 (m_duration);
+  i.WriteHtonU32 (m_receivedBytes);
+  i.WriteHtonU32 (m_delay);
+}
+
+uint32_t
+VideoStreamPathReportHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  m_duration = i.ReadNtohU32 ();
+  m_receivedBytes = i.ReadNtohU32 ();
+  m_delay = i.ReadNtohU32 ();
+  return GetSerializedSize ();
+}
+
+} // namespace ns3
@@ -0,0 +1,800 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_HEADER_H
+#define VIDEO_STREAM_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+#include "ns3/ipv4-address.h"
+#include "video-stream-ladder.h"
+
+namespace ns3 {
+
+/**
+ * @brief Header of the messages exchanged by the video stream applications.
+ *
+ * The client opens a session with a HELLO and repeats it until the server
+ * answers with a HELLO_ACK or a REJECT; the server then streams the frames
+ * in DATA fragments. Each message type notes the header that follows it and
+ * the fields it reuses.
+ */
+class VideoStreamHeader : public Header
+{
+public:
+  /**
+   * @brief Type of a message.
+   */
+  enum MessageType
+  {
+    HELLO = 0, //!< Session request, MTU as sequence, followed by a VideoStreamSessionHeader
+    LEVEL = 1, //!< New video level of the client
+    DATA = 2, //!< Fragment of a frame, or consecutive fragments, with its production time
+    REJECT = 3, //!< Session refused by the server
+    BYE = 4, //!< End of the session from the client
+    REPORT = 5, //!< Receiver report from the client, followed by a VideoStreamReportHeader
+    HELLO_ACK = 6, //!< Session admitted, fragment size as sequence, followed by a VideoStreamSessionHeader and a VideoStreamLadderHeader
+    SEEK = 7, //!< New position of the client, from the keyframe at or before it
+    REDIRECT = 8, //!< Server chosen by the request router, followed by a VideoStreamRedirectHeader
+    LOAD = 9, //!< Load report of a server to the request router, followed by a VideoStreamLoadHeader
+    JOIN = 10, //!< Subflow of a session on another path, echoed by the server, followed by a VideoStreamJoinHeader
+    PATH_REPORT = 11 //!< Receiver report of one path of a multipath session, followed by a VideoStreamPathReportHeader
+  };
+
+  /**
+   * @brief Flags of a DATA message.
+   */
+  enum Flags
+  {
+    LAST_FRAGMENT = 0x01, //!< Last fragment of the frame
+    LAST_FRAME = 0x02, //!< Fragment of the last frame of the title
+    LIVE = 0x04, //!< Fragment of a live stream
+    TRICK_PLAY = 0x08, //!< Fragment of a keyframe sent for fast forward, or SEEK asking for it
+    DISCONTINUITY = 0x10 //!< First fragment sent after a SEEK
+  };
+
+  static const uint32_t SERIALIZED_SIZE = 26; //!< Size of the serialized header in bytes
+
+  VideoStreamHeader ();
+
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Set the message type.
+   *
+   * @param type the message type
+   */
+  void SetMessageType (MessageType type);
+
+  /**
+   * @brief Get the message type.
+   *
+   * @return the message type
+   */
+  MessageType GetMessageType (void) const;
+
+  /**
+   * @brief Set the flags.
+   *
+   * @param flags a combination of Flags
+   */
+  void SetFlags (uint8_t flags);
+
+  /**
+   * @brief Get the flags.
+   *
+   * @return a combination of Flags
+   */
+  uint8_t GetFlags (void) const;
+
+  /**
+   * @brief Set the ID of the requested title.
+   *
+   * @param contentId the content ID
+   */
+  void SetContentId (uint32_t contentId);
+
+  /**
+   * @brief Get the ID of the requested title.
+   *
+   * @return the content ID
+   */
+  uint32_t GetContentId (void) const;
+
+  /**
+   * @brief Set the video level.
+   *
+   * @param videoLevel the video level
+   */
+  void SetVideoLevel (uint16_t videoLevel);
+
+  /**
+   * @brief Get the video level.
+   *
+   * @return the video level
+   */
+  uint16_t GetVideoLevel (void) const;
+
+  /**
+   * @brief Set the frame number.
+   *
+   * @param frame the frame number
+   */
+  void SetFrame (uint32_t frame);
+
+  /**
+   * @brief Get the frame number.
+   *
+   * @return the frame number
+   */
+  uint32_t GetFrame (void) const;
+
+  /**
+   * @brief Set the timestamp.
+   *
+   * @param timestamp the production time of the frame
+   */
+  void SetTimestamp (Time timestamp);
+
+  /**
+   * @brief Get the timestamp.
+   *
+   * @return the production time of the frame
+   */
+  Time GetTimestamp (void) const;
+
+  /**
+   * @brief Set the sequence number.
+   *
+   * @param sequence the number of the packet in the session
+   */
+  void SetSequence (uint32_t sequence);
+
+  /**
+   * @brief Get the sequence number.
+   *
+   * @return the number of the packet in the session
+   */
+  uint32_t GetSequence (void) const;
+
+  /**
+   * @brief Set the number of fragments the packet stands for.
+   *
+   * @param fragments the number of consecutive fragments aggregated in the packet
+   */
+  void SetFragments (uint16_t fragments);
+
+  /**
+   * @brief Get the number of fragments the packet stands for.
+   *
+   * @return the number of consecutive fragments aggregated in the packet, 1 if not aggregated
+   */
+  uint16_t GetFragments (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint8_t m_type; //!< Message type
+  uint8_t m_flags; //!< Flags
+  uint16_t m_videoLevel; //!< Video level
+  uint32_t m_contentId; //!< Content ID
+  uint32_t m_frame; //!< Frame number
+  int64_t m_timestamp; //!< Production time of the frame in nanoseconds
+  uint32_t m_sequence; //!< Sequence number of the packet in the session
+  uint16_t m_fragments; //!< Number of fragments aggregated in the packet
+};
+
+/**
+ * @brief Body of a receiver report.
+ *
+ * A client sends a report every report interval. The loss fraction is the
+ * share of the packets expected in the interval, from the sequence numbers,
+ * that did not arrive, in 1/256 units. The jitter is the smoothed variation
+ * of the packet transit time. The delay trend is the slope of the one-way
+ * delay of the packets of the interval: a positive trend means a queue is
+ * building up on the path.
+ */
+class VideoStreamReportHeader : public Header
+{
+public:
+  static const uint32_t SERIALIZED_SIZE = 21; //!< Size of the serialized header in bytes
+
+  VideoStreamReportHeader ();
+
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Set the duration of the report interval.
+   *
+   * @param duration the time covered by the report
+   */
+  void SetDuration (Time duration);
+
+  /**
+   * @brief Get the duration of the report interval.
+   *
+   * @return the time covered by the report
+   */
+  Time GetDuration (void) const;
+
+  /**
+   * @brief Set the received bytes.
+   *
+   * @param bytes the bytes received in the interval
+   */
+  void SetReceivedBytes (uint32_t bytes);
+
+  /**
+   * @brief Get the received bytes.
+   *
+   * @return the bytes received in the interval
+   */
+  uint32_t GetReceivedBytes (void) const;
+
+  /**
+   * @brief Set the highest sequence number received.
+   *
+   * @param sequence the sequence number
+   */
+  void SetHighestSequence (uint32_t sequence);
+
+  /**
+   * @brief Get the highest sequence number received.
+   *
+   * @return the sequence number
+   */
+  uint32_t GetHighestSequence (void) const;
+
+  /**
+   * @brief Set the loss fraction.
+   *
+   * @param lossFraction the share of the expected packets lost in the interval, between 0 and 1
+   */
+  void SetLossFraction (double lossFraction);
+
+  /**
+   * @brief Get the loss fraction.
+   *
+   * @return the share of the expected packets lost in the interval, between 0 and 1
+   */
+  double GetLossFraction (void) const;
+
+  /**
+   * @brief Set the jitter.
+   *
+   * @param jitter the smoothed transit time variation
+   */
+  void SetJitter (Time jitter);
+
+  /**
+   * @brief Get the jitter.
+   *
+   * @return the smoothed transit time variation
+   */
+  Time GetJitter (void) const;
+
+  /**
+   * @brief Set the delay trend.
+   *
+   * @param delayTrend the one-way delay change per second of the interval
+   */
+  void SetDelayTrend (Time delayTrend);
+
+  /**
+   * @brief Get the delay trend.
+   *
+   * @return the one-way delay change per second of the interval
+   */
+  Time GetDelayTrend (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint32_t m_duration; //!< Duration of the interval in microseconds
+  uint32_t m_receivedBytes; //!< Bytes received in the interval
+  uint32_t m_highestSequence; //!< Highest sequence number received
+  uint8_t m_lossFraction; //!< Loss fraction in 1/256 units
+  uint32_t m_jitter; //!< Jitter in microseconds
+  int32_t m_delayTrend; //!< Delay trend in microseconds per second
+};
+
+/**
+ * @brief Body of a HELLO and of a HELLO_ACK.
+ *
+ * In a HELLO, the client announces the highest video level it can play,
+ * the number of frames its buffer holds (0 if unbounded), the number of
+ * the attempt, 0 for the first HELLO and one more for each retry, and the
+ * tallest rendition it displays (0 for any). In a HELLO_ACK, the server
+ * answers with the highest video level it offers the session, the buffer
+ * capacity it assumed, the attempt it answers, the number of frames of the
+ * title, the interval between two frames and the height of the highest
+ * level it offers.
+ */
+class VideoStreamSessionHeader : public Header
+{
+public:
+  static const uint32_t SERIALIZED_SIZE = 17; //!< Size of the serialized header in bytes
+
+  VideoStreamSessionHeader ();
+
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Set the highest video level.
+   *
+   * @param videoLevel the highest level the client plays or the server offers
+   */
+  void SetMaxVideoLevel (uint16_t videoLevel);
+
+  /**
+   * @brief Get the highest video level.
+   *
+   * @return the highest level the client plays or the server offers
+   */
+  uint16_t GetMaxVideoLevel (void) const;
+
+  /**
+   * @brief Set the buffer capacity.
+   *
+   * @param frames the number of frames the client buffers, 0 if unbounded
+   */
+  void SetBufferCapacity (uint32_t frames);
+
+  /**
+   * @brief Get the buffer capacity.
+   *
+   * @return the number of frames the client buffers, 0 if unbounded
+   */
+  uint32_t GetBufferCapacity (void) const;
+
+  /**
+   * @brief Set the attempt number.
+   *
+   * @param attempt the number of HELLO sent before this one
+   */
+  void SetAttempt (uint8_t attempt);
+
+  /**
+   * @brief Get the attempt number.
+   *
+   * @return the number of HELLO sent before this one
+   */
+  uint8_t GetAttempt (void) const;
+
+  /**
+   * @brief Set the number of frames of the title.
+   *
+   * @param frames the number of frames
+   */
+  void SetTotalFrames (uint32_t frames);
+
+  /**
+   * @brief Get the number of frames of the title.
+   *
+   * @return the number of frames, 0 in a HELLO
+   */
+  uint32_t GetTotalFrames (void) const;
+
+  /**
+   * @brief Set the interval between two frames.
+   *
+   * @param interval the time between two frames sent by the server
+   */
+  void SetFrameInterval (Time interval);
+
+  /**
+   * @brief Get the interval between two frames.
+   *
+   * @return the time between two frames sent by the server, 0 in a HELLO
+   */
+  Time GetFrameInterval (void) const;
+
+  /**
+   * @brief Set the height of the tallest rendition.
+   *
+   * @param height the tallest rendition the client displays or the server offers, in lines
+   */
+  void SetMaxHeight (uint16_t height);
+
+  /**
+   * @brief Get the height of the tallest rendition.
+   *
+   * @return the tallest rendition the client displays or the server offers, in lines, 0 for any
+   */
+  uint16_t GetMaxHeight (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint16_t m_maxVideoLevel; //!< Highest video level
+  uint32_t m_bufferCapacity; //!< Frames the client buffers
+  uint8_t m_attempt; //!< Attempt number
+  uint32_t m_totalFrames; //!< Frames of the title
+  uint32_t m_frameInterval; //!< Interval between two frames in microseconds
+  uint16_t m_maxHeight; //!< Height of the tallest rendition in lines
+};
+
+/**
+ * @brief Bitrate ladder carried by a HELLO_ACK after its VideoStreamSessionHeader.
+ *
+ * The number of renditions is followed by the bitrate, width and height of
+ * each of them, in increasing bitrate; the frame files stay on the server.
+ */
+class VideoStreamLadderHeader : public Header
+{
+public:
+  static const uint32_t RENDITION_SIZE = 12; //!< Size of a serialized rendition in bytes
+
+  VideoStreamLadderHeader ();
+
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Set the ladder.
+   *
+   * @param ladder the renditions of the server
+   */
+  void SetLadder (const VideoStreamLadder &ladder);
+
+  /**
+   * @brief Get the ladder.
+   *
+   * @return the renditions of the server, without their frame files
+   */
+  const VideoStreamLadder &GetLadder (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  VideoStreamLadder m_ladder; //!< Renditions
+};
+
+/**
+ * @brief Body of a REDIRECT.
+ *
+ * The request router names the address and port of the server the client
+ * opens its session with.
+ */
+class VideoStreamRedirectHeader : public Header
+{
+public:
+  static const uint32_t SERIALIZED_SIZE = 6; //!< Size of the serialized header in bytes
+
+  VideoStreamRedirectHeader ();
+
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Set the address of the server.
+   *
+   * @param address the IPv4 address of the server
+   */
+  void SetServerAddress (Ipv4Address address);
+
+  /**
+   * @brief Get the address of the server.
+   *
+   * @return the IPv4 address of the server
+   */
+  Ipv4Address GetServerAddress (void) const;
+
+  /**
+   * @brief Set the port of the server.
+   *
+   * @param port the port the server listens on
+   */
+  void SetServerPort (uint16_t port);
+
+  /**
+   * @brief Get the port of the server.
+   *
+   * @return the port the server listens on
+   */
+  uint16_t GetServerPort (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  Ipv4Address m_serverAddress; //!< Address of the server
+  uint16_t m_serverPort; //!< Port of the server
+};
+
+/**
+ * @brief Body of a LOAD.
+ *
+ * A server reports its active and queued sessions, the bitrate they
+ * reserve, and its admission limits, 0 for no limit.
+ */
+class VideoStreamLoadHeader : public Header
+{
+public:
+  static const uint32_t SERIALIZED_SIZE = 28; //!< Size of the serialized header in bytes
+
+  VideoStreamLoadHeader ();
+
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Set the number of active sessions.
+   *
+   * @param sessions the sessions being streamed
+   */
+  void SetActiveSessions (uint32_t sessions);
+
+  /**
+   * @brief Get the number of active sessions.
+   *
+   * @return the sessions being streamed
+   */
+  uint32_t GetActiveSessions (void) const;
+
+  /**
+   * @brief Set the length of the admission queue.
+   *
+   * @param sessions the sessions waiting for admission
+   */
+  void SetQueueLength (uint32_t sessions);
+
+  /**
+   * @brief Get the length of the admission queue.
+   *
+   * @return the sessions waiting for admission
+   */
+  uint32_t GetQueueLength (void) const;
+
+  /**
+   * @brief Set the largest number of active sessions.
+   *
+   * @param sessions the MaxSessions of the server, 0 for no limit
+   */
+  void SetMaxSessions (uint32_t sessions);
+
+  /**
+   * @brief Get the largest number of active sessions.
+   *
+   * @return the MaxSessions of the server, 0 for no limit
+   */
+  uint32_t GetMaxSessions (void) const;
+
+  /**
+   * @brief Set the bitrate reserved by the active sessions.
+   *
+   * @param rate the reserved egress bitrate
+   */
+  void SetReservedRate (DataRate rate);
+
+  /**
+   * @brief Get the bitrate reserved by the active sessions.
+   *
+   * @return the reserved egress bitrate
+   */
+  DataRate GetReservedRate (void) const;
+
+  /**
+   * @brief Set the egress budget.
+   *
+   * @param rate the EgressBudget of the server, 0 for no limit
+   */
+  void SetEgressBudget (DataRate rate);
+
+  /**
+   * @brief Get the egress budget.
+   *
+   * @return the EgressBudget of the server, 0 for no limit
+   */
+  DataRate GetEgressBudget (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint32_t m_activeSessions; //!< Active sessions
+  uint32_t m_queueLength; //!< Sessions waiting for admission
+  uint32_t m_maxSessions; //!< Largest number of active sessions
+  uint64_t m_reservedRate; //!< Reserved bitrate in bits per second
+  uint64_t m_egressBudget; //!< Egress budget in bits per second
+};
+
+/**
+ * @brief Body of a JOIN.
+ *
+ * A subflow names the session it belongs to by the address and port the
+ * server knows the session socket of the client by.
+ */
+class VideoStreamJoinHeader : public Header
+{
+public:
+  static const uint32_t SERIALIZED_SIZE = 7; //!< Size of the serialized header in bytes
+
+  VideoStreamJoinHeader ();
+
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Set the address of the session.
+   *
+   * @param address the IPv4 address of the session socket of the client
+   */
+  void SetSessionAddress (Ipv4Address address);
+
+  /**
+   * @brief Get the address of the session.
+   *
+   * @return the IPv4 address of the session socket of the client
+   */
+  Ipv4Address GetSessionAddress (void) const;
+
+  /**
+   * @brief Set the port of the session.
+   *
+   * @param port the port of the session socket of the client
+   */
+  void SetSessionPort (uint16_t port);
+
+  /**
+   * @brief Get the port of the session.
+   *
+   * @return the port of the session socket of the client
+   */
+  uint16_t GetSessionPort (void) const;
+
+  /**
+   * @brief Set the path of the subflow.
+   *
+   * @param path the path index chosen by the client, 0 being the session socket
+   */
+  void SetPath (uint8_t path);
+
+  /**
+   * @brief Get the path of the subflow.
+   *
+   * @return the path index chosen by the client, 0 being the session socket
+   */
+  uint8_t GetPath (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  Ipv4Address m_sessionAddress; //!< Address of the session socket
+  uint16_t m_sessionPort; //!< Port of the session socket
+  uint8_t m_path; //!< Path index
+};
+
+/**
+ * @brief Body of a PATH_REPORT.
+ *
+ * The bytes a path delivered in the report interval and their mean one-way
+ * delay, from which the server estimates the rate and the delay of the path.
+ */
+class VideoStreamPathReportHeader : public Header
+{
+public:
+  static const uint32_t SERIALIZED_SIZE = 12; //!< Size of the serialized header in bytes
+
+  VideoStreamPathReportHeader ();
+
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief Set the duration of the report interval.
+   *
+   * @param duration the duration, with a microsecond resolution
+   */
+  void SetDuration (Time duration);
+
+  /**
+   * @brief Get the duration of the report interval.
+   *
+   * @return the duration
+   */
+  Time GetDuration (void) const;
+
+  /**
+   * @brief Set the bytes received on the path.
+   *
+   * @param bytes the bytes received in the interval
+   */
+  void SetReceivedBytes (uint32_t bytes);
+
+  /**
+   * @brief Get the bytes received on the path.
+   *
+   * @return the bytes received in the interval
+   */
+  uint32_t GetReceivedBytes (void) const;
+
+  /**
+   * @brief Set the mean one-way delay of the path.
+   *
+   * @param delay the delay, with a microsecond resolution
+   */
+  void SetDelay (Time delay);
+
+  /**
+   * @brief Get the mean one-way delay of the path.
+   *
+   * @return the delay, zero if nothing was received in the interval
+   */
+  Time GetDelay (void) const;
+
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+private:
+  uint32_t m_duration; //!< Duration of the interval in microseconds
+  uint32_t m_receivedBytes; //!< Bytes received in the interval
+  uint32_t m_delay; //!< Mean one-way delay in microseconds
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_HEADER_H */
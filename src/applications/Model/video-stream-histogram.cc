@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "video-stream-histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamHistogram");
+
+VideoStreamHistogram::VideoStreamHistogram ()
+{
+  Reset ();
+}
+
+void
+VideoStreamHistogram::Reset (void)
+{
+  m_counts.clear ();
+  m_count = 0;
+  m_min = 0;
+  m_max = 0;
+  m_sum = 0;
+}
+
+uint32_t
+VideoStreamHistogram::GetBucket (uint64_t value)
+{
+  if (value < SUB_BUCKET_COUNT)
+  {
+    return value;
+  }
+  if (value >> MAX_MAGNITUDE)
+  {
+    return BUCKET_COUNT - 1;
+  }
+  // position of the highest set bit, found in six steps
+  uint32_t magnitude = 0;
+  for (uint32_t step = 32; step > 0; step /= 2)
+  {
+    if (value >> (magnitude + step))
+    {
+      magnitude += step;
+    }
+  }
+  uint32_t shift = magnitude - SUB_BUCKET_BITS;
+  return shift * SUB_BUCKET_COUNT + (value >> shift);
+}
+
+uint64_t
+VideoStreamHistogram::GetBucketStart (uint32_t bucket)
+{
+  if (bucket < SUB_BUCKET_COUNT)
+  {
+    return bucket;
+  }
+  uint32_t shift = bucket / SUB_BUCKET_COUNT - 1;
+  return static_cast<uint64_t> (bucket % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT) << shift;
+}
+
+void
+VideoStreamHistogram::Record (Time value)
+{
+  uint64_t ns = value.IsStrictlyPositive () ? value.GetNanoSeconds () : 0;
+  if (m_counts.empty ())
+  {
+    m_counts.assign (BUCKET_COUNT, 0);
+  }
+  m_counts[GetBucket (ns)]++;
+  m_min = m_count == 0 ? ns : std::min (m_min, ns);
+  m_max = std::max (m_max, ns);
+  m_count++;
+  m_sum += ns;
+}
+
+void
+VideoStreamHistogram::Merge (const VideoStreamHistogram &other)
+{
+  if (other.m_count == 0)
+  {
+    return;
+  }
+  if (m_counts.empty ())
+  {
+    m_counts.assign (BUCKET_COUNT, 0);
+  }
+  for (uint32_t i = 0; i < BUCKET_COUNT; i++)
+  {
+    m_counts[i] += other.m_counts[i];
+  }
+  m_min = m_count == 0 ? other.m_min : std::min (m_min, other.m_min);
+  m_max = std::max (m_max, other.m_max);
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+}
+
+Time
+VideoStreamHistogram::GetMean (void) const
+{
+  if (m_count == 0)
+  {
+    return Seconds (0.0);
+  }
+  return NanoSeconds (m_sum / m_count);
+}
+
+Time
+VideoStreamHistogram::GetPercentile (double percentile) const
+{
+  if (m_count == 0)
+  {
+    return Seconds (0.0);
+  }
+  double rank = std::max (1.0, std::ceil (std::min (percentile, 100.0) / 100.0 * m_count));
+  uint64_t seen = 0;
+  uint32_t bucket = 0;
+  for (; bucket + 1 < BUCKET_COUNT; bucket++)
+  {
+    seen += m_counts[bucket];
+    if (seen >= rank)
+    {
+      break;
+    }
+  }
+  uint64_t start = GetBucketStart (bucket);
+  uint64_t width = bucket < SUB_BUCKET_COUNT ? 1 : GetBucketStart (bucket + 1) - start;
+  uint64_t value = std::max (m_min, std::min (m_max, start + width / 2));
+  return NanoSeconds (value);
+}
+
+void
+VideoStreamHistogram::Save (std::ostream &os) const
+{
+  os << "histogram " << SUB_BUCKET_BITS << " " << m_count << " " << m_min << " " << m_max << " " << m_sum << "\n";
+  for (uint32_t i = 0; i < m_counts.size (); i++)
+  {
+    if (m_counts[i] > 0)
+    {
+      os << i << " " << m_counts[i] << "\n";
+    }
+  }
+  os << "end\n";
+}
+
+bool
+VideoStreamHistogram::Load (std::istream &is)
+{
+  Reset ();
+  std::string tag;
+  uint32_t bits;
+  if (!(is >> tag >> bits >> m_count >> m_min >> m_max >> m_sum) || tag != "histogram" || bits != SUB_BUCKET_BITS)
+  {
+    NS_LOG_WARN ("Not a saved histogram with " << SUB_BUCKET_BITS << " sub-bucket bits");
+    Reset ();
+    return false;
+  }
+  m_counts.assign (BUCKET_COUNT, 0);
+  std::string bucket;
+  uint32_t count;
+  while (is >> bucket && bucket != "end")
+  {
+    char *end;
+    unsigned long index = std::strtoul (bucket.c_str (), &end, 10);
+    if (*end != '\0' || index >= BUCKET_COUNT || !(is >> count))
+    {
+      Reset ();
+      return false;
+    }
+    m_counts[index] = count;
+  }
+  return true;
+}
+
+void
+VideoStreamHistogram::Print (std::ostream &os) const
+{
+  os << "count " << m_count
+     << ", mean " << GetMean ().GetSeconds () * 1000 << " ms"
+     << ", p50 " << GetPercentile (50).GetSeconds () * 1000 << " ms"
+     << ", p90 " << GetPercentile (90).GetSeconds () * 1000 << " ms"
+     << ", p99 " << GetPercentile (99).GetSeconds () * 1000 << " ms"
+     << ", max " << GetMax ().GetSeconds () * 1000 << " ms";
+}
+
+} // namespace ns3
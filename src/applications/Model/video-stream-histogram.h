@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_HISTOGRAM_H
+#define VIDEO_STREAM_HISTOGRAM_H
+
+#include "ns3/nstime.h"
+
+#include <stdint.h>
+#include <iostream>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @brief Log-bucketed histogram of durations.
+ *
+ * The buckets follow the layout of HDR histograms: values are counted in
+ * nanoseconds, each power of two is split into SUB_BUCKET_COUNT linear
+ * sub-buckets and the values below SUB_BUCKET_COUNT have a bucket each, so
+ * any value is known within 1/SUB_BUCKET_COUNT of its magnitude. The buckets
+ * stop at 2^MAX_MAGNITUDE ns, about 18 minutes, and the larger values are
+ * counted in the last bucket; the count, minimum, maximum and mean stay
+ * exact. The counts are allocated at the first value, so a histogram that
+ * records nothing costs a few words, and recording takes constant time.
+ * Histograms of different sessions are combined with Merge, and those of
+ * different runs by saving them with Save and merging the result of Load.
+ */
+class VideoStreamHistogram
+{
+public:
+  static const uint32_t SUB_BUCKET_BITS = 5; //!< Bits of precision below the magnitude
+  static const uint32_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS; //!< Sub-buckets per power of two
+  static const uint32_t MAX_MAGNITUDE = 40; //!< Power of two in nanoseconds above which the values share the last bucket
+  static const uint32_t BUCKET_COUNT = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT; //!< Buckets up to 2^MAX_MAGNITUDE ns
+
+  VideoStreamHistogram ();
+
+  /**
+   * @brief Remove every value.
+   */
+  void Reset (void);
+
+  /**
+   * @brief Count a value.
+   *
+   * @param value the value, negative values are counted as zero
+   */
+  void Record (Time value);
+
+  /**
+   * @brief Add the values of another histogram.
+   *
+   * @param other the histogram to add
+   */
+  void Merge (const VideoStreamHistogram &other);
+
+  uint64_t GetCount (void) const { return m_count; } //!< @return the number of values
+  Time GetMin (void) const { return NanoSeconds (m_min); } //!< @return the smallest value, zero without values
+  Time GetMax (void) const { return NanoSeconds (m_max); } //!< @return the largest value, zero without values
+
+  /**
+   * @brief Get the mean of the values.
+   *
+   * @return the exact mean, zero without values
+   */
+  Time GetMean (void) const;
+
+  /**
+   * @brief Get a percentile of the values.
+   *
+   * @param percentile the percentile, from 0 to 100
+   * @return the middle of the bucket holding the percentile, within the smallest and the largest value
+   */
+  Time GetPercentile (double percentile) const;
+
+  /**
+   * @brief Write the histogram as text, one line per non-empty bucket.
+   *
+   * @param os the output stream
+   */
+  void Save (std::ostream &os) const;
+
+  /**
+   * @brief Replace the histogram by one written with Save.
+   *
+   * @param is the input stream
+   * @return false if the stream is not a saved histogram
+   */
+  bool Load (std::istream &is);
+
+  /**
+   * @brief Print the count, mean, p50, p90, p99 and maximum.
+   *
+   * @param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+private:
+  /**
+   * @brief Get the bucket of a value.
+   *
+   * @param value the value in nanoseconds
+   * @return the bucket index, the last one for the values from 2^MAX_MAGNITUDE ns
+   */
+  static uint32_t GetBucket (uint64_t value);
+
+  /**
+   * @brief Get the smallest value of a bucket.
+   *
+   * @param bucket the bucket index
+   * @return the value in nanoseconds
+   */
+  static uint64_t GetBucketStart (uint32_t bucket);
+
+  std::vector<uint32_t> m_counts; //!< Number of values of each bucket, empty until the first value
+  uint64_t m_count; //!< Number of values
+  uint64_t m_min; //!< Smallest value in nanoseconds
+  uint64_t m_max; //!< Largest value in nanoseconds
+  uint64_t m_sum; //!< Sum of the values in nanoseconds
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_HISTOGRAM_H */
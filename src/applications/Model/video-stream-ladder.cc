@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "video-stream-ladder.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamLadder");
+
+/**
+ * @brief Parse a width or a height.
+ *
+ * @param text the decimal number
+ * @param pixels the number, set on success
+ * @return true if the text is a number below 2^16
+ */
+static bool
+ParsePixels (const std::string &text, uint16_t &pixels)
+{
+  if (text.empty () || !std::isdigit (static_cast<unsigned char> (text[0])))
+  {
+    return false;
+  }
+  char *end;
+  unsigned long value = std::strtoul (text.c_str (), &end, 10);
+  if (*end != '\0' || value > 65535)
+  {
+    return false;
+  }
+  pixels = value;
+  return true;
+}
+
+VideoStreamLadder::VideoStreamLadder ()
+{
+}
+
+VideoStreamLadder::VideoStreamLadder (std::string ladder)
+{
+  std::istringstream renditions (ladder);
+  std::string rendition;
+  while (std::getline (renditions, rendition, ';'))
+  {
+    rendition.erase (0, rendition.find_first_not_of (" \t\r\n"));
+    rendition.erase (rendition.find_last_not_of (" \t\r\n") + 1);
+    if (rendition.empty ())
+    {
+      continue;
+    }
+    std::string::size_type by = rendition.find ('x');
+    std::string::size_type at = rendition.find ('@');
+    std::string::size_type comma = rendition.find (',');
+    uint16_t width = 0;
+    uint16_t height = 0;
+    if (by == std::string::npos || at == std::string::npos || by > at || (comma != std::string::npos && comma < at)
+        || !ParsePixels (rendition.substr (0, by), width) || !ParsePixels (rendition.substr (by + 1, at - by - 1), height))
+    {
+      NS_FATAL_ERROR ("Malformed rendition \"" << rendition << "\", expected WIDTHxHEIGHT@BITRATE[,FRAMEFILE]");
+    }
+    std::string bitRate = rendition.substr (at + 1, comma == std::string::npos ? std::string::npos : comma - at - 1);
+    std::string frameFile = comma == std::string::npos ? "" : rendition.substr (comma + 1);
+    AddRendition (DataRate (bitRate), width, height, frameFile);
+  }
+}
+
+void
+VideoStreamLadder::Clear (void)
+{
+  m_renditions.clear ();
+}
+
+void
+VideoStreamLadder::AddRendition (DataRate bitRate, uint16_t width, uint16_t height, std::string frameFile)
+{
+  if (bitRate.GetBitRate () == 0 || (!m_renditions.empty () && bitRate <= m_renditions.back ().m_bitRate))
+  {
+    // the level of a session goes up with its bitrate
+    NS_FATAL_ERROR ("The renditions of a ladder need increasing, non-zero bitrates");
+  }
+  Rendition rendition;
+  rendition.m_bitRate = bitRate;
+  rendition.m_width = width;
+  rendition.m_height = height;
+  rendition.m_frameFile = frameFile;
+  m_renditions.push_back (rendition);
+}
+
+uint16_t
+VideoStreamLadder::GetLevelCount (void) const
+{
+  return m_renditions.size ();
+}
+
+const VideoStreamLadder::Rendition &
+VideoStreamLadder::GetRendition (uint16_t videoLevel) const
+{
+  NS_ASSERT_MSG (videoLevel >= 1 && videoLevel <= m_renditions.size (), "Video level " << videoLevel << " is not in the ladder");
+  return m_renditions[videoLevel - 1];
+}
+
+double
+VideoStreamLadder::GetScale (uint16_t videoLevel) const
+{
+  return static_cast<double> (GetRendition (videoLevel).m_bitRate.GetBitRate ()) / m_renditions.front ().m_bitRate.GetBitRate ();
+}
+
+uint16_t
+VideoStreamLadder::GetMaxLevel (uint16_t maxHeight) const
+{
+  uint16_t videoLevel = 1;
+  for (uint16_t level = 1; level <= m_renditions.size (); level++)
+  {
+    if (maxHeight == 0 || m_renditions[level - 1].m_height <= maxHeight)
+    {
+      videoLevel = level;
+    }
+  }
+  return videoLevel;
+}
+
+std::string
+VideoStreamLadder::ToString (void) const
+{
+  std::ostringstream os;
+  for (uint32_t i = 0; i < m_renditions.size (); i++)
+  {
+    const Rendition &rendition = m_renditions[i];
+    os << (i > 0 ? ";" : "") << rendition.m_width << "x" << rendition.m_height << "@" << rendition.m_bitRate.GetBitRate () << "bps";
+    if (!rendition.m_frameFile.empty ())
+    {
+      os << "," << rendition.m_frameFile;
+    }
+  }
+  return os.str ();
+}
+
+std::ostream &
+operator << (std::ostream &os, const VideoStreamLadder &ladder)
+{
+  return os << ladder.ToString ();
+}
+
+} // namespace ns3
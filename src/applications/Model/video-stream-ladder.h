@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_LADDER_H
+#define VIDEO_STREAM_LADDER_H
+
+#include "ns3/data-rate.h"
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * @brief Bitrate ladder of the video levels.
+ *
+ * Video level n is the nth rendition of the ladder, in increasing bitrate.
+ * A rendition has a bitrate, a resolution and optionally its own frame file.
+ * A ladder is written as its renditions separated by semicolons, each as
+ * WIDTHxHEIGHT@BITRATE with an optional ,FRAMEFILE, for instance
+ * "640x360@1Mbps;1280x720@3Mbps,720p.txt;1920x1080@6Mbps".
+ */
+class VideoStreamLadder
+{
+public:
+  /**
+   * @brief A rendition of the title.
+   */
+  struct Rendition
+  {
+    DataRate m_bitRate; //!< Mean bitrate
+    uint16_t m_width; //!< Width in pixels
+    uint16_t m_height; //!< Height in lines
+    std::string m_frameFile; //!< Frame file of the rendition, empty to scale the frame sizes of the title
+  };
+
+  VideoStreamLadder ();
+
+  /**
+   * @brief Construct a ladder from its description.
+   *
+   * @param ladder the renditions, see the class description
+   */
+  VideoStreamLadder (std::string ladder);
+
+  /**
+   * @brief Remove every rendition.
+   */
+  void Clear (void);
+
+  /**
+   * @brief Add a rendition above the others.
+   *
+   * @param bitRate the mean bitrate, higher than the bitrate of the other renditions
+   * @param width the width in pixels
+   * @param height the height in lines
+   * @param frameFile the frame file of the rendition, empty to scale the frame sizes of the title
+   */
+  void AddRendition (DataRate bitRate, uint16_t width, uint16_t height, std::string frameFile = "");
+
+  /**
+   * @brief Get the number of video levels.
+   *
+   * @return the number of renditions
+   */
+  uint16_t GetLevelCount (void) const;
+
+  /**
+   * @brief Get the rendition of a video level.
+   *
+   * @param videoLevel the video level, from 1 to GetLevelCount
+   * @return the rendition
+   */
+  const Rendition &GetRendition (uint16_t videoLevel) const;
+
+  /**
+   * @brief Get the bitrate of a video level over the bitrate of level 1.
+   *
+   * @param videoLevel the video level, from 1 to GetLevelCount
+   * @return the scale of the frame sizes of the level
+   */
+  double GetScale (uint16_t videoLevel) const;
+
+  /**
+   * @brief Get the highest video level a display shows.
+   *
+   * @param maxHeight the tallest rendition the display shows, 0 for any
+   * @return the highest level at most maxHeight lines tall, 1 if none is
+   */
+  uint16_t GetMaxLevel (uint16_t maxHeight) const;
+
+  /**
+   * @brief Get the description of the ladder.
+   *
+   * @return the renditions, see the class description
+   */
+  std::string ToString (void) const;
+
+private:
+  std::vector<Rendition> m_renditions; //!< Renditions in increasing bitrate
+};
+
+/**
+ * @brief Print a ladder.
+ *
+ * @param os the output stream
+ * @param ladder the ladder
+ * @return the output stream
+ */
+std::ostream &operator << (std::ostream &os, const VideoStreamLadder &ladder);
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_LADDER_H */
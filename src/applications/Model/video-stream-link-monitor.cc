@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "video-stream-link-monitor.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamLinkMonitor");
+
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamLinkMonitor);
+
+// Weights of a new sample in the moving averages
+static const double SNR_WEIGHT = 1.0 / 8;
+static const double RETRY_WEIGHT = 1.0 / 16;
+
+TypeId
+VideoStreamLinkMonitor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamLinkMonitor")
+    .SetParent<Object> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamLinkMonitor> ()
+  ;
+  return tid;
+}
+
+VideoStreamLinkMonitor::VideoStreamLinkMonitor ()
+{
+  NS_LOG_FUNCTION (this);
+  m_snr = 0.0;
+  m_phyRate = DataRate (0);
+  m_retryRate = 0.0;
+  m_receivedFrames = 0;
+}
+
+VideoStreamLinkMonitor::~VideoStreamLinkMonitor ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+VideoStreamLinkMonitor::RecordReception (double snr, bool data, DataRate phyRate, std::string mode, bool retry)
+{
+  m_snr = m_receivedFrames == 0 ? snr : (1 - SNR_WEIGHT) * m_snr + SNR_WEIGHT * snr;
+  m_receivedFrames++;
+  if (data)
+  {
+    m_phyRate = phyRate;
+    m_mode = mode;
+    m_retryRate = (1 - RETRY_WEIGHT) * m_retryRate + (retry ? RETRY_WEIGHT : 0.0);
+  }
+}
+
+void
+VideoStreamLinkMonitor::RecordTransmission (bool failed)
+{
+  m_retryRate = (1 - RETRY_WEIGHT) * m_retryRate + (failed ? RETRY_WEIGHT : 0.0);
+}
+
+double
+VideoStreamLinkMonitor::GetSnr (void) const
+{
+  return m_snr;
+}
+
+DataRate
+VideoStreamLinkMonitor::GetPhyRate (void) const
+{
+  return m_phyRate;
+}
+
+std::string
+VideoStreamLinkMonitor::GetMode (void) const
+{
+  return m_mode;
+}
+
+double
+VideoStreamLinkMonitor::GetRetryRate (void) const
+{
+  return m_retryRate;
+}
+
+uint32_t
+VideoStreamLinkMonitor::GetReceivedFrames (void) const
+{
+  return m_receivedFrames;
+}
+
+} // namespace ns3
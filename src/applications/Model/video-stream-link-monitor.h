@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_LINK_MONITOR_H
+#define VIDEO_STREAM_LINK_MONITOR_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/data-rate.h"
+
+#include <string>
+
+namespace ns3 {
+
+/**
+ * @brief The state of the link of a node, the hints a video stream client
+ * adapts its level to.
+ *
+ * The link model feeds the monitor: every frame its PHY receives gives an
+ * SNR sample with RecordReception, and the data frames addressed to the node
+ * also give their PHY rate, the name of their mode and a retry sample, set
+ * if the frame is a retransmission; every data frame the node sends gives a
+ * retry sample too with RecordTransmission, set for each failed attempt.
+ * The SNR and the retry rate are exponentially weighted moving averages of
+ * the samples, with weights 1/8 and 1/16. The monitor knows no link model;
+ * VideoStreamWifiHintsHelper of the video-stream-wifi module feeds it from
+ * the trace sources of the Wi-Fi devices of a node.
+ */
+class VideoStreamLinkMonitor : public Object
+{
+public:
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VideoStreamLinkMonitor ();
+
+  virtual ~VideoStreamLinkMonitor ();
+
+  /**
+   * @brief Count a frame received by the PHY.
+   *
+   * @param snr the SNR of the frame in dB
+   * @param data whether the frame is a data frame addressed to the node
+   * @param phyRate the data rate of the mode of the frame
+   * @param mode the name of the mode of the frame
+   * @param retry whether the frame is a retransmission
+   */
+  void RecordReception (double snr, bool data, DataRate phyRate, std::string mode, bool retry);
+
+  /**
+   * @brief Count a transmission attempt of a data frame.
+   *
+   * @param failed whether the attempt failed
+   */
+  void RecordTransmission (bool failed);
+
+  /**
+   * @brief Get the smoothed SNR.
+   *
+   * @return the SNR in dB, 0 before the first frame
+   */
+  double GetSnr (void) const;
+
+  /**
+   * @brief Get the data rate of the last data frame received.
+   *
+   * @return the data rate of its mode, 0 before the first data frame
+   */
+  DataRate GetPhyRate (void) const;
+
+  /**
+   * @brief Get the mode of the last data frame received.
+   *
+   * @return the name of the mode, empty before the first data frame
+   */
+  std::string GetMode (void) const;
+
+  /**
+   * @brief Get the smoothed retry rate.
+   *
+   * @return the share of the data frames that were retransmissions or failed attempts
+   */
+  double GetRetryRate (void) const;
+
+  /**
+   * @brief Get the number of frames received.
+   *
+   * @return the number of frames that gave an SNR sample
+   */
+  uint32_t GetReceivedFrames (void) const;
+
+private:
+  double m_snr; //!< Smoothed SNR in dB
+  DataRate m_phyRate; //!< Data rate of the mode of the last data frame
+  std::string m_mode; //!< Mode of the last data frame
+  double m_retryRate; //!< Smoothed retry rate
+  uint32_t m_receivedFrames; //!< Number of frames received
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_LINK_MONITOR_H */
@@ -0,0 +1,553 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/trace-source-accessor.h"
+#include "video-stream-proxy.h"
+#include "video-stream-header.h"
+#include "video-stream-server.h"
+
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamProxyApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamProxy);
+
+TypeId
+VideoStreamProxy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamProxy")
+    .SetParent<Application> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamProxy> ()
+    .AddAttribute ("Port", "Port on which the clients are accepted",
+                    UintegerValue (6969),
+                    MakeUintegerAccessor (&VideoStreamProxy::m_port),
+                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("RemoteAddress", "The address of the origin server",
+                    AddressValue (),
+                    MakeAddressAccessor (&VideoStreamProxy::m_originAddress),
+                    MakeAddressChecker ())
+    .AddAttribute ("RemotePort", "The port of the origin server",
+                    UintegerValue (6969),
+                    MakeUintegerAccessor (&VideoStreamProxy::m_originPort),
+                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Interval", "The time to wait between two frames sent to a client",
+                    TimeValue (Seconds (0.01)),
+                    MakeTimeAccessor (&VideoStreamProxy::m_interval),
+                    MakeTimeChecker ())
+    .AddAttribute ("MaxPacketSize", "The maximum size of a packet sent to a client",
+                    UintegerValue (1400),
+                    MakeUintegerAccessor (&VideoStreamProxy::m_maxPacketSize),
+                    MakeUintegerChecker<uint16_t> (VideoStreamHeader::SERIALIZED_SIZE))
+    .AddAttribute ("CacheSize", "The byte budget of the frame cache",
+                    UintegerValue (100000000),
+                    MakeUintegerAccessor (&VideoStreamProxy::m_cacheSize),
+                    MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("CachePolicy", "The replacement policy of the frame cache",
+                    EnumValue (VideoStreamCache::LRU),
+                    MakeEnumAccessor (&VideoStreamProxy::m_cachePolicy),
+                    MakeEnumChecker (VideoStreamCache::LRU, "LRU",
+                                     VideoStreamCache::LFU, "LFU",
+                                     VideoStreamCache::ARC, "ARC"))
+    .AddTraceSource ("Tx", "A new packet is created and is sent to a client",
+                     MakeTraceSourceAccessor (&VideoStreamProxy::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+VideoStreamProxy::VideoStreamProxy ()
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_originBytes = 0;
+  m_servedBytes = 0;
+  m_originMaxLevel = 0;
+}
+
+VideoStreamProxy::~VideoStreamProxy ()
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+}
+
+void
+VideoStreamProxy::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (auto &client : m_clients)
+  {
+    delete client.second;
+  }
+  m_clients.clear ();
+  for (auto &fetch : m_fetches)
+  {
+    CloseFetch (fetch.second);
+    delete fetch.second;
+  }
+  m_fetches.clear ();
+  Application::DoDispose ();
+}
+
+const VideoStreamCache &
+VideoStreamProxy::GetCache (void) const
+{
+  return m_cache;
+}
+
+double
+VideoStreamProxy::GetHitRatio (void) const
+{
+  return m_cache.GetHitRatio ();
+}
+
+uint64_t
+VideoStreamProxy::GetOriginBytes (void) const
+{
+  return m_originBytes;
+}
+
+uint64_t
+VideoStreamProxy::GetServedBytes (void) const
+{
+  return m_servedBytes;
+}
+
+double
+VideoStreamProxy::GetOriginOffload (void) const
+{
+  if (m_servedBytes == 0)
+  {
+    return 0.0;
+  }
+  return 1.0 - static_cast<double> (m_originBytes) / m_servedBytes;
+}
+
+void
+VideoStreamProxy::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_cache.Reset (m_cacheSize, m_cachePolicy);
+  if (m_socket == 0)
+  {
+    TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+    m_socket = Socket::CreateSocket (GetNode (), tid);
+    InetSocketAddress local = InetSocketAddress (Ipv4Address::GetAny (), m_port);
+    if (m_socket->Bind (local) == -1)
+    {
+      NS_FATAL_ERROR ("Failed to bind socket");
+    }
+  }
+  m_socket->SetRecvCallback (MakeCallback (&VideoStreamProxy::HandleRead, this));
+}
+
+void
+VideoStreamProxy::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_socket != 0)
+  {
+    m_socket->Close ();
+    m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket>> ());
+    m_socket = 0;
+  }
+  for (auto &client : m_clients)
+  {
+    Simulator::Cancel (client.second->m_sendEvent);
+  }
+  for (auto &fetch : m_fetches)
+  {
+    CloseFetch (fetch.second);
+  }
+
+  NS_LOG_INFO ("Proxy hit ratio " << GetHitRatio () << ", origin offload " << GetOriginOffload ()
+               << ", " << m_cache.GetEvictions () << " evictions");
+}
+
+void
+VideoStreamProxy::Send (uint64_t clientKey)
+{
+  NS_LOG_FUNCTION (this);
+
+  ClientInfo *client = m_clients.at (clientKey);
+  auto titleFrames = m_titleFrames.find (client->m_contentId);
+  if (titleFrames != m_titleFrames.end () && client->m_sent >= titleFrames->second)
+  {
+    return;
+  }
+
+  // a frame counts as one hit or one miss, however long the client waits for it
+  uint64_t key = VideoStreamCache::GetKey (client->m_contentId, client->m_videoLevel, client->m_sent);
+  uint32_t frameSize = 0;
+  bool cached = client->m_waiting ? m_cache.Peek (key, frameSize) : m_cache.Lookup (key, frameSize);
+  if (cached)
+  {
+    client->m_waiting = false;
+    SendFrame (client, frameSize);
+    client->m_sent++;
+  }
+  else
+  {
+    client->m_waiting = true;
+    RequestFrame (client->m_contentId, client->m_videoLevel, client->m_sent);
+  }
+  client->m_sendEvent = Simulator::Schedule (m_interval, &VideoStreamProxy::Send, this, clientKey);
+}
+
+void
+VideoStreamProxy::SendFrame (ClientInfo *client, uint32_t frameSize)
+{
+  auto titleFrames = m_titleFrames.find (client->m_contentId);
+  bool lastFrame = titleFrames != m_titleFrames.end () && client->m_sent + 1 == titleFrames->second;
+
+  // same fragmentation as the origin, so the clients see identical packets
+  uint32_t headerSize = VideoStreamHeader::SERIALIZED_SIZE;
+  uint32_t packets = (frameSize + m_maxPacketSize - 1) / m_maxPacketSize;
+  uint32_t lastSize = frameSize - (packets - 1) * m_maxPacketSize;
+  uint32_t borrowed = packets > 1 && lastSize < headerSize ? headerSize - lastSize : 0;
+  for (uint32_t i = 0; i < packets; i++)
+  {
+    uint32_t packetSize = m_maxPacketSize;
+    uint8_t flags = lastFrame ? VideoStreamHeader::LAST_FRAME : 0;
+    if (i + 2 == packets)
+    {
+      packetSize -= borrowed;
+    }
+    else if (i + 1 == packets)
+    {
+      packetSize = lastSize + borrowed;
+      flags |= VideoStreamHeader::LAST_FRAGMENT;
+    }
+    if (client->m_discontinuity)
+    {
+      flags |= VideoStreamHeader::DISCONTINUITY;
+      client->m_discontinuity = false;
+    }
+
+    VideoStreamHeader header;
+    header.SetMessageType (VideoStreamHeader::DATA);
+    header.SetFlags (flags);
+    header.SetVideoLevel (client->m_videoLevel);
+    header.SetContentId (client->m_contentId);
+    header.SetFrame (client->m_sent);
+    header.SetTimestamp (Simulator::Now ());
+    header.SetSequence (client->m_sequence++);
+    header.SetFragments (1);
+    Ptr<Packet> p = Create<Packet> (packetSize > headerSize ? packetSize - headerSize : 0);
+    p->AddHeader (header);
+    m_txTrace (p);
+    m_socket->SendTo (p, 0, client->m_address);
+  }
+  m_servedBytes += frameSize;
+}
+
+void
+VideoStreamProxy::SendHelloAck (ClientInfo *client)
+{
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::HELLO_ACK);
+  header.SetContentId (client->m_contentId);
+  header.SetVideoLevel (client->m_videoLevel);
+  header.SetFrame (client->m_sent);
+  header.SetSequence (m_maxPacketSize);
+  VideoStreamSessionHeader session;
+  session.SetMaxVideoLevel (client->m_maxLevel);
+  auto titleFrames = m_titleFrames.find (client->m_contentId);
+  session.SetTotalFrames (titleFrames != m_titleFrames.end () ? titleFrames->second : 0);
+  session.SetFrameInterval (m_interval);
+  session.SetMaxHeight (m_originLadder.GetRendition (client->m_maxLevel).m_height);
+  VideoStreamLadderHeader ladder;
+  ladder.SetLadder (m_originLadder);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (ladder);
+  p->AddHeader (session);
+  p->AddHeader (header);
+  m_socket->SendTo (p, 0, client->m_address);
+}
+
+void
+VideoStreamProxy::AcceptClient (uint64_t clientKey)
+{
+  ClientInfo *client = m_clients.at (clientKey);
+  // the same bounds as the origin would give the client
+  client->m_maxLevel = std::min (m_originMaxLevel, m_originLadder.GetMaxLevel (client->m_maxHeight));
+  if (client->m_announcedLevel > 0)
+  {
+    client->m_maxLevel = std::min (client->m_maxLevel, client->m_announcedLevel);
+  }
+  client->m_videoLevel = std::min (client->m_videoLevel, client->m_maxLevel);
+  SendHelloAck (client);
+  client->m_sendEvent = Simulator::Schedule (Seconds (0.0), &VideoStreamProxy::Send, this, clientKey);
+}
+
+void
+VideoStreamProxy::RequestFrame (uint32_t contentId, uint16_t videoLevel, uint32_t frame)
+{
+  uint64_t fetchKey = VideoStreamCache::GetKey (contentId, videoLevel, 0);
+  Fetch *fetch;
+  auto iter = m_fetches.find (fetchKey);
+  if (iter == m_fetches.end ())
+  {
+    fetch = new Fetch ();
+    fetch->m_contentId = contentId;
+    fetch->m_videoLevel = videoLevel;
+    m_fetches[fetchKey] = fetch;
+  }
+  else
+  {
+    fetch = iter->second;
+    if (fetch->m_socket != 0 && fetch->m_frame <= frame)
+    {
+      // the running upstream session will bring the frame
+      return;
+    }
+    CloseFetch (fetch);
+  }
+
+  NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s proxy fetches title " << contentId
+                << " level " << videoLevel << " from frame " << frame);
+  TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+  fetch->m_socket = Socket::CreateSocket (GetNode (), tid);
+  if (fetch->m_socket->Bind () == -1)
+  {
+    NS_FATAL_ERROR ("Failed to bind socket");
+  }
+  if (InetSocketAddress::IsMatchingType (m_originAddress))
+  {
+    fetch->m_socket->Connect (m_originAddress);
+  }
+  else
+  {
+    fetch->m_socket->Connect (InetSocketAddress (Ipv4Address::ConvertFrom (m_originAddress), m_originPort));
+  }
+  fetch->m_socket->SetRecvCallback (MakeCallback (&VideoStreamProxy::HandleOriginRead, this));
+  fetch->m_frame = frame;
+  fetch->m_bytes = 0;
+
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::HELLO);
+  header.SetContentId (contentId);
+  header.SetVideoLevel (videoLevel);
+  header.SetFrame (frame);
+  Ptr<Packet> hello = Create<Packet> ();
+  hello->AddHeader (header);
+  fetch->m_socket->Send (hello);
+}
+
+void
+VideoStreamProxy::CloseFetch (Fetch *fetch)
+{
+  if (fetch->m_socket != 0)
+  {
+    // end the origin session, it may still be streaming
+    VideoStreamHeader header;
+    header.SetMessageType (VideoStreamHeader::BYE);
+    Ptr<Packet> bye = Create<Packet> ();
+    bye->AddHeader (header);
+    fetch->m_socket->Send (bye);
+    fetch->m_socket->Close ();
+    fetch->m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket>> ());
+    fetch->m_socket = 0;
+  }
+}
+
+void
+VideoStreamProxy::HandleOriginAck (Ptr<const Packet> packet)
+{
+  VideoStreamHeader header;
+  VideoStreamSessionHeader session;
+  VideoStreamLadderHeader ladder;
+  if (packet->GetSize () < header.GetSerializedSize () + session.GetSerializedSize () + ladder.GetSerializedSize ())
+  {
+    return;
+  }
+  Ptr<Packet> ack = packet->Copy ();
+  ack->RemoveHeader (header);
+  ack->RemoveHeader (session);
+  ack->RemoveHeader (ladder);
+  if (session.GetMaxVideoLevel () == 0 || ladder.GetLadder ().GetLevelCount () < session.GetMaxVideoLevel ())
+  {
+    return;
+  }
+  m_originLadder = ladder.GetLadder ();
+  m_originMaxLevel = session.GetMaxVideoLevel ();
+  NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s proxy learnt the ladder of the origin: " << m_originLadder);
+  for (auto &client : m_clients)
+  {
+    if (client.second->m_maxLevel == 0)
+    {
+      AcceptClient (client.first);
+    }
+  }
+}
+
+void
+VideoStreamProxy::HandleOriginRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+
+  Ptr<Packet> packet;
+  Address from;
+  while ((packet = socket->RecvFrom (from)))
+  {
+    VideoStreamHeader header;
+    if (packet->GetSize () < header.GetSerializedSize ())
+    {
+      continue;
+    }
+    packet->PeekHeader (header);
+    // the origin may admit a session at a lower level than requested, so the session is found by its socket
+    // and its frames are cached as the requested level the clients wait on
+    auto iter = std::find_if (m_fetches.begin (), m_fetches.end (),
+                              [socket] (const std::pair<const uint64_t, Fetch*> &fetch) { return fetch.second->m_socket == socket; });
+    if (iter == m_fetches.end ())
+    {
+      continue;
+    }
+    Fetch *fetch = iter->second;
+    if (header.GetMessageType () == VideoStreamHeader::HELLO_ACK)
+    {
+      if (m_originMaxLevel == 0)
+      {
+        HandleOriginAck (packet);
+      }
+      if (m_originMaxLevel > 0 && fetch->m_videoLevel > m_originMaxLevel)
+      {
+        // the level of a client that came before the ladder was known
+        CloseFetch (fetch);
+        return;
+      }
+      continue;
+    }
+    if (header.GetMessageType () != VideoStreamHeader::DATA)
+    {
+      continue;
+    }
+
+    m_originBytes += packet->GetSize ();
+    if (header.GetFrame () != fetch->m_frame)
+    {
+      // the end of the previous frame was lost
+      fetch->m_frame = header.GetFrame ();
+      fetch->m_bytes = 0;
+    }
+    fetch->m_bytes += packet->GetSize ();
+    if (header.GetFlags () & VideoStreamHeader::LAST_FRAGMENT)
+    {
+      m_cache.Insert (VideoStreamCache::GetKey (fetch->m_contentId, fetch->m_videoLevel, fetch->m_frame), fetch->m_bytes);
+      fetch->m_frame++;
+      fetch->m_bytes = 0;
+      if (header.GetFlags () & VideoStreamHeader::LAST_FRAME)
+      {
+        m_titleFrames[fetch->m_contentId] = fetch->m_frame;
+        CloseFetch (fetch);
+        // the socket was closed, so nothing is left to read
+        return;
+      }
+    }
+  }
+}
+
+void
+VideoStreamProxy::HandleRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+
+  Ptr<Packet> packet;
+  Address from;
+  while ((packet = socket->RecvFrom (from)))
+  {
+    if (!InetSocketAddress::IsMatchingType (from))
+    {
+      continue;
+    }
+    VideoStreamHeader header;
+    if (packet->GetSize () < header.GetSerializedSize ())
+    {
+      continue;
+    }
+    packet->RemoveHeader (header);
+
+    uint64_t clientKey = VideoStreamServer::GetClientKey (InetSocketAddress::ConvertFrom (from));
+    auto iter = m_clients.find (clientKey);
+    if (header.GetMessageType () == VideoStreamHeader::HELLO)
+    {
+      VideoStreamSessionHeader hello;
+      if (packet->GetSize () >= hello.GetSerializedSize ())
+      {
+        packet->RemoveHeader (hello);
+      }
+      if (iter != m_clients.end ())
+      {
+        // the acknowledgement was lost, unless the origin has not acknowledged the proxy yet
+        if (iter->second->m_maxLevel > 0)
+        {
+          SendHelloAck (iter->second);
+        }
+        continue;
+      }
+      ClientInfo *newClient = new ClientInfo ();
+      newClient->m_address = from;
+      newClient->m_contentId = header.GetContentId ();
+      newClient->m_videoLevel = std::max<uint16_t> (header.GetVideoLevel (), 1);
+      newClient->m_announcedLevel = hello.GetMaxVideoLevel ();
+      newClient->m_maxHeight = hello.GetMaxHeight ();
+      newClient->m_maxLevel = 0;
+      newClient->m_sent = header.GetFrame ();
+      newClient->m_sequence = 0;
+      newClient->m_waiting = false;
+      newClient->m_discontinuity = false;
+      m_clients[clientKey] = newClient;
+      if (m_originMaxLevel > 0)
+      {
+        AcceptClient (clientKey);
+      }
+      else
+      {
+        // the first upstream session brings the ladder the client is acknowledged with
+        RequestFrame (newClient->m_contentId, newClient->m_videoLevel, newClient->m_sent);
+      }
+    }
+    else if (header.GetMessageType () == VideoStreamHeader::SEEK && iter != m_clients.end ())
+    {
+      // the proxy knows no keyframes, so it resumes from the frame itself and has no fast forward
+      NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s proxy moved a client to frame " << header.GetFrame ());
+      iter->second->m_sent = header.GetFrame ();
+      iter->second->m_waiting = false;
+      iter->second->m_discontinuity = true;
+      Simulator::Cancel (iter->second->m_sendEvent);
+      // a client not acknowledged yet starts from there once it is
+      if (iter->second->m_maxLevel > 0)
+      {
+        iter->second->m_sendEvent = Simulator::Schedule (Seconds (0.0), &VideoStreamProxy::Send, this, clientKey);
+      }
+    }
+    else if (header.GetMessageType () == VideoStreamHeader::LEVEL && iter != m_clients.end ())
+    {
+      NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s proxy received video level " << header.GetVideoLevel ());
+      iter->second->m_videoLevel = std::max<uint16_t> (1, std::min (header.GetVideoLevel (), iter->second->m_maxLevel));
+      iter->second->m_waiting = false;
+    }
+    else if (header.GetMessageType () == VideoStreamHeader::BYE && iter != m_clients.end ())
+    {
+      Simulator::Cancel (iter->second->m_sendEvent);
+      delete iter->second;
+      m_clients.erase (iter);
+    }
+  }
+}
+
+} // namespace ns3
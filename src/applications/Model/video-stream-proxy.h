@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_PROXY_H
+#define VIDEO_STREAM_PROXY_H
+
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "video-stream-cache.h"
+#include "video-stream-ladder.h"
+
+#include <unordered_map>
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * @brief An edge proxy caching the frames of a video stream server.
+ *
+ * The proxy accepts the sessions of video stream clients like a server.
+ * Each frame a client needs is looked up in the frame cache; on a miss the
+ * proxy opens an upstream session with the origin server for the title and
+ * video level, starting at the missing frame, and caches every frame the
+ * origin sends. A single upstream session serves every local client of the
+ * same title and level that is behind it. A client waiting for a frame is
+ * polled at the frame interval until the frame is cached. The proxy learns
+ * the ladder of the origin from the acknowledgement of its first upstream
+ * session and acknowledges each client with it, so that no client adapts
+ * above the highest level of the origin.
+ */
+class VideoStreamProxy : public Application
+{
+public:
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  VideoStreamProxy ();
+
+  virtual ~VideoStreamProxy ();
+
+  /**
+   * @brief Get the frame cache.
+   *
+   * @return the cache
+   */
+  const VideoStreamCache &GetCache (void) const;
+
+  /**
+   * @brief Get the ratio of the frame requests served from the cache.
+   *
+   * @return the hit ratio
+   */
+  double GetHitRatio (void) const;
+
+  /**
+   * @brief Get the bytes received from the origin server.
+   *
+   * @return the origin bytes
+   */
+  uint64_t GetOriginBytes (void) const;
+
+  /**
+   * @brief Get the bytes sent to the clients.
+   *
+   * @return the served bytes
+   */
+  uint64_t GetServedBytes (void) const;
+
+  /**
+   * @brief Get the share of the served bytes that did not come from the origin.
+   *
+   * @return 1 - origin bytes / served bytes, 0 before anything is served
+   */
+  double GetOriginOffload (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * @brief The information required for each client.
+   */
+  typedef struct ClientInfo
+  {
+    Address m_address; //!< Address
+    uint32_t m_contentId; //!< Requested title
+    uint16_t m_videoLevel; //!< Video level
+    uint16_t m_announcedLevel; //!< Highest video level the client plays, 0 for any
+    uint16_t m_maxHeight; //!< Tallest rendition the client shows, 0 for any
+    uint16_t m_maxLevel; //!< Highest video level offered, 0 until the client is acknowledged
+    uint32_t m_sent; //!< Next frame to send
+    uint32_t m_sequence; //!< Sequence number of the next packet
+    bool m_waiting; //!< Whether the next frame missed the cache
+    bool m_discontinuity; //!< Whether the next fragment is the first after a SEEK
+    EventId m_sendEvent; //!< Send event of the client
+  } ClientInfo;
+
+  /**
+   * @brief An upstream session with the origin server.
+   */
+  typedef struct Fetch
+  {
+    uint32_t m_contentId; //!< Requested title
+    uint16_t m_videoLevel; //!< Requested video level
+    Ptr<Socket> m_socket; //!< Socket connected to the origin, null when finished
+    uint32_t m_frame; //!< Frame being received
+    uint32_t m_bytes; //!< Bytes of the frame received so far
+  } Fetch;
+
+  /**
+   * @brief Send the next frame to a client, or poll the cache while it is missing.
+   *
+   * @param clientKey the key of the client
+   */
+  void Send (uint64_t clientKey);
+
+  /**
+   * @brief Send a cached frame to a client.
+   *
+   * @param client the client
+   * @param frameSize the size of the frame
+   */
+  void SendFrame (ClientInfo *client, uint32_t frameSize);
+
+  /**
+   * @brief Acknowledge the HELLO of a client with the ladder of the origin.
+   *
+   * @param client the client
+   */
+  void SendHelloAck (ClientInfo *client);
+
+  /**
+   * @brief Acknowledge a client and start sending its frames.
+   *
+   * @param clientKey the key of the client
+   */
+  void AcceptClient (uint64_t clientKey);
+
+  /**
+   * @brief Make sure a frame is on its way from the origin.
+   *
+   * @param contentId the title
+   * @param videoLevel the video level
+   * @param frame the frame number
+   */
+  void RequestFrame (uint32_t contentId, uint16_t videoLevel, uint32_t frame);
+
+  /**
+   * @brief Handle a packet from a client.
+   *
+   * @param socket the socket the packet was received to
+   */
+  void HandleRead (Ptr<Socket> socket);
+
+  /**
+   * @brief Handle a packet from the origin.
+   *
+   * @param socket the socket the packet was received to
+   */
+  void HandleOriginRead (Ptr<Socket> socket);
+
+  /**
+   * @brief Learn the ladder of the origin from its acknowledgement and accept the waiting clients.
+   *
+   * @param packet the HELLO_ACK of the origin
+   */
+  void HandleOriginAck (Ptr<const Packet> packet);
+
+  /**
+   * @brief Close the socket of an upstream session.
+   *
+   * @param fetch the upstream session
+   */
+  void CloseFetch (Fetch *fetch);
+
+  uint16_t m_port; //!< Port on which clients are accepted
+  Address m_originAddress; //!< Address of the origin server
+  uint16_t m_originPort; //!< Port of the origin server
+  Time m_interval; //!< Time between two frames sent to a client
+  uint32_t m_maxPacketSize; //!< Maximum size of the packets sent to the clients
+  uint64_t m_cacheSize; //!< Byte budget of the cache
+  VideoStreamCache::Policy m_cachePolicy; //!< Replacement policy of the cache
+
+  Ptr<Socket> m_socket; //!< Socket for the clients
+  VideoStreamCache m_cache; //!< Frame cache
+  std::unordered_map<uint64_t, ClientInfo*> m_clients; //!< Clients, indexed by address and port
+  std::unordered_map<uint64_t, Fetch*> m_fetches; //!< Upstream sessions, indexed by the cache key of frame 0
+  std::unordered_map<uint32_t, uint32_t> m_titleFrames; //!< Number of frames of the titles streamed to the end
+  VideoStreamLadder m_originLadder; //!< Ladder of the origin
+  uint16_t m_originMaxLevel; //!< Highest video level of the origin, 0 until its first acknowledgement
+  uint64_t m_originBytes; //!< Bytes received from the origin
+  uint64_t m_servedBytes; //!< Bytes sent to the clients
+
+  /// Callbacks for tracing the packet Tx events towards the clients
+  TracedCallback<Ptr<const Packet>> m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_PROXY_H */
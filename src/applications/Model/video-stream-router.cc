@@ -0,0 +1,343 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/log.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/hash.h"
+#include "ns3/trace-source-accessor.h"
+#include "video-stream-router.h"
+#include "video-stream-server.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamRouterApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (VideoStreamRouter);
+
+TypeId
+VideoStreamRouter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::VideoStreamRouter")
+    .SetParent<Application> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<VideoStreamRouter> ()
+    .AddAttribute ("Port", "Port on which the clients and the load reports of the servers are received",
+                    UintegerValue (6969),
+                    MakeUintegerAccessor (&VideoStreamRouter::m_port),
+                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Policy", "How the server of a session is chosen",
+                    EnumValue (VideoStreamRouter::POLICY_LEAST_LOAD),
+                    MakeEnumAccessor (&VideoStreamRouter::m_policy),
+                    MakeEnumChecker (VideoStreamRouter::POLICY_LEAST_LOAD, "LeastLoad",
+                                     VideoStreamRouter::POLICY_CONTENT_HASH, "ContentHash",
+                                     VideoStreamRouter::POLICY_PROXIMITY, "Proximity"))
+    .AddAttribute ("LoadTimeout", "The time after the last load report of a server after which it is no longer chosen, "
+                   "0 to choose it however old its report; a server that never reported is always chosen",
+                    TimeValue (Seconds (3.0)),
+                    MakeTimeAccessor (&VideoStreamRouter::m_loadTimeout),
+                    MakeTimeChecker ())
+    .AddAttribute ("VirtualNodes", "The number of points of each server on the consistent hash ring of ContentHash",
+                    UintegerValue (100),
+                    MakeUintegerAccessor (&VideoStreamRouter::m_virtualNodes),
+                    MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Redirect", "A session was redirected to a server",
+                     MakeTraceSourceAccessor (&VideoStreamRouter::m_redirectTrace),
+                     "ns3::VideoStreamRouter::RedirectTracedCallback")
+  ;
+  return tid;
+}
+
+VideoStreamRouter::VideoStreamRouter ()
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_loadReports = 0;
+}
+
+VideoStreamRouter::~VideoStreamRouter ()
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+}
+
+void
+VideoStreamRouter::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_servers.clear ();
+  m_serverIndex.clear ();
+  m_ring.clear ();
+  Application::DoDispose ();
+}
+
+void
+VideoStreamRouter::AddServer (Ipv4Address address, uint16_t port)
+{
+  NS_LOG_FUNCTION (this << address << port);
+  FindServer (address, port);
+}
+
+uint32_t
+VideoStreamRouter::GetServerCount (void) const
+{
+  return m_servers.size ();
+}
+
+uint32_t
+VideoStreamRouter::GetRedirectCount (uint32_t server) const
+{
+  return m_servers.at (server).m_redirects;
+}
+
+double
+VideoStreamRouter::GetServerLoad (uint32_t server) const
+{
+  return GetLoad (m_servers.at (server));
+}
+
+uint32_t
+VideoStreamRouter::GetLoadReports (void) const
+{
+  return m_loadReports;
+}
+
+uint32_t
+VideoStreamRouter::FindServer (Ipv4Address address, uint16_t port)
+{
+  uint64_t key = VideoStreamServer::GetClientKey (InetSocketAddress (address, port));
+  auto iter = m_serverIndex.find (key);
+  if (iter != m_serverIndex.end ())
+  {
+    return iter->second;
+  }
+  ServerInfo server;
+  server.m_address = address;
+  server.m_port = port;
+  server.m_activeSessions = 0;
+  server.m_queueLength = 0;
+  server.m_maxSessions = 0;
+  server.m_reservedRate = 0;
+  server.m_egressBudget = 0;
+  server.m_pending = 0;
+  server.m_redirects = 0;
+  server.m_lastReport = Seconds (-1.0);
+  m_servers.push_back (server);
+  m_serverIndex[key] = m_servers.size () - 1;
+  UpdateRing ();
+  return m_servers.size () - 1;
+}
+
+void
+VideoStreamRouter::UpdateRing (void)
+{
+  m_ring.clear ();
+  for (uint32_t index = 0; index < m_servers.size (); index++)
+  {
+    for (uint32_t node = 0; node < m_virtualNodes; node++)
+    {
+      // the points of a server only depend on its address, so adding a server only moves the titles it takes
+      std::ostringstream name;
+      name << m_servers[index].m_address << ":" << m_servers[index].m_port << "#" << node;
+      m_ring[Hash32 (name.str ())] = index;
+    }
+  }
+}
+
+double
+VideoStreamRouter::GetLoad (const ServerInfo &server) const
+{
+  double sessions = server.m_activeSessions + server.m_queueLength + server.m_pending;
+  double load = server.m_maxSessions > 0 ? sessions / server.m_maxSessions : sessions;
+  if (server.m_egressBudget > 0)
+  {
+    load = std::max (load, static_cast<double> (server.m_reservedRate) / server.m_egressBudget);
+  }
+  return load;
+}
+
+bool
+VideoStreamRouter::IsAvailable (const ServerInfo &server) const
+{
+  return m_loadTimeout.IsZero () || server.m_lastReport.IsStrictlyNegative ()
+         || Simulator::Now () - server.m_lastReport <= m_loadTimeout;
+}
+
+uint32_t
+VideoStreamRouter::SelectServer (uint32_t contentId, Ipv4Address client) const
+{
+  uint32_t selected = m_servers.size ();
+  if (m_policy == POLICY_CONTENT_HASH)
+  {
+    if (m_ring.empty ())
+    {
+      return selected;
+    }
+    // the first point clockwise from the title, skipping the unavailable servers
+    std::ostringstream title;
+    title << contentId;
+    auto point = m_ring.lower_bound (Hash32 (title.str ()));
+    for (uint32_t step = 0; step < m_ring.size (); step++, point++)
+    {
+      if (point == m_ring.end ())
+      {
+        point = m_ring.begin ();
+      }
+      if (IsAvailable (m_servers[point->second]))
+      {
+        return point->second;
+      }
+    }
+    return selected;
+  }
+
+  uint32_t bestPrefix = 0;
+  double bestLoad = 0.0;
+  for (uint32_t index = 0; index < m_servers.size (); index++)
+  {
+    const ServerInfo &server = m_servers[index];
+    if (!IsAvailable (server))
+    {
+      continue;
+    }
+    uint32_t prefix = 0;
+    if (m_policy == POLICY_PROXIMITY)
+    {
+      uint32_t difference = server.m_address.Get () ^ client.Get ();
+      while (prefix < 32 && !(difference & (0x80000000u >> prefix)))
+      {
+        prefix++;
+      }
+    }
+    double load = GetLoad (server);
+    if (selected == m_servers.size () || prefix > bestPrefix || (prefix == bestPrefix && load < bestLoad))
+    {
+      selected = index;
+      bestPrefix = prefix;
+      bestLoad = load;
+    }
+  }
+  return selected;
+}
+
+void
+VideoStreamRouter::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_socket == 0)
+  {
+    TypeId tid = TypeId::LookupByName ("ns3::UdpSocketFactory");
+    m_socket = Socket::CreateSocket (GetNode (), tid);
+    InetSocketAddress local = InetSocketAddress (Ipv4Address::GetAny (), m_port);
+    if (m_socket->Bind (local) == -1)
+    {
+      NS_FATAL_ERROR ("Failed to bind socket");
+    }
+  }
+  m_socket->SetRecvCallback (MakeCallback (&VideoStreamRouter::HandleRead, this));
+}
+
+void
+VideoStreamRouter::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_socket != 0)
+  {
+    m_socket->Close ();
+    m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket>> ());
+    m_socket = 0;
+  }
+  for (uint32_t index = 0; index < m_servers.size (); index++)
+  {
+    NS_LOG_INFO ("Router sent " << m_servers[index].m_redirects << " sessions to " << m_servers[index].m_address
+                 << " port " << m_servers[index].m_port);
+  }
+}
+
+void
+VideoStreamRouter::HandleRead (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+
+  Ptr<Packet> packet;
+  Address from;
+  while ((packet = socket->RecvFrom (from)))
+  {
+    if (!InetSocketAddress::IsMatchingType (from))
+    {
+      continue;
+    }
+    InetSocketAddress source = InetSocketAddress::ConvertFrom (from);
+    VideoStreamHeader header;
+    if (packet->GetSize () < header.GetSerializedSize ())
+    {
+      NS_LOG_WARN ("Dropping a " << packet->GetSize () << " byte packet without a video stream header");
+      continue;
+    }
+    packet->RemoveHeader (header);
+
+    if (header.GetMessageType () == VideoStreamHeader::LOAD)
+    {
+      VideoStreamLoadHeader load;
+      if (packet->GetSize () < load.GetSerializedSize ())
+      {
+        continue;
+      }
+      packet->RemoveHeader (load);
+      // a server is known by the address and port its reports come from
+      ServerInfo &server = m_servers[FindServer (source.GetIpv4 (), source.GetPort ())];
+      server.m_activeSessions = load.GetActiveSessions ();
+      server.m_queueLength = load.GetQueueLength ();
+      server.m_maxSessions = load.GetMaxSessions ();
+      server.m_reservedRate = load.GetReservedRate ().GetBitRate ();
+      server.m_egressBudget = load.GetEgressBudget ().GetBitRate ();
+      server.m_pending = 0;
+      server.m_lastReport = Simulator::Now ();
+      m_loadReports++;
+      NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s router received load " << load << " from " << source.GetIpv4 ());
+    }
+    else if (header.GetMessageType () == VideoStreamHeader::HELLO)
+    {
+      uint32_t index = SelectServer (header.GetContentId (), source.GetIpv4 ());
+      VideoStreamHeader answer;
+      answer.SetContentId (header.GetContentId ());
+      answer.SetVideoLevel (header.GetVideoLevel ());
+      Ptr<Packet> p = Create<Packet> ();
+      if (index == m_servers.size ())
+      {
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s router has no server for " << source.GetIpv4 ());
+        answer.SetMessageType (VideoStreamHeader::REJECT);
+      }
+      else
+      {
+        ServerInfo &server = m_servers[index];
+        // a repeated HELLO whose REDIRECT was lost counts again until the next report
+        server.m_pending++;
+        server.m_redirects++;
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s router redirected " << source.GetIpv4 ()
+                     << " to " << server.m_address << " port " << server.m_port);
+        m_redirectTrace (header.GetContentId (), index);
+        VideoStreamRedirectHeader redirect;
+        redirect.SetServerAddress (server.m_address);
+        redirect.SetServerPort (server.m_port);
+        p->AddHeader (redirect);
+        answer.SetMessageType (VideoStreamHeader::REDIRECT);
+      }
+      p->AddHeader (answer);
+      m_socket->SendTo (p, 0, from);
+    }
+  }
+}
+
+} // namespace ns3
@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_ROUTER_H
+#define VIDEO_STREAM_ROUTER_H
+
+#include "ns3/application.h"
+#include "ns3/ptr.h"
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "video-stream-header.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+class Socket;
+class Packet;
+
+/**
+ * @brief A request router spreading the sessions of video stream clients
+ * over several video stream servers.
+ *
+ * A client sends its HELLO to the router, which answers with a REDIRECT
+ * naming the server of the session; the client then opens the session with
+ * that server. The servers are added with AddServer, or learnt from the
+ * LOAD reports the servers with a RouterAddress send every load report
+ * interval. The load of a server is the largest of its share of MaxSessions
+ * and its share of EgressBudget, or its number of sessions when it has no
+ * limit, counting the queued sessions and the sessions redirected to it
+ * since its last report. A server that has reported once and stays silent
+ * for LoadTimeout is no longer chosen.
+ */
+class VideoStreamRouter : public Application
+{
+public:
+  /**
+   * @brief Get the type ID.
+   *
+   * @return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * @brief How the server of a session is chosen.
+   */
+  enum Policy
+  {
+    POLICY_LEAST_LOAD = 0, //!< The least loaded server
+    POLICY_CONTENT_HASH = 1, //!< The server of the title on a consistent hash ring, so a title stays on one server
+    POLICY_PROXIMITY = 2 //!< The server sharing the longest address prefix with the client, the least loaded among them
+  };
+
+  VideoStreamRouter ();
+
+  virtual ~VideoStreamRouter ();
+
+  /**
+   * @brief Add a server to choose from.
+   *
+   * @param address the address of the server
+   * @param port the port the server listens on
+   */
+  void AddServer (Ipv4Address address, uint16_t port);
+
+  /**
+   * @brief Get the number of servers.
+   *
+   * @return the servers added or learnt from their load reports
+   */
+  uint32_t GetServerCount (void) const;
+
+  /**
+   * @brief Get the number of sessions redirected to a server.
+   *
+   * @param server the index of the server, in the order it was added or learnt
+   * @return the number of REDIRECT sent for the server
+   */
+  uint32_t GetRedirectCount (uint32_t server) const;
+
+  /**
+   * @brief Get the last reported load of a server.
+   *
+   * @param server the index of the server, in the order it was added or learnt
+   * @return the load, see the class description
+   */
+  double GetServerLoad (uint32_t server) const;
+
+  /**
+   * @brief Get the number of load reports received.
+   *
+   * @return the number of LOAD messages
+   */
+  uint32_t GetLoadReports (void) const;
+
+  /**
+   * TracedCallback signature for the redirections.
+   *
+   * @param [in] contentId the requested title
+   * @param [in] server the index of the chosen server
+   */
+  typedef void (* RedirectTracedCallback) (uint32_t contentId, uint32_t server);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * @brief The information kept for each server.
+   */
+  typedef struct ServerInfo
+  {
+    Ipv4Address m_address; //!< Address
+    uint16_t m_port; //!< Port
+    uint32_t m_activeSessions; //!< Active sessions of the last report
+    uint32_t m_queueLength; //!< Queued sessions of the last report
+    uint32_t m_maxSessions; //!< MaxSessions of the server, 0 for no limit
+    uint64_t m_reservedRate; //!< Reserved bitrate of the last report in bits per second
+    uint64_t m_egressBudget; //!< EgressBudget of the server in bits per second, 0 for no limit
+    uint32_t m_pending; //!< Sessions redirected since the last report
+    uint32_t m_redirects; //!< Sessions redirected to the server
+    Time m_lastReport; //!< Time of the last report, negative before the first one
+  } ServerInfo;
+
+  /**
+   * @brief Get the index of a server, adding it if it is new.
+   *
+   * @param address the address of the server
+   * @param port the port of the server
+   * @return the index of the server
+   */
+  uint32_t FindServer (Ipv4Address address, uint16_t port);
+
+  /**
+   * @brief Rebuild the consistent hash ring from the servers.
+   */
+  void UpdateRing (void);
+
+  /**
+   * @brief Get the load of a server.
+   *
+   * @param server the server
+   * @return the load, see the class description
+   */
+  double GetLoad (const ServerInfo &server) const;
+
+  /**
+   * @brief Check whether a server can be chosen.
+   *
+   * @param server the server
+   * @return false if the last report of the server is older than LoadTimeout
+   */
+  bool IsAvailable (const ServerInfo &server) const;
+
+  /**
+   * @brief Choose the server of a session.
+   *
+   * @param contentId the requested title
+   * @param client the address of the client
+   * @return the index of the server, or the number of servers if none is available
+   */
+  uint32_t SelectServer (uint32_t contentId, Ipv4Address client) const;
+
+  /**
+   * @brief Handle a packet reception.
+   *
+   * @param socket the socket the packet was received to
+   */
+  void HandleRead (Ptr<Socket> socket);
+
+  uint16_t m_port; //!< Port on which clients and load reports are received
+  Policy m_policy; //!< How the server of a session is chosen
+  Time m_loadTimeout; //!< Silence after which a server is no longer chosen, 0 to always choose it
+  uint32_t m_virtualNodes; //!< Points of each server on the hash ring
+
+  Ptr<Socket> m_socket; //!< Socket
+  std::vector<ServerInfo> m_servers; //!< Servers, in the order they were added or learnt
+  std::unordered_map<uint64_t, uint32_t> m_serverIndex; //!< Index of each server, by address and port
+  std::map<uint32_t, uint32_t> m_ring; //!< Server index of each point of the hash ring
+  uint32_t m_loadReports; //!< Number of load reports received
+
+  /// Callbacks for tracing the redirections
+  TracedCallback<uint32_t, uint32_t> m_redirectTrace;
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_ROUTER_H */
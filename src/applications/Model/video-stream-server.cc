@@ -13,7 +13,23 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/string.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-protocol.h"
 #include "ns3/video-stream-server.h"
+#include "ns3/video-stream-cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
 
 namespace ns3 {
 
@@ -21,6 +37,19 @@ NS_LOG_COMPONENT_DEFINE ("VideoStreamServerApplication");
 
 NS_OBJECT_ENSURE_REGISTERED (VideoStreamServer);
 
+// Room for the header written at the beginning of each fragment
+static const uint32_t MIN_FRAGMENT_SIZE = VideoStreamHeader::SERIALIZED_SIZE;
+// IPv4 and UDP headers carried by each fragment
+static const uint32_t IPV4_UDP_HEADERS = 28;
+// Largest MTU without jumbo frames
+static const uint32_t ETHERNET_MTU = 1500;
+// Largest UDP payload of an IPv4 datagram
+static const uint32_t MAX_DATAGRAM_SIZE = 65535 - IPV4_UDP_HEADERS;
+// A frame this many times the mean size of its GOP so far starts a new GOP
+static const double KEYFRAME_SIZE_RATIO = 2.0;
+// Linear ladder, so that level n of a frame file sends n times its frame sizes
+static const char DEFAULT_LADDER[] = "640x360@1.5Mbps;720x480@3Mbps;1280x720@4.5Mbps;1920x1080@6Mbps;2048x1080@7.5Mbps";
+
 TypeId
 VideoStreamServer::GetTypeId (void)
 {
@@ -36,18 +65,125 @@ VideoStreamServer::GetTypeId (void)
                     UintegerValue (6969),
                     MakeUintegerAccessor (&VideoStreamServer::m_port),
                     MakeUintegerChecker<uint16_t> ())
-    .AddAttribute ("MaxPacketSize", "The maximum size of a packet",
+    .AddAttribute ("RouterAddress", "The address of the request router the load of the server is reported to, "
+                   "empty without router",
+                    AddressValue (),
+                    MakeAddressAccessor (&VideoStreamServer::m_routerAddress),
+                    MakeAddressChecker ())
+    .AddAttribute ("RouterPort", "The port of the request router",
+                    UintegerValue (6969),
+                    MakeUintegerAccessor (&VideoStreamServer::m_routerPort),
+                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("LoadReportInterval", "The time between two load reports to the request router",
+                    TimeValue (Seconds (1.0)),
+                    MakeTimeAccessor (&VideoStreamServer::m_loadReportInterval),
+                    MakeTimeChecker (MilliSeconds (1)))
+    .AddAttribute ("MaxPacketSize", "The maximum size of a packet, for every session unless FragmentSizing is PathMtu",
                     UintegerValue (1400),
                     MakeUintegerAccessor (&VideoStreamServer::m_maxPacketSize),
                     MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("FragmentSizing", "Whether every session gets MaxPacketSize fragments, or the largest that fit in its path MTU",
+                    EnumValue (VideoStreamServer::FRAGMENT_FIXED),
+                    MakeEnumAccessor (&VideoStreamServer::m_fragmentSizing),
+                    MakeEnumChecker (VideoStreamServer::FRAGMENT_FIXED, "Fixed",
+                                     VideoStreamServer::FRAGMENT_PATH_MTU, "PathMtu"))
+    .AddAttribute ("FrameAggregation", "The largest number of fragments of a frame sent as one packet with their total size, "
+                   "for fast simulations without per-fragment fidelity; 0 or 1 sends every fragment. "
+                   "A packet never exceeds 65507 bytes, and should fit in the MTU of the links to avoid IP fragmentation",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamServer::m_frameAggregation),
+                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("PathMtu", "The path MTU of every session with PathMtu fragments; 0 discovers it as the smallest of "
+                   "the MTU of the device towards the client and the MTU advertised by the client",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamServer::m_pathMtu),
+                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Jumbo", "Whether PathMtu fragments may use a path MTU above 1500 bytes",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&VideoStreamServer::m_jumbo),
+                    MakeBooleanChecker ())
+    .AddAttribute ("KeyframeInterval", "The largest number of frames of a GOP of a frame file or of the built-in frame sizes, "
+                   "which carry no frame types; seeks resume from the keyframe starting a GOP",
+                    UintegerValue (25),
+                    MakeUintegerAccessor (&VideoStreamServer::m_keyframeInterval),
+                    MakeUintegerChecker<uint32_t> (1))
     .AddAttribute ("FrameFile", "The file that contains the video frame sizes",
                     StringValue (""),
                     MakeStringAccessor (&VideoStreamServer::SetFrameFile, &VideoStreamServer::GetFrameFile),
                     MakeStringChecker ())
+    .AddAttribute ("Catalog", "A manifest listing one frame file per title, or a directory of frame files; "
+                   "the content ID of a title is its position. Overrides FrameFile when set",
+                    StringValue (""),
+                    MakeStringAccessor (&VideoStreamServer::SetCatalog, &VideoStreamServer::GetCatalog),
+                    MakeStringChecker ())
+    .AddAttribute ("Ladder", "The renditions of the video levels in increasing bitrate, as WIDTHxHEIGHT@BITRATE[,FRAMEFILE] "
+                   "separated by semicolons. A level without frame file scales the frame sizes of the title by its bitrate "
+                   "over the bitrate of level 1; without FrameFile, Catalog nor FrameGenerator its frames carry its bitrate",
+                    StringValue (DEFAULT_LADDER),
+                    MakeStringAccessor (&VideoStreamServer::SetLadder, &VideoStreamServer::GetLadder),
+                    MakeStringChecker ())
+    .AddAttribute ("FrameGenerator", "The generator of the frame sizes, used when neither FrameFile nor Catalog is set",
+                    PointerValue (),
+                    MakePointerAccessor (&VideoStreamServer::SetFrameGenerator, &VideoStreamServer::GetFrameGenerator),
+                    MakePointerChecker<VideoStreamFrameGenerator> ())
+    .AddAttribute ("FastStartFrames", "The number of frames of a new on-demand session sent faster than real time, "
+                   "to fill the buffer of the client before its playback starts; 0 to disable the burst. "
+                   "The burst never exceeds the buffer capacity the client announced",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamServer::m_fastStartFrames),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("FastStartRate", "The largest bitrate of the fast-start burst, 0 to send the burst back to back; "
+                   "a frame of the burst is never sent later than Interval after the previous one",
+                    DataRateValue (DataRate ("20Mbps")),
+                    MakeDataRateAccessor (&VideoStreamServer::m_fastStartRate),
+                    MakeDataRateChecker ())
     .AddAttribute ("VideoLength", "The length of the video in seconds",
                     UintegerValue (60),
                     MakeUintegerAccessor (&VideoStreamServer::m_videoLength),
                     MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("InitialVideoLevel", "The video level a new client starts with, at most the highest level of the ladder",
+                    UintegerValue (3),
+                    MakeUintegerAccessor (&VideoStreamServer::m_initialVideoLevel),
+                    MakeUintegerChecker<uint16_t> (1))
+    .AddAttribute ("Live", "Whether the frames are produced one Interval apart from the start of the server; "
+                   "clients then join at the live edge instead of the first frame",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&VideoStreamServer::m_live),
+                    MakeBooleanChecker ())
+    .AddAttribute ("MaxSessions", "The largest number of sessions streamed at the same time, 0 for no limit",
+                    UintegerValue (0),
+                    MakeUintegerAccessor (&VideoStreamServer::m_maxSessions),
+                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("EgressBudget", "The largest total bitrate of the sessions streamed at the same time, "
+                   "estimated from the mean frame size of their title and level; 0 for no limit",
+                    DataRateValue (DataRate (0)),
+                    MakeDataRateAccessor (&VideoStreamServer::m_egressBudget),
+                    MakeDataRateChecker ())
+    .AddAttribute ("AdmissionPolicy", "What to do with a new session that exceeds MaxSessions or EgressBudget",
+                    EnumValue (VideoStreamServer::ADMISSION_REJECT),
+                    MakeEnumAccessor (&VideoStreamServer::m_admissionPolicy),
+                    MakeEnumChecker (VideoStreamServer::ADMISSION_REJECT, "Reject",
+                                     VideoStreamServer::ADMISSION_QUEUE, "Queue",
+                                     VideoStreamServer::ADMISSION_CAP, "Cap"))
+    .AddAttribute ("RateControl", "Whether the receiver reports of a session cap its video level "
+                   "with a delay- and loss-based congestion controller",
+                    BooleanValue (true),
+                    MakeBooleanAccessor (&VideoStreamServer::m_rateControl),
+                    MakeBooleanChecker ())
+    .AddAttribute ("EventLogFile", "The binary file the events are recorded to, empty to disable the event log",
+                    StringValue (""),
+                    MakeStringAccessor (&VideoStreamServer::m_eventLogFile),
+                    MakeStringChecker ())
+    .AddAttribute ("EventLogBufferSize", "The number of events buffered before they are written to the event log",
+                    UintegerValue (1024),
+                    MakeUintegerAccessor (&VideoStreamServer::m_eventLogBufferSize),
+                    MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Tx", "A new packet is created and is sent",
+                     MakeTraceSourceAccessor (&VideoStreamServer::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("RateControl", "The rate controller updated the target rate of a session",
+                     MakeTraceSourceAccessor (&VideoStreamServer::m_rateControlTrace),
+                     "ns3::VideoStreamServer::RateControlTracedCallback")
     ;
     return tid;
 }
@@ -57,6 +193,15 @@ VideoStreamServer::VideoStreamServer ()
   NS_LOG_FUNCTION (this);
   m_socket = 0;
   m_frameRate = 25;
+  m_nextSession = 0;
+  m_reservedRate = 0;
+  m_admittedSessions = 0;
+  m_rejectedSessions = 0;
+  m_queuedSessions = 0;
+  m_cappedSessions = 0;
+  m_receivedReports = 0;
+  m_joinedSubflows = 0;
+  m_titleRequests.assign (1, 0);
   m_frameSizeList = std::vector<uint32_t>();
 }
 
@@ -70,6 +215,18 @@ void
 VideoStreamServer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  for (auto &client : m_clients)
+  {
+    delete client.second;
+  }
+  m_clients.clear ();
+  for (ClientInfo *client : m_admissionQueue)
+  {
+    delete client;
+  }
+  m_admissionQueue.clear ();
+  m_frameGenerator = 0;
+  m_eventLog.Close ();
   Application::DoDispose ();
 }
 
@@ -101,8 +258,14 @@ VideoStreamServer::StartApplication (void)
     }
   }
 
+  m_liveStart = Simulator::Now ();
   m_socket->SetAllowBroadcast (true);
   m_socket->SetRecvCallback (MakeCallback (&VideoStreamServer::HandleRead, this));
+  m_eventLog.Open (m_eventLogFile, m_eventLogBufferSize, GetNode ()->GetId ());
+  if (Ipv4Address::IsMatchingType (m_routerAddress))
+  {
+    SendLoadReport ();
+  }
 }
 
 void
@@ -118,11 +281,33 @@ VideoStreamServer::StopApplication ()
     m_socket = 0;
   }
 
+  Simulator::Cancel (m_loadEvent);
   for (auto iter = m_clients.begin (); iter != m_clients.end (); iter++)
   {
     Simulator::Cancel (iter->second->m_sendEvent);
   }
-  
+  m_eventLog.Close ();
+}
+
+void
+VideoStreamServer::LoadFrameSizes (std::string frameFile, std::vector<uint32_t> &frameSizeList)
+{
+  frameSizeList.clear ();
+  std::string line;
+  std::ifstream fileStream(frameFile);
+  if (!fileStream.is_open ())
+  {
+    NS_FATAL_ERROR ("Could not open " << frameFile);
+  }
+  while (std::getline (fileStream, line))
+  {
+    if (line.find_first_not_of (" \t\r") == std::string::npos)
+    {
+      continue;
+    }
+    int result = std::stoi(line);
+    frameSizeList.push_back (result);
+  }
 }
 
 void 
@@ -130,17 +315,285 @@ VideoStreamServer::SetFrameFile (std::string frameFile)
 {
   NS_LOG_FUNCTION (this << frameFile);
   m_frameFile = frameFile;
+  m_frameSizeList.clear ();
   if (frameFile != "")
   {
-    std::string line;
-    std::ifstream fileStream(frameFile);
-    while (std::getline (fileStream, line))
+    LoadFrameSizes (frameFile, m_frameSizeList);
+  }
+  m_titleRequests.assign (GetTitleCount (), 0);
+  UpdateMeanFrameSizes ();
+  UpdateKeyframeIndex ();
+  NS_LOG_INFO ("Frame list size: " << m_frameSizeList.size());
+}
+
+void
+VideoStreamServer::SetCatalog (std::string catalog)
+{
+  NS_LOG_FUNCTION (this << catalog);
+  m_catalogFile = catalog;
+  m_catalog.clear ();
+  if (catalog != "")
+  {
+    std::vector<std::string> frameFiles;
+    std::filesystem::path path (catalog);
+    if (std::filesystem::is_directory (path))
+    {
+      // every file of the directory is a title, in name order
+      for (auto &entry : std::filesystem::directory_iterator (path))
+      {
+        if (entry.is_regular_file ())
+        {
+          frameFiles.push_back (entry.path ().string ());
+        }
+      }
+      std::sort (frameFiles.begin (), frameFiles.end ());
+    }
+    else
+    {
+      // one frame file per line, relative to the manifest
+      std::ifstream fileStream (catalog);
+      if (!fileStream.is_open ())
+      {
+        NS_FATAL_ERROR ("Could not open " << catalog);
+      }
+      std::string line;
+      while (std::getline (fileStream, line))
+      {
+        line.erase (line.find_last_not_of (" \t\r") + 1);
+        if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+        std::filesystem::path frameFile (line);
+        if (frameFile.is_relative ())
+        {
+          frameFile = path.parent_path () / frameFile;
+        }
+        frameFiles.push_back (frameFile.string ());
+      }
+    }
+
+    m_catalog.resize (frameFiles.size ());
+    for (uint32_t i = 0; i < frameFiles.size (); i++)
+    {
+      LoadFrameSizes (frameFiles[i], m_catalog[i]);
+    }
+  }
+  m_titleRequests.assign (GetTitleCount (), 0);
+  UpdateMeanFrameSizes ();
+  UpdateKeyframeIndex ();
+  NS_LOG_INFO ("Catalog size: " << m_catalog.size ());
+}
+
+std::string
+VideoStreamServer::GetCatalog (void) const
+{
+  return m_catalogFile;
+}
+
+void
+VideoStreamServer::SetLadder (std::string ladder)
+{
+  NS_LOG_FUNCTION (this << ladder);
+  m_ladder = VideoStreamLadder (ladder);
+  if (m_ladder.GetLevelCount () == 0)
+  {
+    NS_FATAL_ERROR ("The ladder \"" << ladder << "\" has no rendition");
+  }
+  if (m_ladder.GetLevelCount () > VideoStreamCache::MAX_VIDEO_LEVEL)
+  {
+    // the frame caches tell the levels apart by MAX_VIDEO_LEVEL
+    NS_FATAL_ERROR ("The ladder has " << m_ladder.GetLevelCount () << " renditions, at most "
+                    << VideoStreamCache::MAX_VIDEO_LEVEL << " are supported");
+  }
+  m_renditionFrameSizes.assign (m_ladder.GetLevelCount (), std::vector<uint32_t> ());
+  m_renditionMeanFrameSizes.assign (m_ladder.GetLevelCount (), 0.0);
+  for (uint16_t videoLevel = 1; videoLevel <= m_ladder.GetLevelCount (); videoLevel++)
+  {
+    const std::string &frameFile = m_ladder.GetRendition (videoLevel).m_frameFile;
+    if (frameFile.empty ())
     {
-      int result = std::stoi(line);
-      m_frameSizeList.push_back (result);
+      continue;
     }
+    std::vector<uint32_t> &frameSizeList = m_renditionFrameSizes[videoLevel - 1];
+    LoadFrameSizes (frameFile, frameSizeList);
+    if (frameSizeList.empty ())
+    {
+      NS_FATAL_ERROR ("The frame file " << frameFile << " of level " << videoLevel << " has no frame");
+    }
+    uint64_t total = 0;
+    for (uint32_t frameSize : frameSizeList)
+    {
+      total += frameSize;
+    }
+    m_renditionMeanFrameSizes[videoLevel - 1] = static_cast<double> (total) / frameSizeList.size ();
   }
-  NS_LOG_INFO ("Frame list size: " << m_frameSizeList.size());
+  NS_LOG_INFO ("Ladder: " << m_ladder);
+}
+
+std::string
+VideoStreamServer::GetLadder (void) const
+{
+  return m_ladder.ToString ();
+}
+
+uint16_t
+VideoStreamServer::GetLevelCount (void) const
+{
+  return m_ladder.GetLevelCount ();
+}
+
+void
+VideoStreamServer::SetFrameGenerator (Ptr<VideoStreamFrameGenerator> frameGenerator)
+{
+  NS_LOG_FUNCTION (this << frameGenerator);
+  m_frameGenerator = frameGenerator;
+  m_titleRequests.assign (GetTitleCount (), 0);
+  UpdateMeanFrameSizes ();
+  UpdateKeyframeIndex ();
+}
+
+Ptr<VideoStreamFrameGenerator>
+VideoStreamServer::GetFrameGenerator (void) const
+{
+  return m_frameGenerator;
+}
+
+uint32_t
+VideoStreamServer::GetTitleCount (void) const
+{
+  if (!m_catalog.empty ())
+  {
+    return m_catalog.size ();
+  }
+  return m_frameSizeList.empty () && m_frameGenerator ? m_frameGenerator->GetTitleCount () : 1;
+}
+
+uint32_t
+VideoStreamServer::GetRequestCount (uint32_t contentId) const
+{
+  return contentId < m_titleRequests.size () ? m_titleRequests[contentId] : 0;
+}
+
+void
+VideoStreamServer::UpdateMeanFrameSizes (void)
+{
+  m_meanFrameSizes.assign (GetTitleCount (), 0.0);
+  for (uint32_t contentId = 0; contentId < GetTitleCount (); contentId++)
+  {
+    const std::vector<uint32_t> &frameSizeList = GetFrameSizeList (contentId);
+    if (!frameSizeList.empty ())
+    {
+      uint64_t total = 0;
+      for (uint32_t frameSize : frameSizeList)
+      {
+        total += frameSize;
+      }
+      m_meanFrameSizes[contentId] = static_cast<double> (total) / frameSizeList.size ();
+    }
+  }
+}
+
+void
+VideoStreamServer::UpdateKeyframeIndex (void)
+{
+  m_keyframes.assign (GetTitleCount (), std::vector<uint32_t> ());
+  for (uint32_t contentId = 0; contentId < GetTitleCount (); contentId++)
+  {
+    const std::vector<uint32_t> &frameSizeList = GetFrameSizeList (contentId);
+    uint64_t gopBytes = 0;
+    for (uint32_t frame = 0; frame < frameSizeList.size (); frame++)
+    {
+      uint32_t gopFrames = m_keyframes[contentId].empty () ? 0 : frame - m_keyframes[contentId].back ();
+      if (gopFrames == 0 || gopFrames >= m_keyframeInterval
+          || frameSizeList[frame] >= KEYFRAME_SIZE_RATIO * gopBytes / gopFrames)
+      {
+        m_keyframes[contentId].push_back (frame);
+        gopBytes = 0;
+      }
+      gopBytes += frameSizeList[frame];
+    }
+  }
+}
+
+uint32_t
+VideoStreamServer::GetKeyframe (uint32_t contentId, uint32_t frame) const
+{
+  if (contentId < m_keyframes.size () && !m_keyframes[contentId].empty ())
+  {
+    const std::vector<uint32_t> &keyframes = m_keyframes[contentId];
+    return *(std::upper_bound (keyframes.begin (), keyframes.end (), frame) - 1);
+  }
+  if (m_frameGenerator && contentId < GetTitleCount ())
+  {
+    // a scene starts at least every MaxSceneLength frames, so the search is bounded
+    while (frame > 0 && m_frameGenerator->GetFrameType (contentId, frame) != VideoStreamFrameGenerator::I_FRAME)
+    {
+      frame--;
+    }
+    return frame;
+  }
+  return frame - frame % m_keyframeInterval;
+}
+
+uint32_t
+VideoStreamServer::GetNextKeyframe (uint32_t contentId, uint32_t frame) const
+{
+  uint32_t totalFrames = GetTotalFrames (contentId);
+  if (contentId < m_keyframes.size () && !m_keyframes[contentId].empty ())
+  {
+    const std::vector<uint32_t> &keyframes = m_keyframes[contentId];
+    auto next = std::upper_bound (keyframes.begin (), keyframes.end (), frame);
+    return next != keyframes.end () ? *next : totalFrames;
+  }
+  if (m_frameGenerator)
+  {
+    frame++;
+    while (frame < totalFrames && m_frameGenerator->GetFrameType (contentId, frame) != VideoStreamFrameGenerator::I_FRAME)
+    {
+      frame++;
+    }
+    return std::min (frame, totalFrames);
+  }
+  return std::min (frame - frame % m_keyframeInterval + m_keyframeInterval, totalFrames);
+}
+
+const std::vector<uint32_t> &
+VideoStreamServer::GetFrameSizeList (uint32_t contentId) const
+{
+  return m_catalog.empty () ? m_frameSizeList : m_catalog[contentId];
+}
+
+uint32_t
+VideoStreamServer::GetFrameSize (uint32_t contentId, uint16_t videoLevel, uint32_t frame) const
+{
+  const std::vector<uint32_t> &renditionFrameSizes = m_renditionFrameSizes[videoLevel - 1];
+  if (!renditionFrameSizes.empty ())
+  {
+    return renditionFrameSizes[frame % renditionFrameSizes.size ()];
+  }
+  const std::vector<uint32_t> &frameSizeList = GetFrameSizeList (contentId);
+  double frameSize;
+  if (!frameSizeList.empty ())
+  {
+    frameSize = frameSizeList[frame] * m_ladder.GetScale (videoLevel);
+  }
+  else if (m_frameGenerator)
+  {
+    frameSize = m_frameGenerator->GetFrameSize (contentId, 1, frame) * m_ladder.GetScale (videoLevel);
+  }
+  else
+  {
+    frameSize = m_ladder.GetRendition (videoLevel).m_bitRate.GetBitRate () * m_interval.GetSeconds () / 8;
+  }
+  return static_cast<uint32_t> (std::max (1.0, std::round (frameSize)));
+}
+
+uint32_t
+VideoStreamServer::GetTotalFrames (uint32_t contentId) const
+{
+  const std::vector<uint32_t> &frameSizeList = GetFrameSizeList (contentId);
+  return frameSizeList.empty () ? m_videoLength * m_frameRate : frameSizeList.size ();
 }
 
 std::string
@@ -162,53 +615,523 @@ VideoStreamServer::GetMaxPacketSize (void) const
   return m_maxPacketSize;
 }
 
+uint64_t
+VideoStreamServer::GetClientKey (const InetSocketAddress &address)
+{
+  return (static_cast<uint64_t> (address.GetIpv4 ().Get ()) << 16) | address.GetPort ();
+}
+
+uint32_t
+VideoStreamServer::GetActiveSessions (void) const
+{
+  return m_clients.size ();
+}
+
+uint32_t
+VideoStreamServer::GetQueueLength (void) const
+{
+  return m_admissionQueue.size ();
+}
+
+uint32_t
+VideoStreamServer::GetAdmittedSessions (void) const
+{
+  return m_admittedSessions;
+}
+
+uint32_t
+VideoStreamServer::GetRejectedSessions (void) const
+{
+  return m_rejectedSessions;
+}
+
+uint32_t
+VideoStreamServer::GetQueuedSessions (void) const
+{
+  return m_queuedSessions;
+}
+
+uint32_t
+VideoStreamServer::GetCappedSessions (void) const
+{
+  return m_cappedSessions;
+}
+
+uint32_t
+VideoStreamServer::GetReceivedReports (void) const
+{
+  return m_receivedReports;
+}
+
+const VideoStreamHistogram &
+VideoStreamServer::GetReportedJitterHistogram (void) const
+{
+  return m_reportedJitter;
+}
+
+const VideoStreamHistogram &
+VideoStreamServer::GetSendLagHistogram (void) const
+{
+  return m_sendLag;
+}
+
+uint32_t
+VideoStreamServer::GetJoinedSubflows (void) const
+{
+  return m_joinedSubflows;
+}
+
+DataRate
+VideoStreamServer::GetReservedRate (void) const
+{
+  return DataRate (m_reservedRate);
+}
+
+uint32_t
+VideoStreamServer::GetSessionPacketSize (const Address &address, uint32_t clientMtu) const
+{
+  if (m_fragmentSizing == FRAGMENT_FIXED)
+  {
+    return m_maxPacketSize;
+  }
+
+  uint32_t mtu = m_pathMtu;
+  if (mtu == 0)
+  {
+    // the device the route to the client leaves from
+    Ptr<Ipv4> ipv4 = GetNode ()->GetObject<Ipv4> ();
+    if (ipv4 != 0 && ipv4->GetRoutingProtocol () != 0)
+    {
+      Ipv4Header header;
+      header.SetDestination (InetSocketAddress::ConvertFrom (address).GetIpv4 ());
+      Socket::SocketErrno error;
+      Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol ()->RouteOutput (0, header, 0, error);
+      if (route != 0 && route->GetOutputDevice () != 0)
+      {
+        mtu = route->GetOutputDevice ()->GetMtu ();
+      }
+    }
+    if (clientMtu > 0)
+    {
+      mtu = mtu > 0 ? std::min (mtu, clientMtu) : clientMtu;
+    }
+  }
+  if (!m_jumbo)
+  {
+    mtu = std::min (mtu, ETHERNET_MTU);
+  }
+  if (mtu <= IPV4_UDP_HEADERS + MIN_FRAGMENT_SIZE)
+  {
+    return m_maxPacketSize;
+  }
+  return mtu - IPV4_UDP_HEADERS;
+}
+
+uint64_t
+VideoStreamServer::GetSessionRate (uint32_t contentId, uint16_t videoLevel) const
+{
+  if (m_renditionMeanFrameSizes[videoLevel - 1] > 0)
+  {
+    return m_renditionMeanFrameSizes[videoLevel - 1] * 8 / m_interval.GetSeconds ();
+  }
+  if (GetFrameSizeList (contentId).empty () && !m_frameGenerator)
+  {
+    return m_ladder.GetRendition (videoLevel).m_bitRate.GetBitRate ();
+  }
+  double frameSize = GetFrameSizeList (contentId).empty () ? m_frameGenerator->GetMeanFrameSize (1) : m_meanFrameSizes[contentId];
+  return frameSize * m_ladder.GetScale (videoLevel) * 8 / m_interval.GetSeconds ();
+}
+
+uint16_t
+VideoStreamServer::GetAdmissionLevel (const ClientInfo *client) const
+{
+  if (m_maxSessions > 0 && m_clients.size () >= m_maxSessions)
+  {
+    return 0;
+  }
+  uint64_t budget = m_egressBudget.GetBitRate ();
+  if (budget == 0)
+  {
+    return client->m_videoLevel;
+  }
+  for (uint16_t videoLevel = client->m_videoLevel; videoLevel >= 1; videoLevel--)
+  {
+    if (m_reservedRate + GetSessionRate (client->m_contentId, videoLevel) <= budget)
+    {
+      return videoLevel;
+    }
+    if (m_admissionPolicy != ADMISSION_CAP)
+    {
+      break;
+    }
+  }
+  return 0;
+}
+
+void
+VideoStreamServer::AdmitClient (ClientInfo *client, uint16_t videoLevel)
+{
+  if (videoLevel < client->m_videoLevel)
+  {
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server capped a session from level " << client->m_videoLevel << " to " << videoLevel);
+    m_cappedSessions++;
+  }
+  client->m_videoLevel = videoLevel;
+  client->m_requestedLevel = videoLevel;
+  client->m_sequence = 0;
+  client->m_targetRate = 0;
+  client->m_trickPlay = false;
+  client->m_discontinuity = false;
+  client->m_subflows.assign (1, Subflow ());
+  client->m_subflows[0].m_address = client->m_address;
+  StartBurst (client);
+  client->m_session = m_nextSession++;
+  m_clients[GetClientKey (InetSocketAddress::ConvertFrom (client->m_address))] = client;
+  m_reservedRate += GetSessionRate (client->m_contentId, videoLevel);
+  m_admittedSessions++;
+  m_eventLog.Add (VideoStreamEventLog::SERVER_SESSION_START, client->m_session, client->m_contentId, 0, videoLevel);
+  SendHelloAck (client);
+  client->m_sendEvent = Simulator::Schedule (Seconds (0.0), &VideoStreamServer::Send, this, GetClientKey (InetSocketAddress::ConvertFrom (client->m_address)));
+}
+
+void
+VideoStreamServer::StartBurst (ClientInfo *client)
+{
+  // a live session has no frames ahead of the live edge to burst, fast forward has no buffer to fill
+  client->m_burstFrames = m_live || client->m_trickPlay ? 0 : m_fastStartFrames;
+  if (client->m_bufferCapacity > 0)
+  {
+    client->m_burstFrames = std::min (client->m_burstFrames, client->m_bufferCapacity);
+  }
+}
+
+void
+VideoStreamServer::ApplyVideoLevel (ClientInfo *client)
+{
+  uint16_t videoLevel = client->m_requestedLevel;
+  while (m_rateControl && client->m_targetRate > 0 && videoLevel > 1 &&
+         GetSessionRate (client->m_contentId, videoLevel) > client->m_targetRate)
+  {
+    videoLevel--;
+  }
+  uint64_t otherRate = m_reservedRate - GetSessionRate (client->m_contentId, client->m_videoLevel);
+  uint64_t budget = m_egressBudget.GetBitRate ();
+  while (budget > 0 && videoLevel > 1 && otherRate + GetSessionRate (client->m_contentId, videoLevel) > budget)
+  {
+    // an upgrade must not take the bitrate reserved for the other sessions
+    videoLevel--;
+  }
+  client->m_videoLevel = videoLevel;
+  m_reservedRate = otherRate + GetSessionRate (client->m_contentId, videoLevel);
+}
+
+void
+VideoStreamServer::UpdateRateControl (ClientInfo *client, const VideoStreamReportHeader &report)
+{
+  // one-way delay growth above 1 ms per second counts as a building queue
+  static const Time OVERUSE_TREND = MilliSeconds (1);
+
+  if (!m_rateControl || report.GetDuration ().IsZero ())
+  {
+    return;
+  }
+  double receivedRate = report.GetReceivedBytes () * 8.0 / report.GetDuration ().GetSeconds ();
+  double loss = report.GetLossFraction ();
+  double maxRate = GetSessionRate (client->m_contentId, client->m_requestedLevel);
+  double targetRate = client->m_targetRate > 0 ? client->m_targetRate : maxRate;
+  if (loss > 0.1)
+  {
+    targetRate *= 1 - 0.5 * loss;
+  }
+  else if (report.GetDelayTrend () > OVERUSE_TREND)
+  {
+    targetRate = std::min (targetRate, 0.85 * receivedRate);
+  }
+  else if (loss < 0.02 && Abs (report.GetDelayTrend ()) <= OVERUSE_TREND)
+  {
+    targetRate = std::min (targetRate * 1.08, maxRate);
+  }
+  client->m_targetRate = std::max (targetRate, 1.0);
+
+  uint16_t videoLevel = client->m_videoLevel;
+  ApplyVideoLevel (client);
+  m_rateControlTrace (client->m_session, DataRate (client->m_targetRate), client->m_videoLevel);
+  if (client->m_videoLevel != videoLevel)
+  {
+    NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server rate control moved session " << client->m_session
+                 << " to level " << client->m_videoLevel << ", loss " << loss << ", delay trend " << report.GetDelayTrend ().GetMicroSeconds () << "us/s");
+    m_eventLog.Add (VideoStreamEventLog::SERVER_LEVEL_CHANGED, client->m_session, client->m_sent, client->m_targetRate / 8, client->m_videoLevel);
+  }
+}
+
+void
+VideoStreamServer::RemoveClient (uint64_t clientKey)
+{
+  auto iter = m_clients.find (clientKey);
+  if (iter == m_clients.end ())
+  {
+    return;
+  }
+  ClientInfo *client = iter->second;
+  Simulator::Cancel (client->m_sendEvent);
+  m_reservedRate -= GetSessionRate (client->m_contentId, client->m_videoLevel);
+  m_eventLog.Add (VideoStreamEventLog::SERVER_SESSION_END, client->m_session, client->m_sent, 0, client->m_videoLevel);
+  for (uint32_t index = 1; index < client->m_subflows.size (); index++)
+  {
+    const Subflow &subflow = client->m_subflows[index];
+    m_subflowSessions.erase (GetClientKey (InetSocketAddress::ConvertFrom (subflow.m_address)));
+    NS_LOG_INFO ("Session " << client->m_session << " sent " << subflow.m_sentBytes << " bytes on path " << static_cast<uint32_t> (subflow.m_path)
+                 << ", " << client->m_subflows[0].m_sentBytes << " on its session path");
+  }
+  m_clients.erase (iter);
+  delete client;
+
+  // admit the queued sessions in order, as long as the oldest one fits
+  while (!m_admissionQueue.empty ())
+  {
+    uint16_t videoLevel = GetAdmissionLevel (m_admissionQueue.front ());
+    if (videoLevel == 0)
+    {
+      break;
+    }
+    ClientInfo *queued = m_admissionQueue.front ();
+    m_admissionQueue.pop_front ();
+    if (m_live)
+    {
+      // the live edge moved while the session waited
+      queued->m_sent = GetLiveFrame ();
+    }
+    AdmitClient (queued, videoLevel);
+  }
+}
+
+void
+VideoStreamServer::SendReject (ClientInfo *client)
+{
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::REJECT);
+  header.SetContentId (client->m_contentId);
+  header.SetVideoLevel (client->m_videoLevel);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (header);
+  m_socket->SendTo (p, 0, client->m_address);
+}
+
+void
+VideoStreamServer::SendHelloAck (ClientInfo *client)
+{
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::HELLO_ACK);
+  header.SetContentId (client->m_contentId);
+  header.SetVideoLevel (client->m_videoLevel);
+  header.SetFrame (client->m_sent);
+  header.SetSequence (client->m_maxPacketSize);
+  VideoStreamSessionHeader session;
+  session.SetMaxVideoLevel (client->m_maxLevel);
+  session.SetBufferCapacity (client->m_bufferCapacity);
+  session.SetAttempt (client->m_helloAttempt);
+  session.SetTotalFrames (GetTotalFrames (client->m_contentId));
+  session.SetFrameInterval (m_interval);
+  session.SetMaxHeight (m_ladder.GetRendition (client->m_maxLevel).m_height);
+  VideoStreamLadderHeader ladder;
+  ladder.SetLadder (m_ladder);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (ladder);
+  p->AddHeader (session);
+  p->AddHeader (header);
+  m_socket->SendTo (p, 0, client->m_address);
+}
+
+uint32_t
+VideoStreamServer::GetLiveFrame (void) const
+{
+  return (Simulator::Now () - m_liveStart).GetNanoSeconds () / m_interval.GetNanoSeconds ();
+}
+
+void
+VideoStreamServer::SendLoadReport (void)
+{
+  // sent from the socket of the sessions, so the router learns the port clients are redirected to
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::LOAD);
+  VideoStreamLoadHeader load;
+  load.SetActiveSessions (m_clients.size ());
+  load.SetQueueLength (m_admissionQueue.size ());
+  load.SetMaxSessions (m_maxSessions);
+  load.SetReservedRate (DataRate (m_reservedRate));
+  load.SetEgressBudget (m_egressBudget);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (load);
+  p->AddHeader (header);
+  m_socket->SendTo (p, 0, InetSocketAddress (Ipv4Address::ConvertFrom (m_routerAddress), m_routerPort));
+  m_loadEvent = Simulator::Schedule (m_loadReportInterval, &VideoStreamServer::SendLoadReport, this);
+}
+
+Time
+VideoStreamServer::GetProductionTime (uint32_t frame) const
+{
+  if (!m_live)
+  {
+    return Simulator::Now ();
+  }
+  return m_liveStart + NanoSeconds (m_interval.GetNanoSeconds () * frame);
+}
+
 void 
-VideoStreamServer::Send (uint32_t ipAddress)
+VideoStreamServer::Send (uint64_t clientKey)
 {
   NS_LOG_FUNCTION (this);
 
-  uint32_t frameSize, totalFrames;
-  ClientInfo *clientInfo = m_clients.at (ipAddress);
+  ClientInfo *clientInfo = m_clients.at (clientKey);
 
   NS_ASSERT (clientInfo->m_sendEvent.IsExpired ());
-  // If the frame sizes are not from the text file, and the list is empty
-  if (m_frameSizeList.empty ())
+  uint32_t frameSize = GetFrameSize (clientInfo->m_contentId, clientInfo->m_videoLevel, clientInfo->m_sent);
+  uint32_t totalFrames = GetTotalFrames (clientInfo->m_contentId);
+
+  // the frame might require several packets to send
+  uint32_t maxPacketSize = clientInfo->m_maxPacketSize;
+  uint32_t packets = (frameSize + maxPacketSize - 1) / maxPacketSize;
+  uint32_t lastSize = frameSize - (packets - 1) * maxPacketSize;
+  uint32_t borrowed = 0;
+  if (packets > 1 && lastSize < MIN_FRAGMENT_SIZE)
   {
-    frameSize = m_frameSizes[clientInfo->m_videoLevel];
-    totalFrames = m_videoLength * m_frameRate;
+    // every fragment carries the header, so a tiny remainder borrows from the previous fragment
+    borrowed = MIN_FRAGMENT_SIZE - lastSize;
+  }
+  // fast forward sends the keyframes only
+  uint32_t next = clientInfo->m_trickPlay ? GetNextKeyframe (clientInfo->m_contentId, clientInfo->m_sent) : clientInfo->m_sent + 1;
+  uint8_t flags = next >= totalFrames ? VideoStreamHeader::LAST_FRAME : 0;
+  if (clientInfo->m_trickPlay)
+  {
+    flags |= VideoStreamHeader::TRICK_PLAY;
+  }
+  if (m_live)
+  {
+    flags |= VideoStreamHeader::LIVE;
+    m_sendLag.Record (Simulator::Now () - GetProductionTime (clientInfo->m_sent));
+  }
+  // consecutive fragments can share one packet that keeps their bytes and sequence numbers
+  uint32_t aggregate = std::max<uint32_t> (1, std::min<uint32_t> (m_frameAggregation, MAX_DATAGRAM_SIZE / maxPacketSize));
+  for (uint32_t first = 0; first < packets; first += aggregate)
+  {
+    uint32_t last = std::min (first + aggregate, packets) - 1;
+    uint32_t packetSize = (last - first + 1) * maxPacketSize;
+    if (last + 1 == packets)
+    {
+      packetSize -= maxPacketSize - lastSize;
+    }
+    if (first + 1 == packets)
+    {
+      packetSize += borrowed;
+    }
+    if (last + 2 == packets)
+    {
+      packetSize -= borrowed;
+    }
+    uint8_t packetFlags = last + 1 == packets ? flags | VideoStreamHeader::LAST_FRAGMENT : flags;
+    if (clientInfo->m_discontinuity)
+    {
+      // lets the client tell the frames of the new position from those sent before the SEEK
+      packetFlags |= VideoStreamHeader::DISCONTINUITY;
+      clientInfo->m_discontinuity = false;
+    }
+    SendPacket (clientInfo, packetSize, packetFlags, last - first + 1);
+  }
+
+  m_eventLog.Add (VideoStreamEventLog::SERVER_FRAME_SENT, clientInfo->m_session, clientInfo->m_sent, frameSize, clientInfo->m_videoLevel);
+  NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s server sent frame " << clientInfo->m_sent << " and " << frameSize << " bytes to " << InetSocketAddress::ConvertFrom (clientInfo->m_address).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (clientInfo->m_address).GetPort ());
+
+  clientInfo->m_sent = next;
+  if (clientInfo->m_sent < totalFrames)
+  {
+    // a live frame cannot be sent before it is produced
+    Time delay = m_live ? Max (GetProductionTime (clientInfo->m_sent) - Simulator::Now (), Seconds (0.0)) : m_interval;
+    if (clientInfo->m_burstFrames > 0)
+    {
+      // the burst is paced at FastStartRate, but never slower than real time
+      clientInfo->m_burstFrames--;
+      delay = m_fastStartRate.GetBitRate () > 0 ? Min (delay, m_fastStartRate.CalculateBytesTxTime (frameSize)) : Seconds (0.0);
+    }
+    clientInfo->m_sendEvent = Simulator::Schedule (delay, &VideoStreamServer::Send, this, clientKey);
   }
   else
   {
-    frameSize = m_frameSizeList[clientInfo->m_sent] * clientInfo->m_videoLevel;
-    totalFrames = m_frameSizeList.size ();
+    RemoveClient (clientKey);
   }
+}
 
-  // the frame might require several packets to send
-  for (uint i = 0; i < frameSize / m_maxPacketSize; i++)
+uint32_t
+VideoStreamServer::SelectSubflow (ClientInfo *client, uint32_t packetSize)
+{
+  uint32_t selected = 0;
+  Time selectedArrival;
+  Time selectedDeparture;
+  for (uint32_t index = 0; index < client->m_subflows.size (); index++)
   {
-    SendPacket (clientInfo, m_maxPacketSize);
+    const Subflow &subflow = client->m_subflows[index];
+    uint64_t rate = subflow.m_rate > 0 ? subflow.m_rate : std::max<uint64_t> (GetSessionRate (client->m_contentId, client->m_videoLevel), 1);
+    Time departure = Max (subflow.m_busyUntil, Simulator::Now ()) + Seconds (packetSize * 8.0 / rate);
+    Time arrival = departure + subflow.m_delay;
+    if (index == 0 || arrival < selectedArrival)
+    {
+      selected = index;
+      selectedArrival = arrival;
+      selectedDeparture = departure;
+    }
   }
-  uint32_t remainder = frameSize % m_maxPacketSize;
-  SendPacket (clientInfo, remainder);
+  client->m_subflows[selected].m_busyUntil = selectedDeparture;
+  client->m_subflows[selected].m_sentBytes += packetSize;
+  return selected;
+}
 
-  NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server sent frame " << clientInfo->m_sent << " and " << frameSize << " bytes to " << InetSocketAddress::ConvertFrom (clientInfo->m_address).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (clientInfo->m_address).GetPort ());
+void
+VideoStreamServer::UpdateSubflow (Subflow &subflow, const VideoStreamPathReportHeader &report)
+{
+  // a mean delay this far above the smallest one means a queue builds on the path
+  static const Time QUEUE_DELAY = MilliSeconds (10);
 
-  clientInfo->m_sent += 1;
-  if (clientInfo->m_sent < totalFrames)
+  if (report.GetDuration ().IsZero () || report.GetReceivedBytes () == 0)
   {
-    clientInfo->m_sendEvent = Simulator::Schedule (m_interval, &VideoStreamServer::Send, this, ipAddress);
+    return;
+  }
+  double receivedRate = report.GetReceivedBytes () * 8.0 / report.GetDuration ().GetSeconds ();
+  if (subflow.m_minDelay.IsZero () || report.GetDelay () < subflow.m_minDelay)
+  {
+    subflow.m_minDelay = report.GetDelay ();
+  }
+  subflow.m_delay = report.GetDelay ();
+  if (subflow.m_delay > subflow.m_minDelay + QUEUE_DELAY)
+  {
+    subflow.m_rate = std::max (0.9 * receivedRate, 1.0);
+  }
+  else
+  {
+    subflow.m_rate = std::max<uint64_t> (subflow.m_rate, 1.25 * receivedRate);
   }
 }
 
 void 
-VideoStreamServer::SendPacket (ClientInfo *client, uint32_t packetSize)
+VideoStreamServer::SendPacket (ClientInfo *client, uint32_t packetSize, uint8_t flags, uint16_t fragments)
 {
-  std::vector<uint8_t>dataBuffer(packetSize);
-  sprintf ((char *) dataBuffer.data(), "%u", client->m_sent);
-  Ptr<Packet> p = Create<Packet> (dataBuffer.data(), packetSize);
-  if (m_socket->SendTo (p, 0, client->m_address) < 0)
+  VideoStreamHeader header;
+  header.SetMessageType (VideoStreamHeader::DATA);
+  header.SetFlags (flags);
+  header.SetVideoLevel (client->m_videoLevel);
+  header.SetContentId (client->m_contentId);
+  header.SetFrame (client->m_sent);
+  header.SetTimestamp (GetProductionTime (client->m_sent));
+  header.SetSequence (client->m_sequence);
+  header.SetFragments (fragments);
+  client->m_sequence += fragments;
+  Ptr<Packet> p = Create<Packet> (packetSize > MIN_FRAGMENT_SIZE ? packetSize - MIN_FRAGMENT_SIZE : 0);
+  p->AddHeader (header);
+  m_txTrace (p);
+  // a multipath session spreads its fragments over its subflows
+  const Address &to = client->m_subflows.size () > 1 ? client->m_subflows[SelectSubflow (client, packetSize)].m_address : client->m_address;
+  if (m_socket->SendTo (p, 0, to) < 0)
   {
-    NS_LOG_INFO ("Error while sending " << packetSize << "bytes to " << InetSocketAddress::ConvertFrom (client->m_address).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (client->m_address).GetPort ());
+    m_eventLog.Add (VideoStreamEventLog::SERVER_SEND_ERROR, client->m_session, client->m_sent, packetSize, client->m_videoLevel);
+    NS_LOG_INFO ("Error while sending " << packetSize << "bytes to " << InetSocketAddress::ConvertFrom (to).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (to).GetPort ());
   }
 }
 
@@ -225,30 +1148,213 @@ VideoStreamServer::HandleRead (Ptr<Socket> socket)
     socket->GetSockName (localAddress);
     if (InetSocketAddress::IsMatchingType (from))
     {
-      NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server received " << packet->GetSize () << " bytes from " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (from).GetPort ());
+      NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s server received " << packet->GetSize () << " bytes from " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " port " << InetSocketAddress::ConvertFrom (from).GetPort ());
 
-      uint32_t ipAddr = InetSocketAddress::ConvertFrom (from).GetIpv4 ().Get ();
+      VideoStreamHeader header;
+      if (packet->GetSize () < header.GetSerializedSize ())
+      {
+        NS_LOG_WARN ("Dropping a " << packet->GetSize () << " byte packet without a video stream header");
+        continue;
+      }
+      packet->RemoveHeader (header);
+
+      uint64_t clientKey = GetClientKey (InetSocketAddress::ConvertFrom (from));
+      auto iter = m_clients.find (clientKey);
 
       // the first time we received the message from the client
-      if (m_clients.find (ipAddr) == m_clients.end ())
+      if (header.GetMessageType () == VideoStreamHeader::HELLO && iter == m_clients.end ())
       {
+        uint32_t contentId = header.GetContentId ();
+        if (contentId >= GetTitleCount ())
+        {
+          NS_LOG_WARN ("Ignoring a request for title " << contentId << " missing from the catalog");
+          continue;
+        }
+        // a proxy asks for a video level and can resume a title in the middle
+        uint16_t videoLevel = header.GetVideoLevel ();
+        uint32_t totalFrames = GetTotalFrames (contentId);
+        uint32_t firstFrame = header.GetFrame () < totalFrames ? header.GetFrame () : 0;
+        if (m_live)
+        {
+          // live clients join at the live edge
+          firstFrame = GetLiveFrame ();
+          if (firstFrame >= totalFrames)
+          {
+            NS_LOG_WARN ("Ignoring a request for title " << contentId << " after the end of the live stream");
+            continue;
+          }
+        }
+        if (std::any_of (m_admissionQueue.begin (), m_admissionQueue.end (),
+                         [clientKey] (const ClientInfo *queued) { return GetClientKey (InetSocketAddress::ConvertFrom (queued->m_address)) == clientKey; }))
+        {
+          continue;
+        }
+        // clients announce the highest level they play, their buffer and their display after the header
+        VideoStreamSessionHeader hello;
+        if (packet->GetSize () >= hello.GetSerializedSize ())
+        {
+          packet->RemoveHeader (hello);
+        }
         ClientInfo *newClient = new ClientInfo();
-        newClient->m_sent = 0;
-        newClient->m_videoLevel = 3;
+        newClient->m_sent = firstFrame;
+        newClient->m_maxLevel = m_ladder.GetMaxLevel (hello.GetMaxHeight ());
+        if (hello.GetMaxVideoLevel () > 0)
+        {
+          newClient->m_maxLevel = std::min (newClient->m_maxLevel, hello.GetMaxVideoLevel ());
+        }
+        newClient->m_bufferCapacity = hello.GetBufferCapacity ();
+        newClient->m_helloAttempt = hello.GetAttempt ();
+        newClient->m_videoLevel = videoLevel >= 1 && videoLevel <= m_ladder.GetLevelCount () ? videoLevel : m_initialVideoLevel;
+        newClient->m_videoLevel = std::min (newClient->m_videoLevel, newClient->m_maxLevel);
+        newClient->m_contentId = contentId;
         newClient->m_address = from;
-        // newClient->m_sendEvent = EventId ();
-        m_clients[ipAddr] = newClient;
-        newClient->m_sendEvent = Simulator::Schedule (Seconds (0.0), &VideoStreamServer::Send, this, ipAddr);
+        newClient->m_maxPacketSize = GetSessionPacketSize (from, header.GetSequence ());
+        m_titleRequests[contentId]++;
+
+        uint16_t admittedLevel = m_admissionQueue.empty () ? GetAdmissionLevel (newClient) : 0;
+        if (admittedLevel > 0)
+        {
+          AdmitClient (newClient, admittedLevel);
+        }
+        else if (m_admissionPolicy == ADMISSION_QUEUE)
+        {
+          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server queued a session, " << m_admissionQueue.size () << " already waiting");
+          m_eventLog.Add (VideoStreamEventLog::SERVER_SESSION_QUEUED, 0, contentId, packet->GetSize (), newClient->m_videoLevel);
+          m_admissionQueue.push_back (newClient);
+          m_queuedSessions++;
+        }
+        else
+        {
+          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server rejected a session, " << m_clients.size () << " active");
+          m_eventLog.Add (VideoStreamEventLog::SERVER_SESSION_REJECTED, 0, contentId, packet->GetSize (), newClient->m_videoLevel);
+          SendReject (newClient);
+          m_rejectedSessions++;
+          delete newClient;
+        }
       }
-      else
+      else if (header.GetMessageType () == VideoStreamHeader::HELLO)
       {
-        uint8_t dataBuffer[10];
-        packet->CopyData (dataBuffer, 10);
-
-        uint16_t videoLevel;
-        sscanf((char *) dataBuffer, "%hu", &videoLevel);
+        // the acknowledgement of an admitted session was lost, a queued session waits
+        if (iter != m_clients.end ())
+        {
+          VideoStreamSessionHeader hello;
+          if (packet->GetSize () >= hello.GetSerializedSize ())
+          {
+            packet->RemoveHeader (hello);
+            iter->second->m_helloAttempt = hello.GetAttempt ();
+          }
+          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server acknowledges a repeated hello of session " << iter->second->m_session);
+          SendHelloAck (iter->second);
+        }
+      }
+      else if (header.GetMessageType () == VideoStreamHeader::SEEK && iter != m_clients.end () && !m_live)
+      {
+        ClientInfo *clientInfo = iter->second;
+        uint32_t totalFrames = GetTotalFrames (clientInfo->m_contentId);
+        uint32_t frame = std::min (header.GetFrame (), totalFrames - 1);
+        clientInfo->m_sent = GetKeyframe (clientInfo->m_contentId, frame);
+        clientInfo->m_trickPlay = header.GetFlags () & VideoStreamHeader::TRICK_PLAY;
+        clientInfo->m_discontinuity = true;
+        // the flushed buffer of the client refills like at the start of the session
+        StartBurst (clientInfo);
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server moved session " << clientInfo->m_session
+                     << " to frame " << clientInfo->m_sent << (clientInfo->m_trickPlay ? " in fast forward" : ""));
+        m_eventLog.Add (VideoStreamEventLog::SERVER_SEEK, clientInfo->m_session, clientInfo->m_sent, packet->GetSize (), clientInfo->m_videoLevel);
+        Simulator::Cancel (clientInfo->m_sendEvent);
+        clientInfo->m_sendEvent = Simulator::Schedule (Seconds (0.0), &VideoStreamServer::Send, this, clientKey);
+      }
+      else if (header.GetMessageType () == VideoStreamHeader::LEVEL && iter != m_clients.end ())
+      {
+        uint16_t videoLevel = header.GetVideoLevel ();
         NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server received video level " << videoLevel);
-        m_clients.at (ipAddr)->m_videoLevel = videoLevel;
+        ClientInfo *clientInfo = iter->second;
+        // the offered levels are on the ladder
+        clientInfo->m_requestedLevel = std::max<uint16_t> (1, std::min (videoLevel, clientInfo->m_maxLevel));
+        ApplyVideoLevel (clientInfo);
+        m_eventLog.Add (VideoStreamEventLog::SERVER_LEVEL_CHANGED, clientInfo->m_session, clientInfo->m_sent, packet->GetSize (), clientInfo->m_videoLevel);
+      }
+      else if (header.GetMessageType () == VideoStreamHeader::REPORT && iter != m_clients.end ())
+      {
+        VideoStreamReportHeader report;
+        if (packet->GetSize () < report.GetSerializedSize ())
+        {
+          continue;
+        }
+        packet->RemoveHeader (report);
+        NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s server received report " << report);
+        m_receivedReports++;
+        m_reportedJitter.Record (report.GetJitter ());
+        UpdateRateControl (iter->second, report);
+      }
+      else if (header.GetMessageType () == VideoStreamHeader::JOIN && iter == m_clients.end ())
+      {
+        VideoStreamJoinHeader join;
+        if (packet->GetSize () < join.GetSerializedSize ())
+        {
+          continue;
+        }
+        packet->RemoveHeader (join);
+        auto session = m_clients.find (GetClientKey (InetSocketAddress (join.GetSessionAddress (), join.GetSessionPort ())));
+        if (session == m_clients.end ())
+        {
+          // the session is queued or over, the client repeats its JOIN
+          continue;
+        }
+        ClientInfo *clientInfo = session->second;
+        if (m_subflowSessions.find (clientKey) == m_subflowSessions.end ())
+        {
+          clientInfo->m_subflows.push_back (Subflow ());
+          clientInfo->m_subflows.back ().m_address = from;
+          clientInfo->m_subflows.back ().m_path = join.GetPath ();
+          m_subflowSessions[clientKey] = session->first;
+          m_joinedSubflows++;
+          NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server joined path " << static_cast<uint32_t> (join.GetPath ())
+                       << " from " << InetSocketAddress::ConvertFrom (from).GetIpv4 () << " to session " << clientInfo->m_session);
+          m_eventLog.Add (VideoStreamEventLog::SERVER_SUBFLOW_JOINED, clientInfo->m_session, clientInfo->m_sent, join.GetPath (), clientInfo->m_videoLevel);
+        }
+        // the echo tells the client the path carries the session
+        Ptr<Packet> p = Create<Packet> ();
+        p->AddHeader (join);
+        p->AddHeader (header);
+        m_socket->SendTo (p, 0, from);
+      }
+      else if (header.GetMessageType () == VideoStreamHeader::PATH_REPORT)
+      {
+        VideoStreamPathReportHeader report;
+        auto subflowSession = m_subflowSessions.find (clientKey);
+        if (packet->GetSize () < report.GetSerializedSize () || (iter == m_clients.end () && subflowSession == m_subflowSessions.end ()))
+        {
+          continue;
+        }
+        packet->RemoveHeader (report);
+        ClientInfo *clientInfo = iter != m_clients.end () ? iter->second : m_clients.at (subflowSession->second);
+        for (Subflow &subflow : clientInfo->m_subflows)
+        {
+          if (subflow.m_address == from)
+          {
+            UpdateSubflow (subflow, report);
+            NS_LOG_LOGIC ("At time " << Simulator::Now ().GetSeconds () << "s server received path report " << report
+                          << ", path rate " << subflow.m_rate << "bps");
+            break;
+          }
+        }
+      }
+      else if (header.GetMessageType () == VideoStreamHeader::BYE)
+      {
+        NS_LOG_INFO ("At time " << Simulator::Now ().GetSeconds () << "s server received a bye");
+        if (iter != m_clients.end ())
+        {
+          RemoveClient (clientKey);
+        }
+        for (auto queued = m_admissionQueue.begin (); queued != m_admissionQueue.end (); queued++)
+        {
+          if (GetClientKey (InetSocketAddress::ConvertFrom ((*queued)->m_address)) == clientKey)
+          {
+            delete *queued;
+            m_admissionQueue.erase (queued);
+            break;
+          }
+        }
       }
     }
   }
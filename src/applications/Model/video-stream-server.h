@@ -8,10 +8,19 @@
 #include "ns3/ptr.h"
 #include "ns3/string.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/inet-socket-address.h"
 #include "ns3/traced-callback.h"
+#include "ns3/data-rate.h"
+#include "video-stream-event-log.h"
+#include "video-stream-frame-generator.h"
+#include "video-stream-header.h"
+#include "video-stream-histogram.h"
+#include "video-stream-ladder.h"
 
+#include <deque>
 #include <fstream>
 #include <unordered_map>
+#include <vector>
 namespace ns3 {
 
 class Socket;
@@ -30,6 +39,25 @@ class Packet;
      */
     static TypeId GetTypeId (void);
 
+    /**
+     * @brief What to do with a session that does not fit in MaxSessions or EgressBudget.
+     */
+    enum AdmissionPolicy
+    {
+      ADMISSION_REJECT = 0, //!< Reject the session
+      ADMISSION_QUEUE = 1, //!< Queue the session until another one ends
+      ADMISSION_CAP = 2 //!< Admit the session at the highest video level that fits, reject it if none does
+    };
+
+    /**
+     * @brief How the size of the fragments of a session is chosen.
+     */
+    enum FragmentSizing
+    {
+      FRAGMENT_FIXED = 0, //!< MaxPacketSize for every session
+      FRAGMENT_PATH_MTU = 1 //!< The largest fragment that fits in the path MTU of the session
+    };
+
     VideoStreamServer ();
 
     virtual ~VideoStreamServer ();
@@ -62,6 +90,191 @@ class Packet;
      */
     uint32_t GetMaxPacketSize (void) const;
 
+    /**
+     * @brief Set the catalog of titles.
+     * 
+     * @param catalog a manifest with one frame file per line, or a directory of frame files
+     */
+    void SetCatalog (std::string catalog);
+
+    /**
+     * @brief Get the catalog of titles.
+     * 
+     * @return the manifest or directory name
+     */
+    std::string GetCatalog (void) const;
+
+    /**
+     * @brief Set the bitrate ladder.
+     * 
+     * @param ladder the renditions of the video levels, see VideoStreamLadder
+     */
+    void SetLadder (std::string ladder);
+
+    /**
+     * @brief Get the bitrate ladder.
+     * 
+     * @return the renditions of the video levels, see VideoStreamLadder
+     */
+    std::string GetLadder (void) const;
+
+    /**
+     * @brief Get the number of video levels.
+     * 
+     * @return the number of renditions of the ladder
+     */
+    uint16_t GetLevelCount (void) const;
+
+    /**
+     * @brief Set the generator of the frame sizes, used when there is no frame file or catalog.
+     * 
+     * @param frameGenerator the generator, null for the built-in frame sizes
+     */
+    void SetFrameGenerator (Ptr<VideoStreamFrameGenerator> frameGenerator);
+
+    /**
+     * @brief Get the generator of the frame sizes.
+     * 
+     * @return the generator, null if not set
+     */
+    Ptr<VideoStreamFrameGenerator> GetFrameGenerator (void) const;
+
+    /**
+     * @brief Get the number of titles the server can stream.
+     * 
+     * @return the number of titles of the catalog or of the frame generator, 1 otherwise
+     */
+    uint32_t GetTitleCount (void) const;
+
+    /**
+     * @brief Get the number of sessions that requested a title.
+     * 
+     * @param contentId the content ID of the title
+     * @return the number of requests
+     */
+    uint32_t GetRequestCount (uint32_t contentId) const;
+
+    /**
+     * @brief Get the keyframe a seek to a frame resumes from.
+     * 
+     * Frame files carry no frame types, so their keyframes are indexed when
+     * they are loaded: a GOP starts every KeyframeInterval frames, or earlier
+     * at a frame at least twice the mean size of the GOP so far, which is
+     * taken for the I frame of a scene change. The frame generator knows its
+     * I frames, and the built-in frame sizes have a keyframe every
+     * KeyframeInterval frames.
+     * 
+     * @param contentId the content ID of the title
+     * @param frame the frame number
+     * @return the last keyframe at or before the frame
+     */
+    uint32_t GetKeyframe (uint32_t contentId, uint32_t frame) const;
+
+    /**
+     * @brief Get the key identifying a client.
+     * 
+     * Several clients can run on the same node, so the key combines the
+     * ipv4 address and the port of the client.
+     * 
+     * @param address the address of the client
+     * @return the key of the client
+     */
+    static uint64_t GetClientKey (const InetSocketAddress &address);
+
+    /**
+     * @brief Get the number of sessions being streamed.
+     * 
+     * @return the number of active sessions
+     */
+    uint32_t GetActiveSessions (void) const;
+
+    /**
+     * @brief Get the number of sessions waiting for admission.
+     * 
+     * @return the length of the admission queue
+     */
+    uint32_t GetQueueLength (void) const;
+
+    /**
+     * @brief Get the number of admitted sessions, including those admitted
+     * from the queue or at a capped level.
+     * 
+     * @return the number of admitted sessions
+     */
+    uint32_t GetAdmittedSessions (void) const;
+
+    /**
+     * @brief Get the number of rejected sessions.
+     * 
+     * @return the number of rejected sessions
+     */
+    uint32_t GetRejectedSessions (void) const;
+
+    /**
+     * @brief Get the number of sessions that were queued before admission.
+     * 
+     * @return the number of queued sessions
+     */
+    uint32_t GetQueuedSessions (void) const;
+
+    /**
+     * @brief Get the number of sessions admitted below their requested video level.
+     * 
+     * @return the number of capped sessions
+     */
+    uint32_t GetCappedSessions (void) const;
+
+    /**
+     * @brief Get the number of receiver reports received.
+     * 
+     * @return the number of reports
+     */
+    uint32_t GetReceivedReports (void) const;
+
+    /**
+     * @brief Get the histogram of the jitter carried by the receiver reports of every session.
+     * 
+     * @return the reported jitter histogram
+     */
+    const VideoStreamHistogram &GetReportedJitterHistogram (void) const;
+
+    /**
+     * @brief Get the histogram of the time between the production and the sending of the live frames.
+     * 
+     * @return the send lag histogram, empty unless the stream is live
+     */
+    const VideoStreamHistogram &GetSendLagHistogram (void) const;
+
+    /**
+     * TracedCallback signature for the rate controller decisions.
+     * 
+     * @param [in] session the session index
+     * @param [in] targetRate the target rate of the session
+     * @param [in] videoLevel the video level sent to the session
+     */
+    typedef void (* RateControlTracedCallback) (uint32_t session, DataRate targetRate, uint16_t videoLevel);
+
+    /**
+     * @brief Get the bitrate reserved by the active sessions.
+     * 
+     * @return the reserved egress bitrate
+     */
+    DataRate GetReservedRate (void) const;
+
+    /**
+     * @brief Get the number of subflows joined to the sessions.
+     * 
+     * @return the number of JOIN accepted
+     */
+    uint32_t GetJoinedSubflows (void) const;
+
+    /**
+     * @brief Get the live edge of a live stream.
+     * 
+     * @return the number of the last frame produced since the server started
+     */
+    uint32_t GetLiveFrame (void) const;
+
   protected:
     virtual void DoDispose (void);
 
@@ -70,30 +283,239 @@ class Packet;
     virtual void StartApplication (void);
     virtual void StopApplication (void);
 
+    /**
+     * @brief A path of a session, the session address being the first one.
+     */
+    typedef struct Subflow
+    {
+      Address m_address; //!< Address of the client end of the path
+      uint8_t m_path; //!< Path index chosen by the client
+      uint64_t m_rate; //!< Estimated rate in bits per second, 0 before the first path report
+      Time m_delay; //!< Mean one-way delay of the last path report
+      Time m_minDelay; //!< Smallest mean one-way delay reported, zero before the first path report
+      Time m_busyUntil; //!< Time the fragments scheduled on the path are expected to have left
+      uint64_t m_sentBytes; //!< Bytes sent on the path
+    } Subflow;
+
     /**
      * @brief The information required for each client.
      */
     typedef struct ClientInfo
     {
       Address m_address; //!< Address
+      uint32_t m_session; //!< Session index used in the event log
       uint32_t m_sent; //!< Counter for sent frames
       uint16_t m_videoLevel; //! Video level
+      uint16_t m_requestedLevel; //!< Video level requested by the client
+      uint16_t m_maxLevel; //!< Highest video level offered to the client
+      uint32_t m_bufferCapacity; //!< Frames the client buffers, 0 if unbounded
+      uint8_t m_helloAttempt; //!< Attempt number of the last HELLO of the client
+      uint32_t m_burstFrames; //!< Frames left to send in the fast-start burst
+      bool m_trickPlay; //!< Whether only the keyframes are sent
+      bool m_discontinuity; //!< Whether the next fragment is the first after a SEEK
+      uint32_t m_contentId; //!< Requested title
+      uint32_t m_sequence; //!< Sequence number of the next packet
+      uint32_t m_maxPacketSize; //!< Largest fragment sent to the client
+      uint64_t m_targetRate; //!< Rate allowed by the rate controller in bits per second, 0 before the first report
+      std::vector<Subflow> m_subflows; //!< Paths of the session, the session address first
       EventId m_sendEvent; //! Send event used by the client
     } ClientInfo; //! To be compatible with C language
 
+    /**
+     * @brief Get the largest fragment of a new session.
+     * 
+     * @param address the address of the client
+     * @param clientMtu the MTU advertised by the client, 0 if unknown
+     * @return the fragment size in bytes
+     */
+    uint32_t GetSessionPacketSize (const Address &address, uint32_t clientMtu) const;
+
     /**
      * @brief Send a packet with specified size.
      * 
+     * @param client the client the packet is sent to
      * @param packetSize the number of bytes for the packet to be sent
+     * @param flags the VideoStreamHeader flags of the packet
+     * @param fragments the number of fragments the packet stands for
      */
-    void SendPacket (ClientInfo *client, uint32_t packetSize);
+    void SendPacket (ClientInfo *client, uint32_t packetSize, uint8_t flags, uint16_t fragments);
     
     /**
-     * @brief Send the video frame to the given ipv4 address.
+     * @brief Choose the path of a packet, the one it is expected to arrive first on.
+     * 
+     * A path is expected to send the packets scheduled on it at its estimated
+     * rate, or at the rate of the session before its first path report, and
+     * to deliver them after its one-way delay.
+     * 
+     * @param client the session
+     * @param packetSize the size of the packet
+     * @return the index of the path in the subflows of the session
+     */
+    uint32_t SelectSubflow (ClientInfo *client, uint32_t packetSize);
+
+    /**
+     * @brief Update the rate and the delay of a path from its path report.
+     * 
+     * A path whose delay grew more than 10 ms above its smallest delay is
+     * capped below the rate it delivered so its queue drains; otherwise it may
+     * carry a quarter more than it delivered.
+     * 
+     * @param subflow the path
+     * @param report the path report
+     */
+    void UpdateSubflow (Subflow &subflow, const VideoStreamPathReportHeader &report);
+
+    /**
+     * @brief Send the video frame to the given client.
+     * 
+     * @param clientKey the key of the client, see GetClientKey
+     */
+    void Send (uint64_t clientKey);
+
+    /**
+     * @brief Get the mean bitrate of a title at a video level.
+     * 
+     * @param contentId the content ID of the title
+     * @param videoLevel the video level
+     * @return the bitrate in bits per second
+     */
+    uint64_t GetSessionRate (uint32_t contentId, uint16_t videoLevel) const;
+
+    /**
+     * @brief Get the video level a new session can be admitted at.
      * 
-     * @param ipAddress ipv4 address
+     * @param client the session
+     * @return the requested level if it fits, a lower one under ADMISSION_CAP, 0 if the session does not fit
      */
-    void Send (uint32_t ipAddress);
+    uint16_t GetAdmissionLevel (const ClientInfo *client) const;
+
+    /**
+     * @brief Start the fast-start burst of a session.
+     * 
+     * @param client the session
+     */
+    void StartBurst (ClientInfo *client);
+
+    /**
+     * @brief Send the session at the requested video level, or the highest level
+     * below it allowed by the rate controller and the egress budget.
+     * 
+     * @param client the session
+     */
+    void ApplyVideoLevel (ClientInfo *client);
+
+    /**
+     * @brief Update the target rate of a session from a receiver report.
+     * 
+     * Loss above 10% cuts the target in proportion to the loss; a growing
+     * one-way delay brings it below the received rate; otherwise, with loss
+     * below 2%, it grows by 8% per report up to the rate of the requested level.
+     * 
+     * @param client the session
+     * @param report the receiver report
+     */
+    void UpdateRateControl (ClientInfo *client, const VideoStreamReportHeader &report);
+
+    /**
+     * @brief Start streaming to an admitted session.
+     * 
+     * @param client the session
+     * @param videoLevel the video level it was admitted at
+     */
+    void AdmitClient (ClientInfo *client, uint16_t videoLevel);
+
+    /**
+     * @brief End a session and admit the queued sessions that fit.
+     * 
+     * @param clientKey the key of the client, see GetClientKey
+     */
+    void RemoveClient (uint64_t clientKey);
+
+    /**
+     * @brief Tell a client its session was refused.
+     * 
+     * @param client the session
+     */
+    void SendReject (ClientInfo *client);
+
+    /**
+     * @brief Send the parameters of an admitted session to its client.
+     * 
+     * @param client the session
+     */
+    void SendHelloAck (ClientInfo *client);
+
+    /**
+     * @brief Send the load of the server to the request router, and schedule the next report.
+     */
+    void SendLoadReport (void);
+
+    /**
+     * @brief Get the time a frame is produced.
+     * 
+     * @param frame the frame number
+     * @return the production time on the live timeline, or now for on-demand streams
+     */
+    Time GetProductionTime (uint32_t frame) const;
+
+    /**
+     * @brief Read a frame file.
+     * 
+     * @param frameFile the name of the file, one frame size per line
+     * @param frameSizeList the frame sizes read from the file
+     */
+    static void LoadFrameSizes (std::string frameFile, std::vector<uint32_t> &frameSizeList);
+
+    /**
+     * @brief Compute the mean frame size of each title.
+     */
+    void UpdateMeanFrameSizes (void);
+
+    /**
+     * @brief Index the keyframes of each title with a frame file.
+     */
+    void UpdateKeyframeIndex (void);
+
+    /**
+     * @brief Get the first keyframe after a frame.
+     * 
+     * @param contentId the content ID of the title
+     * @param frame the frame number
+     * @return the next keyframe, or the number of frames of the title if there is none
+     */
+    uint32_t GetNextKeyframe (uint32_t contentId, uint32_t frame) const;
+
+    /**
+     * @brief Get the frame sizes of a title.
+     * 
+     * @param contentId the content ID of the title
+     * @return the frame sizes, empty for the built-in frame sizes
+     */
+    const std::vector<uint32_t> &GetFrameSizeList (uint32_t contentId) const;
+
+    /**
+     * @brief Get the size of a frame of a title at a video level.
+     * 
+     * A rendition with a frame file sends its frame sizes, from the first
+     * again if the title is longer. Otherwise the frame sizes of the title
+     * at level 1 are scaled by the bitrate of the level over the bitrate of
+     * level 1, and without frame file nor generator every frame has the
+     * size of one Interval at the bitrate of the level.
+     * 
+     * @param contentId the content ID of the title
+     * @param videoLevel the video level
+     * @param frame the frame number
+     * @return the frame size in bytes
+     */
+    uint32_t GetFrameSize (uint32_t contentId, uint16_t videoLevel, uint32_t frame) const;
+
+    /**
+     * @brief Get the number of frames of a title.
+     * 
+     * @param contentId the content ID of the title
+     * @return the number of frames of its frame file, or of VideoLength seconds
+     */
+    uint32_t GetTotalFrames (uint32_t contentId) const;
 
     /**
      * @brief Handle a packet reception.
@@ -106,18 +528,67 @@ class Packet;
 
     Time m_interval; //!< Packet inter-send time
     uint32_t m_maxPacketSize; //!< Maximum size of the packet to be sent
+    FragmentSizing m_fragmentSizing; //!< How the fragment size of a session is chosen
+    uint16_t m_pathMtu; //!< Configured path MTU, 0 to discover it
+    bool m_jumbo; //!< Whether the path MTU may exceed an Ethernet MTU
+    uint16_t m_frameAggregation; //!< Largest number of fragments sent as one packet
+    uint32_t m_fastStartFrames; //!< Frames of the fast-start burst of a new session
+    DataRate m_fastStartRate; //!< Largest bitrate of the fast-start burst
     Ptr<Socket> m_socket; //!< Socket
+    Address m_routerAddress; //!< Address of the request router, empty without router
+    uint16_t m_routerPort; //!< Port of the request router
+    Time m_loadReportInterval; //!< Time between two load reports to the router
+    EventId m_loadEvent; //!< Next load report
 
     uint16_t m_port; //!< The port 
     Address m_local; //!< Local multicast address
 
+    uint16_t m_initialVideoLevel; //!< Video level of a new client
     uint32_t m_frameRate; //!< Number of frames per second to be sent
     uint32_t m_videoLength; //!< Length of the video in seconds
     std::string m_frameFile; //!< Name of the file containing frame sizes
     std::vector<uint32_t> m_frameSizeList; //!< List of video frame sizes
+    std::string m_catalogFile; //!< Name of the catalog manifest or directory
+    std::vector<std::vector<uint32_t>> m_catalog; //!< Frame sizes of each title of the catalog
+    std::vector<uint32_t> m_titleRequests; //!< Number of sessions that requested each title
+    std::vector<double> m_meanFrameSizes; //!< Mean frame size of each title at video level 1
+    VideoStreamLadder m_ladder; //!< Renditions of the video levels
+    std::vector<std::vector<uint32_t>> m_renditionFrameSizes; //!< Frame sizes of each level with its own frame file
+    std::vector<double> m_renditionMeanFrameSizes; //!< Mean frame size of each level with its own frame file
+    uint32_t m_keyframeInterval; //!< Largest number of frames of a GOP without frame types
+    std::vector<std::vector<uint32_t>> m_keyframes; //!< Keyframes of each title with a frame file, in order
+    Ptr<VideoStreamFrameGenerator> m_frameGenerator; //!< Generator of the frame sizes without a frame file
     
-    std::unordered_map<uint32_t, ClientInfo*> m_clients; //!< Information saved for each client
-    const uint32_t m_frameSizes[6] = {0, 230400, 345600, 921600, 2073600, 2211840}; //!< Frame size for 360p, 480p, 720p, 1080p and 2K
+    bool m_live; //!< Whether the frames are produced on a live timeline
+    Time m_liveStart; //!< Production time of the first frame of a live stream
+
+    std::unordered_map<uint64_t, ClientInfo*> m_clients; //!< Information saved for each client
+    std::unordered_map<uint64_t, uint64_t> m_subflowSessions; //!< Key of the session of each joined subflow, by the key of its address
+    uint32_t m_joinedSubflows; //!< Number of subflows joined to the sessions
+    uint32_t m_nextSession; //!< Session index of the next client
+
+    uint32_t m_maxSessions; //!< Largest number of active sessions, 0 for no limit
+    DataRate m_egressBudget; //!< Largest bitrate reserved by the active sessions, 0 for no limit
+    AdmissionPolicy m_admissionPolicy; //!< What to do with the sessions that do not fit
+    std::deque<ClientInfo*> m_admissionQueue; //!< Sessions waiting for admission, oldest first
+    uint64_t m_reservedRate; //!< Bitrate reserved by the active sessions in bits per second
+    uint32_t m_admittedSessions; //!< Number of admitted sessions
+    uint32_t m_rejectedSessions; //!< Number of rejected sessions
+    uint32_t m_queuedSessions; //!< Number of sessions queued before admission
+    uint32_t m_cappedSessions; //!< Number of sessions admitted below their requested level
+
+    bool m_rateControl; //!< Whether the receiver reports cap the video level of the sessions
+    uint32_t m_receivedReports; //!< Number of receiver reports received
+    VideoStreamHistogram m_reportedJitter; //!< Jitter of the receiver reports
+    VideoStreamHistogram m_sendLag; //!< Send lag of the live frames
+
+    std::string m_eventLogFile; //!< Name of the binary event log, empty to disable it
+    uint32_t m_eventLogBufferSize; //!< Number of events buffered before they are written
+    VideoStreamEventLog m_eventLog; //!< Binary event log
+    /// Callbacks for tracing the packet Tx events
+    TracedCallback<Ptr<const Packet>> m_txTrace;
+    /// Callbacks for tracing the rate controller decisions
+    TracedCallback<uint32_t, DataRate, uint16_t> m_rateControlTrace;
   };
 
 } // namespace ns3
@@ -0,0 +1,1981 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/application-container.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/packet.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/video-stream-cache.h"
+#include "ns3/video-stream-event-log.h"
+#include "ns3/video-stream-fluid-model.h"
+#include "ns3/video-stream-frame-generator.h"
+#include "ns3/video-stream-helper.h"
+#include "ns3/video-stream-histogram.h"
+#include "ns3/video-stream-ladder.h"
+#include "ns3/video-stream-population-helper.h"
+#include "ns3/video-stream-proxy.h"
+#include "ns3/video-stream-router.h"
+#include "ns3/video-stream-server.h"
+#include "ns3/video-stream-client.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamTestSuite");
+
+/**
+ * @brief Base class running one server and one client over a point-to-point link.
+ */
+class VideoStreamTestCase : public TestCase
+{
+public:
+  /**
+   * @brief Construct a new VideoStreamTestCase object.
+   *
+   * @param name the name of the test case
+   */
+  VideoStreamTestCase (std::string name);
+  virtual ~VideoStreamTestCase ();
+
+protected:
+  /**
+   * @brief Write a frame file and run the scenario.
+   *
+   * @param frameSizes the size of each frame, empty to leave FrameFile unset
+   * @param dataRate the data rate of the link
+   * @param maxPacketSize the server MaxPacketSize
+   * @param level the initial video level
+   * @param adaptive whether the client adapts the video level
+   * @param duration the simulated time
+   */
+  void RunScenario (const std::vector<uint32_t> &frameSizes, std::string dataRate,
+                    uint32_t maxPacketSize, uint16_t level, bool adaptive, Time duration);
+
+  /**
+   * @brief Set an attribute of the server of the next runs, over the ones RunScenario sets.
+   *
+   * @param name the name of the attribute
+   * @param value the value of the attribute
+   */
+  void SetServerAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * @brief Set an attribute of the client of the next runs, over the ones RunScenario sets.
+   *
+   * @param name the name of the attribute
+   * @param value the value of the attribute
+   */
+  void SetClientAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * @brief Prepare a run once its applications are installed, before the simulation starts.
+   */
+  virtual void ScenarioInstalled (void);
+
+  /**
+   * @brief Count a packet sent by the server.
+   *
+   * @param packet the packet
+   */
+  void ServerTx (Ptr<const Packet> packet);
+
+  /**
+   * @brief Count a DATA packet received by the client.
+   *
+   * @param packet the packet
+   * @param from the sender address
+   */
+  void ClientRx (Ptr<const Packet> packet, const Address &from);
+
+  Time m_serverStart; //!< Start time of the server
+  Time m_clientStart; //!< Start time of the client
+  std::vector<std::pair<std::string, Ptr<AttributeValue>>> m_serverAttributes; //!< Attributes of the server
+  std::vector<std::pair<std::string, Ptr<AttributeValue>>> m_clientAttributes; //!< Attributes of the client
+  Ptr<VideoStreamServer> m_server; //!< Server of the last run
+  Ptr<VideoStreamClient> m_client; //!< Client of the last run
+  uint32_t m_txPackets; //!< Packets sent by the server
+  uint64_t m_txBytes; //!< Bytes sent by the server
+  uint32_t m_minPacketSize; //!< Smallest packet sent by the server
+  uint32_t m_maxPacketSize; //!< Largest packet sent by the server
+  uint64_t m_rxBytes; //!< Bytes received by the client
+  uint64_t m_events; //!< Events executed by the simulator
+};
+
+VideoStreamTestCase::VideoStreamTestCase (std::string name)
+  : TestCase (name),
+    m_serverStart (Seconds (0.0)),
+    m_clientStart (Seconds (0.5)),
+    m_txPackets (0),
+    m_txBytes (0),
+    m_minPacketSize (0),
+    m_maxPacketSize (0),
+    m_rxBytes (0),
+    m_events (0)
+{
+}
+
+VideoStreamTestCase::~VideoStreamTestCase ()
+{
+}
+
+void
+VideoStreamTestCase::SetServerAttribute (std::string name, const AttributeValue &value)
+{
+  m_serverAttributes.push_back (std::make_pair (name, value.Copy ()));
+}
+
+void
+VideoStreamTestCase::SetClientAttribute (std::string name, const AttributeValue &value)
+{
+  m_clientAttributes.push_back (std::make_pair (name, value.Copy ()));
+}
+
+void
+VideoStreamTestCase::ScenarioInstalled (void)
+{
+}
+
+void
+VideoStreamTestCase::ServerTx (Ptr<const Packet> packet)
+{
+  uint32_t size = packet->GetSize ();
+  m_minPacketSize = m_txPackets == 0 ? size : std::min (m_minPacketSize, size);
+  m_maxPacketSize = std::max (m_maxPacketSize, size);
+  m_txPackets++;
+  m_txBytes += size;
+}
+
+void
+VideoStreamTestCase::ClientRx (Ptr<const Packet> packet, const Address &from)
+{
+  // the server traces the frames only, not the acknowledgement of the session
+  VideoStreamHeader header;
+  packet->PeekHeader (header);
+  if (header.GetMessageType () != VideoStreamHeader::DATA)
+  {
+    return;
+  }
+  m_rxBytes += packet->GetSize ();
+}
+
+void
+VideoStreamTestCase::RunScenario (const std::vector<uint32_t> &frameSizes, std::string dataRate,
+                                  uint32_t maxPacketSize, uint16_t level, bool adaptive, Time duration)
+{
+  m_txPackets = 0;
+  m_txBytes = 0;
+  m_minPacketSize = 0;
+  m_maxPacketSize = 0;
+  m_rxBytes = 0;
+
+  // without frame sizes the server uses its FrameGenerator
+  std::string frameFile;
+  if (!frameSizes.empty ())
+  {
+    frameFile = CreateTempDirFilename ("frames.txt");
+    std::ofstream frameStream (frameFile);
+    for (uint32_t size : frameSizes)
+    {
+      frameStream << size << "\n";
+    }
+    frameStream.close ();
+  }
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue (dataRate));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 6969;
+  VideoStreamServerHelper videoServer (port);
+  videoServer.SetAttribute ("MaxPacketSize", UintegerValue (maxPacketSize));
+  videoServer.SetAttribute ("FrameFile", StringValue (frameFile));
+  videoServer.SetAttribute ("InitialVideoLevel", UintegerValue (level));
+  for (const auto &attribute : m_serverAttributes)
+  {
+    videoServer.SetAttribute (attribute.first, *attribute.second);
+  }
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (0));
+  serverApp.Start (m_serverStart);
+  serverApp.Stop (duration);
+  serverApp.Get (0)->TraceConnectWithoutContext ("Tx", MakeCallback (&VideoStreamTestCase::ServerTx, this));
+  m_server = DynamicCast<VideoStreamServer> (serverApp.Get (0));
+
+  VideoStreamClientHelper videoClient (interfaces.GetAddress (0), port);
+  videoClient.SetAttribute ("InitialVideoLevel", UintegerValue (level));
+  videoClient.SetAttribute ("Adaptive", BooleanValue (adaptive));
+  for (const auto &attribute : m_clientAttributes)
+  {
+    videoClient.SetAttribute (attribute.first, *attribute.second);
+  }
+  ApplicationContainer clientApp = videoClient.Install (nodes.Get (1));
+  clientApp.Start (m_clientStart);
+  clientApp.Stop (duration);
+  clientApp.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&VideoStreamTestCase::ClientRx, this));
+  m_client = DynamicCast<VideoStreamClient> (clientApp.Get (0));
+  ScenarioInstalled ();
+
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  m_events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Check that every frame and every byte of the trace reaches the client.
+ */
+class VideoStreamDeliveryTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamDeliveryTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamDeliveryTestCase::VideoStreamDeliveryTestCase ()
+  : VideoStreamTestCase ("Check that the client receives every frame and byte")
+{
+}
+
+void
+VideoStreamDeliveryTestCase::DoRun (void)
+{
+  std::vector<uint32_t> frameSizes (50, 5000);
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), 50, "Not every frame was received");
+  NS_TEST_ASSERT_MSG_EQ (m_txBytes, 50 * 5000, "The server did not send the frame bytes");
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, m_txBytes, "The client did not receive every byte");
+}
+
+/**
+ * @brief Check the number and size of the fragments of each frame.
+ */
+class VideoStreamFragmentationTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamFragmentationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamFragmentationTestCase::VideoStreamFragmentationTestCase ()
+  : VideoStreamTestCase ("Check the fragmentation of the frames")
+{
+}
+
+void
+VideoStreamFragmentationTestCase::DoRun (void)
+{
+  // exact multiple, one byte over, tiny remainder and single-packet frames
+  std::vector<uint32_t> frameSizes = {1400, 2800, 1401, 1405, 3000, 100};
+  uint32_t maxPacketSize = 1400;
+  RunScenario (frameSizes, "100Mbps", maxPacketSize, 1, false, Seconds (3.0));
+
+  uint32_t expectedPackets = 0;
+  uint64_t expectedBytes = 0;
+  for (uint32_t size : frameSizes)
+  {
+    expectedPackets += (size + maxPacketSize - 1) / maxPacketSize;
+    expectedBytes += size;
+  }
+  NS_TEST_ASSERT_MSG_EQ (m_txPackets, expectedPackets, "Unexpected number of fragments");
+  NS_TEST_ASSERT_MSG_EQ (m_txBytes, expectedBytes, "Fragments do not add up to the frame sizes");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxPacketSize, maxPacketSize, "A fragment exceeds MaxPacketSize");
+  NS_TEST_ASSERT_MSG_GT (m_minPacketSize, 0, "An empty fragment was sent");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), frameSizes.size (), "Fragments were counted as frames");
+}
+
+/**
+ * @brief Check that the client raises the level on a fast link and lowers it on a slow one.
+ */
+class VideoStreamLevelSwitchTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamLevelSwitchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamLevelSwitchTestCase::VideoStreamLevelSwitchTestCase ()
+  : VideoStreamTestCase ("Check the video level switching")
+{
+}
+
+void
+VideoStreamLevelSwitchTestCase::DoRun (void)
+{
+  std::vector<uint32_t> frameSizes (500, 2000);
+  RunScenario (frameSizes, "100Mbps", 1400, 3, true, Seconds (6.0));
+  NS_TEST_ASSERT_MSG_GT (m_client->GetVideoLevel (), 3, "The level was not raised on a fast link");
+
+  frameSizes.assign (500, 20000);
+  RunScenario (frameSizes, "2Mbps", 1400, 3, true, Seconds (10.0));
+  NS_TEST_ASSERT_MSG_LT (m_client->GetVideoLevel (), 3, "The level was not lowered on a slow link");
+}
+
+/**
+ * @brief Check that stalls are counted only when the buffer runs dry.
+ */
+class VideoStreamStallTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamStallTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamStallTestCase::VideoStreamStallTestCase ()
+  : VideoStreamTestCase ("Check the stall accounting")
+{
+}
+
+void
+VideoStreamStallTestCase::DoRun (void)
+{
+  std::vector<uint32_t> frameSizes (200, 2000);
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (6.0));
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetStallCount (), 0, "Stall counted on a fast link");
+
+  frameSizes.assign (200, 20000);
+  RunScenario (frameSizes, "1Mbps", 1400, 1, false, Seconds (8.0));
+  NS_TEST_ASSERT_MSG_GT (m_client->GetStallCount (), 0, "No stall counted on a slow link");
+}
+
+/**
+ * @brief Check upper bounds on the packets and events per simulated second.
+ *
+ * Every fragment costs about two events on a point-to-point link (transmit
+ * complete and receive), plus one send event per frame, so a change in the
+ * send or receive path that adds packets or events fails this test.
+ */
+class VideoStreamBudgetTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamBudgetTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamBudgetTestCase::VideoStreamBudgetTestCase ()
+  : VideoStreamTestCase ("Check the event and packet budgets")
+{
+}
+
+void
+VideoStreamBudgetTestCase::DoRun (void)
+{
+  uint32_t frames = 250;
+  uint32_t frameSize = 7000;
+  uint32_t maxPacketSize = 1400;
+  double duration = 10.0;
+  std::vector<uint32_t> frameSizes (frames, frameSize);
+  RunScenario (frameSizes, "100Mbps", maxPacketSize, 1, false, Seconds (duration));
+
+  uint32_t packetsPerFrame = (frameSize + maxPacketSize - 1) / maxPacketSize;
+  double packetBudget = frames * packetsPerFrame / duration;
+  double eventBudget = (4.0 * frames * packetsPerFrame + frames + 100) / duration;
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_txPackets / duration, packetBudget, "Packets per simulated second over budget");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_events / duration, eventBudget, "Events per simulated second over budget");
+}
+
+/**
+ * @brief Check that the binary event log records every frame and decodes back.
+ */
+class VideoStreamEventLogTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamEventLogTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamEventLogTestCase::VideoStreamEventLogTestCase ()
+  : VideoStreamTestCase ("Check the binary event log")
+{
+}
+
+void
+VideoStreamEventLogTestCase::DoRun (void)
+{
+  std::string logFile = CreateTempDirFilename ("events.bin");
+  Config::SetDefault ("ns3::VideoStreamServer::EventLogFile", StringValue (logFile));
+  Config::SetDefault ("ns3::VideoStreamClient::EventLogFile", StringValue (logFile));
+  // a small buffer forces several batches per application
+  Config::SetDefault ("ns3::VideoStreamServer::EventLogBufferSize", UintegerValue (16));
+  Config::SetDefault ("ns3::VideoStreamClient::EventLogBufferSize", UintegerValue (16));
+
+  std::vector<uint32_t> frameSizes (50, 5000);
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+
+  Config::SetDefault ("ns3::VideoStreamServer::EventLogFile", StringValue (""));
+  Config::SetDefault ("ns3::VideoStreamClient::EventLogFile", StringValue (""));
+  Config::SetDefault ("ns3::VideoStreamServer::EventLogBufferSize", UintegerValue (1024));
+  Config::SetDefault ("ns3::VideoStreamClient::EventLogBufferSize", UintegerValue (1024));
+
+  std::ifstream in (logFile, std::ios::binary);
+  std::ostringstream csv;
+  NS_TEST_ASSERT_MSG_EQ (VideoStreamEventLog::Decode (in, csv, true), true, "The event log could not be decoded");
+
+  std::istringstream lines (csv.str ());
+  std::string line;
+  uint32_t sent = 0;
+  uint32_t received = 0;
+  uint32_t hellos = 0;
+  while (std::getline (lines, line))
+  {
+    sent += line.find (",SERVER_FRAME_SENT,") != std::string::npos;
+    received += line.find (",CLIENT_FRAME_RECEIVED,") != std::string::npos;
+    hellos += line.find (",CLIENT_HELLO_SENT,") != std::string::npos;
+  }
+  NS_TEST_ASSERT_MSG_EQ (sent, 50, "Not every sent frame was recorded");
+  // a frame is complete when the next one starts, so the last one is never recorded
+  NS_TEST_ASSERT_MSG_EQ (received, 49, "Not every received frame was recorded");
+  NS_TEST_ASSERT_MSG_EQ (hellos, 1, "The hello was not recorded");
+}
+
+/**
+ * @brief Check that several clients on one node are served as separate sessions.
+ */
+class VideoStreamPopulationTestCase : public TestCase
+{
+public:
+  VideoStreamPopulationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamPopulationTestCase::VideoStreamPopulationTestCase ()
+  : TestCase ("Check a population of clients sharing a node")
+{
+}
+
+void
+VideoStreamPopulationTestCase::DoRun (void)
+{
+  std::string frameFile = CreateTempDirFilename ("frames.txt");
+  std::ofstream frameStream (frameFile);
+  for (uint32_t i = 0; i < 100; i++)
+  {
+    frameStream << 2000 << "\n";
+  }
+  frameStream.close ();
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 6969;
+  VideoStreamServerHelper videoServer (port);
+  videoServer.SetAttribute ("FrameFile", StringValue (frameFile));
+  videoServer.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (0));
+  serverApp.Start (Seconds (0.0));
+  serverApp.Stop (Seconds (5.0));
+
+  // five clients on the same node, arriving 200 ms apart; the last one arrives too late
+  VideoStreamPopulationHelper population (interfaces.GetAddress (0), port);
+  population.SetClientAttribute ("InitialVideoLevel", UintegerValue (1));
+  population.SetClientAttribute ("Adaptive", BooleanValue (false));
+  population.SetStaggeredArrivals (MilliSeconds (200));
+  ApplicationContainer clientApps = population.Install (NodeContainer (nodes.Get (1)), 6, Seconds (0.5), Seconds (1.5));
+  NS_TEST_ASSERT_MSG_EQ (clientApps.GetN (), 5, "Clients arriving after the end were installed");
+
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+
+  for (uint32_t i = 0; i < clientApps.GetN (); i++)
+  {
+    Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (clientApps.Get (i));
+    NS_TEST_ASSERT_MSG_GT (client->GetReceivedFrames (), 0, "Client " << i << " was not served");
+  }
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Check that each client receives the title it requested from the catalog.
+ */
+class VideoStreamCatalogTestCase : public TestCase
+{
+public:
+  VideoStreamCatalogTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamCatalogTestCase::VideoStreamCatalogTestCase ()
+  : TestCase ("Check the title catalog")
+{
+}
+
+void
+VideoStreamCatalogTestCase::DoRun (void)
+{
+  // titles of 10, 30 and 60 frames, listed with paths relative to the manifest
+  std::vector<uint32_t> titleFrames = {10, 30, 60};
+  std::string manifest = CreateTempDirFilename ("catalog.txt");
+  std::ofstream manifestStream (manifest);
+  for (uint32_t title = 0; title < titleFrames.size (); title++)
+  {
+    std::string name = "title-" + std::to_string (title) + ".txt";
+    std::ofstream frameStream (CreateTempDirFilename (name));
+    for (uint32_t i = 0; i < titleFrames[title]; i++)
+    {
+      frameStream << 2000 << "\n";
+    }
+    manifestStream << name << "\n";
+  }
+  manifestStream.close ();
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 6969;
+  VideoStreamServerHelper videoServer (port);
+  videoServer.SetAttribute ("Catalog", StringValue (manifest));
+  videoServer.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (0));
+  serverApp.Start (Seconds (0.0));
+  serverApp.Stop (Seconds (3.0));
+  Ptr<VideoStreamServer> server = DynamicCast<VideoStreamServer> (serverApp.Get (0));
+  NS_TEST_ASSERT_MSG_EQ (server->GetTitleCount (), 3, "The catalog was not loaded");
+
+  ApplicationContainer clientApps;
+  for (uint32_t contentId = 1; contentId < 4; contentId++)
+  {
+    VideoStreamClientHelper videoClient (interfaces.GetAddress (0), port);
+    videoClient.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+    videoClient.SetAttribute ("Adaptive", BooleanValue (false));
+    videoClient.SetAttribute ("ContentId", UintegerValue (contentId));
+    clientApps.Add (videoClient.Install (nodes.Get (1)));
+  }
+  clientApps.Start (Seconds (0.5));
+  clientApps.Stop (Seconds (3.0));
+
+  Simulator::Stop (Seconds (3.0));
+  Simulator::Run ();
+
+  Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (clientApps.Get (0));
+  NS_TEST_ASSERT_MSG_EQ (client->GetReceivedFrames (), titleFrames[1], "Title 1 was not streamed");
+  client = DynamicCast<VideoStreamClient> (clientApps.Get (1));
+  NS_TEST_ASSERT_MSG_EQ (client->GetReceivedFrames (), titleFrames[2], "Title 2 was not streamed");
+  client = DynamicCast<VideoStreamClient> (clientApps.Get (2));
+  NS_TEST_ASSERT_MSG_EQ (client->GetReceivedFrames (), 0, "A title missing from the catalog was streamed");
+  NS_TEST_ASSERT_MSG_EQ (server->GetRequestCount (0), 0, "Unexpected request for title 0");
+  NS_TEST_ASSERT_MSG_EQ (server->GetRequestCount (1), 1, "Missing request for title 1");
+  NS_TEST_ASSERT_MSG_EQ (server->GetRequestCount (2), 1, "Missing request for title 2");
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Check that the Zipf popularity model favours the first titles.
+ */
+class VideoStreamPopularityTestCase : public TestCase
+{
+public:
+  VideoStreamPopularityTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamPopularityTestCase::VideoStreamPopularityTestCase ()
+  : TestCase ("Check the Zipf title popularity")
+{
+}
+
+void
+VideoStreamPopularityTestCase::DoRun (void)
+{
+  uint32_t titles = 10;
+  NodeContainer nodes;
+  nodes.Create (1);
+
+  VideoStreamClientHelper videoClient (Ipv4Address ("10.1.1.1"), 6969);
+  videoClient.SetContentPopularity (titles, 1.0);
+  videoClient.AssignStreams (1);
+  std::vector<uint32_t> requests (titles, 0);
+  for (uint32_t i = 0; i < 1000; i++)
+  {
+    ApplicationContainer app = videoClient.Install (nodes.Get (0));
+    uint32_t contentId = DynamicCast<VideoStreamClient> (app.Get (0))->GetContentId ();
+    NS_TEST_ASSERT_MSG_LT (contentId, titles, "Content ID outside the catalog");
+    requests[contentId]++;
+  }
+  // with an exponent of 1, title 0 is requested about ten times as often as title 9
+  NS_TEST_ASSERT_MSG_GT (requests[0], 3 * requests[titles - 1], "Title 0 is not the most popular");
+  NS_TEST_ASSERT_MSG_GT (requests[1], requests[titles - 1], "Popularity does not decrease with the rank");
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Check the eviction order of the cache replacement policies.
+ */
+class VideoStreamCacheTestCase : public TestCase
+{
+public:
+  VideoStreamCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamCacheTestCase::VideoStreamCacheTestCase ()
+  : TestCase ("Check the frame cache replacement policies")
+{
+}
+
+void
+VideoStreamCacheTestCase::DoRun (void)
+{
+  // room for three frames of 1000 bytes
+  uint32_t size = 0;
+  VideoStreamCache cache (3000, VideoStreamCache::LRU);
+  cache.Insert (1, 1000);
+  cache.Insert (2, 1000);
+  cache.Insert (3, 1000);
+  NS_TEST_ASSERT_MSG_EQ (cache.Lookup (1, size), true, "LRU lost a frame within the budget");
+  NS_TEST_ASSERT_MSG_EQ (size, 1000, "Wrong cached frame size");
+  cache.Insert (4, 1000);
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (2, size), false, "LRU kept the least recently used frame");
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (1, size), true, "LRU evicted a recently used frame");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetUsedBytes (), 3000, "LRU exceeds its budget");
+  NS_TEST_ASSERT_MSG_EQ (cache.Lookup (2, size), false, "An evicted frame was found");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetHits (), 1, "Wrong hit count");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetMisses (), 1, "Wrong miss count");
+
+  cache.Reset (3000, VideoStreamCache::LFU);
+  cache.Insert (1, 1000);
+  cache.Insert (2, 1000);
+  cache.Insert (3, 1000);
+  cache.Lookup (1, size);
+  cache.Lookup (1, size);
+  cache.Lookup (3, size);
+  cache.Insert (4, 1000);
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (2, size), false, "LFU kept the least frequently used frame");
+  cache.Insert (5, 1000);
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (4, size), false, "LFU kept the least frequently used frame");
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (1, size) && cache.Peek (3, size), true, "LFU evicted a frequently used frame");
+
+  // a frame evicted from the recent list and requested again grows that list
+  cache.Reset (3000, VideoStreamCache::ARC);
+  cache.Insert (1, 1000);
+  cache.Insert (2, 1000);
+  cache.Insert (3, 1000);
+  cache.Lookup (1, size);
+  cache.Insert (4, 1000);
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (2, size), false, "ARC kept the oldest frame seen once");
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (1, size), true, "ARC evicted a frame seen twice");
+  cache.Insert (2, 1000);
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (2, size), true, "ARC did not readmit a ghost frame");
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (3, size), false, "ARC kept the oldest frame seen once");
+  NS_TEST_ASSERT_MSG_EQ (cache.Peek (4, size), true, "ARC evicted beyond its budget");
+  NS_TEST_ASSERT_MSG_EQ (cache.GetUsedBytes (), 3000, "ARC exceeds its budget");
+}
+
+/**
+ * @brief Check that a proxy serves the clients of a title with a single origin session.
+ */
+class VideoStreamProxyTestCase : public TestCase
+{
+public:
+  VideoStreamProxyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamProxyTestCase::VideoStreamProxyTestCase ()
+  : TestCase ("Check the edge caching proxy")
+{
+}
+
+void
+VideoStreamProxyTestCase::DoRun (void)
+{
+  uint32_t frames = 30;
+  std::string manifest = CreateTempDirFilename ("proxy-catalog.txt");
+  std::ofstream manifestStream (manifest);
+  std::ofstream frameStream (CreateTempDirFilename ("proxy-title.txt"));
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    frameStream << 3000 << "\n";
+  }
+  frameStream.close ();
+  manifestStream << "proxy-title.txt\n";
+  manifestStream.close ();
+
+  // origin - proxy - clients
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer originDevices = pointToPoint.Install (nodes.Get (0), nodes.Get (1));
+  NetDeviceContainer clientDevices = pointToPoint.Install (nodes.Get (1), nodes.Get (2));
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer originInterfaces = address.Assign (originDevices);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer clientInterfaces = address.Assign (clientDevices);
+
+  uint16_t port = 6969;
+  VideoStreamServerHelper videoServer (port);
+  videoServer.SetAttribute ("Catalog", StringValue (manifest));
+  videoServer.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (0));
+  serverApp.Start (Seconds (0.0));
+  serverApp.Stop (Seconds (5.0));
+
+  VideoStreamProxyHelper videoProxy (originInterfaces.GetAddress (0), port, port);
+  ApplicationContainer proxyApp = videoProxy.Install (nodes.Get (1));
+  proxyApp.Start (Seconds (0.0));
+  proxyApp.Stop (Seconds (5.0));
+
+  // three clients of the same title, joining after the previous one finished
+  ApplicationContainer clientApps;
+  for (uint32_t i = 0; i < 3; i++)
+  {
+    VideoStreamClientHelper videoClient (clientInterfaces.GetAddress (0), port);
+    videoClient.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+    videoClient.SetAttribute ("Adaptive", BooleanValue (false));
+    ApplicationContainer clientApp = videoClient.Install (nodes.Get (2));
+    clientApp.Start (Seconds (0.5 + i));
+    clientApp.Stop (Seconds (5.0));
+    clientApps.Add (clientApp);
+  }
+
+  Simulator::Stop (Seconds (5.0));
+  Simulator::Run ();
+
+  Ptr<VideoStreamServer> server = DynamicCast<VideoStreamServer> (serverApp.Get (0));
+  for (uint32_t i = 0; i < clientApps.GetN (); i++)
+  {
+    Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (clientApps.Get (i));
+    NS_TEST_ASSERT_MSG_EQ (client->GetReceivedFrames (), frames, "A client did not receive the title");
+    NS_TEST_ASSERT_MSG_EQ (client->GetLadder ().GetLevelCount (), server->GetLevelCount (), "The proxy did not relay the ladder of the origin");
+  }
+  NS_TEST_ASSERT_MSG_EQ (server->GetRequestCount (0), 1, "The origin streamed the title more than once");
+  Ptr<VideoStreamProxy> proxy = DynamicCast<VideoStreamProxy> (proxyApp.Get (0));
+  NS_TEST_ASSERT_MSG_GT (proxy->GetHitRatio (), 0.66, "The later clients were not served from the cache");
+  NS_TEST_ASSERT_MSG_EQ_TOL (proxy->GetOriginOffload (), 2.0 / 3, 0.01, "Wrong origin offload");
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Check that live clients join at the live edge and skip late frames.
+ */
+class VideoStreamLiveTestCase : public TestCase
+{
+public:
+  VideoStreamLiveTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamLiveTestCase::VideoStreamLiveTestCase ()
+  : TestCase ("Check the live streaming mode")
+{
+}
+
+void
+VideoStreamLiveTestCase::DoRun (void)
+{
+  // four seconds of live frames, one every 10 ms
+  uint32_t frames = 400;
+  std::string frameFile = CreateTempDirFilename ("live-frames.txt");
+  std::ofstream frameStream (frameFile);
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    frameStream << 2000 << "\n";
+  }
+  frameStream.close ();
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 6969;
+  VideoStreamServerHelper videoServer (port);
+  videoServer.SetAttribute ("FrameFile", StringValue (frameFile));
+  videoServer.SetAttribute ("Live", BooleanValue (true));
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (0));
+  serverApp.Start (Seconds (0.0));
+  serverApp.Stop (Seconds (6.0));
+
+  // both clients join a second into the stream; the second one targets a latency below the link delay
+  ApplicationContainer clientApps;
+  std::vector<Time> targets = {MilliSeconds (500), MilliSeconds (1)};
+  for (Time target : targets)
+  {
+    VideoStreamClientHelper videoClient (interfaces.GetAddress (0), port);
+    videoClient.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+    videoClient.SetAttribute ("Adaptive", BooleanValue (false));
+    videoClient.SetAttribute ("TargetLatency", TimeValue (target));
+    clientApps.Add (videoClient.Install (nodes.Get (1)));
+  }
+  clientApps.Start (Seconds (1.0));
+  clientApps.Stop (Seconds (6.0));
+
+  Simulator::Stop (Seconds (6.0));
+  Simulator::Run ();
+
+  Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (clientApps.Get (0));
+  NS_TEST_ASSERT_MSG_GT (client->GetReceivedFrames (), 290, "The live client missed frames");
+  NS_TEST_ASSERT_MSG_LT (client->GetReceivedFrames (), 305, "The live client did not join at the live edge");
+  NS_TEST_ASSERT_MSG_EQ (client->GetLateFrames (), 0, "Frames were late on an idle link");
+  NS_TEST_ASSERT_MSG_EQ (client->GetSkippedFrames (), 0, "Frames were skipped on an idle link");
+  NS_TEST_ASSERT_MSG_GT (client->GetMeanLatencyToLive (), MilliSeconds (2), "Latency to live below the link delay");
+  NS_TEST_ASSERT_MSG_LT (client->GetMeanLatencyToLive (), MilliSeconds (20), "Latency to live far above the transit time");
+
+  client = DynamicCast<VideoStreamClient> (clientApps.Get (1));
+  NS_TEST_ASSERT_MSG_GT (client->GetReceivedFrames (), 0, "The live client received nothing");
+  NS_TEST_ASSERT_MSG_EQ (client->GetLateFrames (), client->GetReceivedFrames (), "A frame was played above the target latency");
+  NS_TEST_ASSERT_MSG_EQ (client->GetMeanLatencyToLive (), Seconds (0.0), "A late frame was played");
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Check the reject, queue and cap admission policies of the server.
+ */
+class VideoStreamAdmissionTestCase : public TestCase
+{
+public:
+  VideoStreamAdmissionTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * @brief Run one client per requested level against a server with admission control.
+   *
+   * @param policy the AdmissionPolicy of the server
+   * @param maxSessions the MaxSessions of the server
+   * @param budget the EgressBudget of the server
+   * @param levels the initial video level of each client
+   */
+  void RunScenario (std::string policy, uint32_t maxSessions, std::string budget, const std::vector<uint16_t> &levels);
+
+  std::string m_frameFile; //!< Frame file of the title
+  Ptr<VideoStreamServer> m_server; //!< Server of the last scenario
+  ApplicationContainer m_clientApps; //!< Clients of the last scenario
+};
+
+VideoStreamAdmissionTestCase::VideoStreamAdmissionTestCase ()
+  : TestCase ("Check the server admission control")
+{
+}
+
+void
+VideoStreamAdmissionTestCase::RunScenario (std::string policy, uint32_t maxSessions, std::string budget, const std::vector<uint16_t> &levels)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 6969;
+  VideoStreamServerHelper videoServer (port);
+  videoServer.SetAttribute ("FrameFile", StringValue (m_frameFile));
+  videoServer.SetAttribute ("AdmissionPolicy", StringValue (policy));
+  videoServer.SetAttribute ("MaxSessions", UintegerValue (maxSessions));
+  videoServer.SetAttribute ("EgressBudget", StringValue (budget));
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (0));
+  serverApp.Start (Seconds (0.0));
+  serverApp.Stop (Seconds (3.0));
+  m_server = DynamicCast<VideoStreamServer> (serverApp.Get (0));
+
+  m_clientApps = ApplicationContainer ();
+  for (uint16_t level : levels)
+  {
+    VideoStreamClientHelper videoClient (interfaces.GetAddress (0), port);
+    videoClient.SetAttribute ("InitialVideoLevel", UintegerValue (level));
+    videoClient.SetAttribute ("Adaptive", BooleanValue (false));
+    m_clientApps.Add (videoClient.Install (nodes.Get (1)));
+  }
+  m_clientApps.Start (Seconds (0.5));
+  m_clientApps.Stop (Seconds (3.0));
+
+  Simulator::Stop (Seconds (3.0));
+  Simulator::Run ();
+}
+
+void
+VideoStreamAdmissionTestCase::DoRun (void)
+{
+  // half a second of 1000-byte frames, 800 kbps per session at level 1
+  uint32_t frames = 50;
+  m_frameFile = CreateTempDirFilename ("admission-frames.txt");
+  std::ofstream frameStream (m_frameFile);
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    frameStream << 1000 << "\n";
+  }
+  frameStream.close ();
+
+  RunScenario ("Reject", 2, "0bps", {1, 1, 1});
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetAdmittedSessions (), 2, "MaxSessions was not enforced");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetRejectedSessions (), 1, "The extra session was not rejected");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetActiveSessions (), 0, "Finished sessions were not removed");
+  uint32_t rejected = 0;
+  for (uint32_t i = 0; i < m_clientApps.GetN (); i++)
+  {
+    Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (m_clientApps.Get (i));
+    rejected += client->IsRejected () ? 1 : 0;
+    NS_TEST_ASSERT_MSG_EQ (client->GetReceivedFrames (), client->IsRejected () ? 0 : frames, "Wrong frames for an admitted or rejected client");
+  }
+  NS_TEST_ASSERT_MSG_EQ (rejected, 1, "The rejected client was not told");
+  Simulator::Destroy ();
+
+  // the second session waits for the first one to end
+  RunScenario ("Queue", 1, "0bps", {1, 1});
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetQueuedSessions (), 1, "The extra session was not queued");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetAdmittedSessions (), 2, "The queued session was not admitted");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetQueueLength (), 0, "A session is still queued");
+  for (uint32_t i = 0; i < m_clientApps.GetN (); i++)
+  {
+    Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (m_clientApps.Get (i));
+    NS_TEST_ASSERT_MSG_EQ (client->GetReceivedFrames (), frames, "A queued client was not served");
+  }
+  Simulator::Destroy ();
+
+  // level 3 needs 2.4 Mbps, so it is capped to level 2 and leaves too little for another session
+  RunScenario ("Cap", 0, "2Mbps", {3, 1});
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetCappedSessions (), 1, "The session was not capped");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetAdmittedSessions (), 1, "A session beyond the budget was admitted");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetRejectedSessions (), 1, "The session beyond the budget was not rejected");
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Check that receiver reports make the server back off on a congested link.
+ */
+class VideoStreamRateControlTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamRateControlTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamRateControlTestCase::VideoStreamRateControlTestCase ()
+  : VideoStreamTestCase ("Check the receiver reports and the server rate control")
+{
+}
+
+void
+VideoStreamRateControlTestCase::DoRun (void)
+{
+  // 12 Mbps at level 3 through a 5 Mbps link, with a client that never lowers its level
+  std::vector<uint32_t> frameSizes (500, 5000);
+  RunScenario (frameSizes, "5Mbps", 1400, 3, false, Seconds (6.0));
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedVideoLevel (), 3, "The level changed without receiver reports");
+  uint64_t uncontrolledBytes = m_rxBytes;
+
+  Config::SetDefault ("ns3::VideoStreamClient::ReportInterval", TimeValue (MilliSeconds (100)));
+  RunScenario (frameSizes, "5Mbps", 1400, 3, false, Seconds (6.0));
+  Config::SetDefault ("ns3::VideoStreamClient::ReportInterval", TimeValue (Seconds (0.0)));
+  NS_TEST_ASSERT_MSG_LT (m_client->GetReceivedVideoLevel (), 3, "The server did not lower the level of a congested session");
+  NS_TEST_ASSERT_MSG_GT (m_rxBytes, uncontrolledBytes / 2, "The rate control starved the session");
+}
+
+/**
+ * @brief Check the loss, reordering and one-way delay accounting of the client.
+ */
+class VideoStreamDeliveryStatsTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamDeliveryStatsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamDeliveryStatsTestCase::VideoStreamDeliveryStatsTestCase ()
+  : VideoStreamTestCase ("Check the loss, reordering and one-way delay of a session")
+{
+}
+
+void
+VideoStreamDeliveryStatsTestCase::DoRun (void)
+{
+  // an idle link neither loses nor reorders, and delays by its 2 ms plus serialization
+  std::vector<uint32_t> frameSizes (50, 5000);
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetPacketWindowSize (), 32, "Unexpected default window");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetLostPackets (), 0, "Packets were lost on an idle link");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetLossRate (), 0.0, "Packets were lost on an idle link");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReorderedPackets (), 0, "Packets were reordered on a single link");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetMaxReorderDepth (), 0, "Packets were reordered on a single link");
+  NS_TEST_ASSERT_MSG_GT (m_client->GetMeanOneWayDelay (), MilliSeconds (2), "The delay is below the propagation delay");
+  NS_TEST_ASSERT_MSG_LT (m_client->GetMeanOneWayDelay (), MilliSeconds (3), "The delay of an idle link is too large");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_client->GetOneWayDelay (), MilliSeconds (2), "The last delay is below the propagation delay");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetFrameLatencyHistogram ().GetCount (), 50, "Not every frame latency was recorded");
+  NS_TEST_ASSERT_MSG_LT (m_client->GetFrameLatencyHistogram ().GetPercentile (99), MilliSeconds (3), "The frame latency of an idle link is too large");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetFragmentGapHistogram ().GetCount (), 50 * 3, "Not every fragment gap was recorded");
+}
+
+/**
+ * @brief Check the percentiles, merging and saving of the histograms.
+ */
+class VideoStreamHistogramTestCase : public TestCase
+{
+public:
+  VideoStreamHistogramTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamHistogramTestCase::VideoStreamHistogramTestCase ()
+  : TestCase ("Check the latency histograms")
+{
+}
+
+void
+VideoStreamHistogramTestCase::DoRun (void)
+{
+  // 1 to 1000 us, half in each of two histograms
+  VideoStreamHistogram low;
+  VideoStreamHistogram high;
+  for (int64_t i = 1; i <= 1000; i++)
+  {
+    (i <= 500 ? low : high).Record (MicroSeconds (i));
+  }
+  VideoStreamHistogram merged;
+  merged.Merge (low);
+  merged.Merge (high);
+  NS_TEST_ASSERT_MSG_EQ (merged.GetCount (), 1000, "Merging lost values");
+  NS_TEST_ASSERT_MSG_EQ (merged.GetMin (), MicroSeconds (1), "Wrong minimum");
+  NS_TEST_ASSERT_MSG_EQ (merged.GetMax (), MicroSeconds (1000), "Wrong maximum");
+  NS_TEST_ASSERT_MSG_EQ (merged.GetMean (), NanoSeconds (500500), "Wrong mean");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.GetPercentile (50), MicroSeconds (500), MicroSeconds (16), "p50 beyond the bucket precision");
+  NS_TEST_ASSERT_MSG_EQ_TOL (merged.GetPercentile (99), MicroSeconds (990), MicroSeconds (31), "p99 beyond the bucket precision");
+  NS_TEST_ASSERT_MSG_EQ (merged.GetPercentile (100), MicroSeconds (1000), "p100 is not the maximum");
+
+  // a saved histogram merges like the original
+  std::stringstream saved;
+  high.Save (saved);
+  VideoStreamHistogram loaded;
+  NS_TEST_ASSERT_MSG_EQ (loaded.Load (saved), true, "A saved histogram was not loaded");
+  loaded.Merge (low);
+  NS_TEST_ASSERT_MSG_EQ (loaded.GetCount (), merged.GetCount (), "Loading lost values");
+  NS_TEST_ASSERT_MSG_EQ (loaded.GetPercentile (90), merged.GetPercentile (90), "Loading changed the buckets");
+  NS_TEST_ASSERT_MSG_EQ (loaded.GetMean (), merged.GetMean (), "Loading changed the mean");
+  std::stringstream garbage ("not a histogram");
+  NS_TEST_ASSERT_MSG_EQ (loaded.Load (garbage), false, "Loaded a stream that is not a histogram");
+  NS_TEST_ASSERT_MSG_EQ (loaded.GetCount (), 0, "A failed load left values");
+}
+
+/**
+ * @brief Check the frame types and sizes of the synthetic frame generator and
+ * a server streaming them.
+ */
+class VideoStreamFrameGeneratorTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamFrameGeneratorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamFrameGeneratorTestCase::VideoStreamFrameGeneratorTestCase ()
+  : VideoStreamTestCase ("Check the synthetic frame generator")
+{
+}
+
+void
+VideoStreamFrameGeneratorTestCase::DoRun (void)
+{
+  // without scene changes the GOP is I B B P B B P ...
+  Ptr<VideoStreamFrameGenerator> generator = CreateObject<VideoStreamFrameGenerator> ();
+  generator->SetAttribute ("SceneChangeProbability", DoubleValue (0.0));
+  NS_TEST_ASSERT_MSG_EQ (generator->GetFrameType (0, 0), VideoStreamFrameGenerator::I_FRAME, "A title does not start with an I frame");
+  NS_TEST_ASSERT_MSG_EQ (generator->GetFrameType (0, 1), VideoStreamFrameGenerator::B_FRAME, "Wrong GOP structure");
+  NS_TEST_ASSERT_MSG_EQ (generator->GetFrameType (0, 3), VideoStreamFrameGenerator::P_FRAME, "Wrong GOP structure");
+  NS_TEST_ASSERT_MSG_EQ (generator->GetFrameType (0, 25), VideoStreamFrameGenerator::I_FRAME, "A GOP does not start with an I frame");
+
+  // the sizes depend on the seed, title and frame only, and follow the bitrate
+  generator = CreateObject<VideoStreamFrameGenerator> ();
+  Ptr<VideoStreamFrameGenerator> same = CreateObject<VideoStreamFrameGenerator> ();
+  Ptr<VideoStreamFrameGenerator> other = CreateObject<VideoStreamFrameGenerator> ();
+  other->SetAttribute ("Seed", UintegerValue (2));
+  uint64_t total = 0;
+  uint32_t differences = 0;
+  for (uint32_t frame = 1500; frame-- > 0;)
+  {
+    uint32_t size = generator->GetFrameSize (0, 1, frame);
+    NS_TEST_ASSERT_MSG_EQ (size, same->GetFrameSize (0, 1, frame), "The same seed gave another frame size");
+    differences += size != other->GetFrameSize (0, 1, frame);
+    total += size;
+  }
+  NS_TEST_ASSERT_MSG_GT (differences, 1400, "Another seed gave the same frame sizes");
+  NS_TEST_ASSERT_MSG_EQ_TOL (total / 1500.0, generator->GetMeanFrameSize (1), generator->GetMeanFrameSize (1) * 0.15, "The frame sizes do not follow the bitrate");
+  NS_TEST_ASSERT_MSG_EQ_TOL (generator->GetFrameSize (0, 2, 100), 2 * generator->GetFrameSize (0, 1, 100), 1, "Level 2 is not twice level 1");
+  NS_TEST_ASSERT_MSG_NE (generator->GetFrameSize (1, 1, 100), generator->GetFrameSize (0, 1, 100), "Two titles have the same frame sizes");
+  NS_TEST_ASSERT_MSG_GT (generator->GetFrameSize (0, 1, 4000000000u), 0, "A frame far in the title has no size");
+
+  // a server without a frame file streams the generated sizes of a 2 s title
+  Config::SetDefault ("ns3::VideoStreamServer::FrameGenerator", PointerValue (generator));
+  Config::SetDefault ("ns3::VideoStreamServer::VideoLength", UintegerValue (2));
+  RunScenario (std::vector<uint32_t> (), "100Mbps", 1400, 1, false, Seconds (3.0));
+  Config::SetDefault ("ns3::VideoStreamServer::FrameGenerator", PointerValue ());
+  Config::SetDefault ("ns3::VideoStreamServer::VideoLength", UintegerValue (60));
+
+  uint64_t expected = 0;
+  for (uint32_t frame = 0; frame < 50; frame++)
+  {
+    expected += generator->GetFrameSize (0, 1, frame);
+  }
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), 50, "The server did not stream the generated title");
+  NS_TEST_ASSERT_MSG_EQ (m_txBytes, expected, "The server did not send the generated frame sizes");
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, m_txBytes, "The client did not receive every byte");
+}
+
+/**
+ * @brief Check that PathMtu fragments follow the MTU of the link.
+ */
+class VideoStreamPathMtuTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamPathMtuTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamPathMtuTestCase::VideoStreamPathMtuTestCase ()
+  : VideoStreamTestCase ("Check the path MTU fragment sizing")
+{
+}
+
+void
+VideoStreamPathMtuTestCase::DoRun (void)
+{
+  // a 9000-byte link carries a 20000-byte frame in 3 jumbo fragments
+  std::vector<uint32_t> frameSizes (50, 20000);
+  Config::SetDefault ("ns3::PointToPointNetDevice::Mtu", UintegerValue (9000));
+  Config::SetDefault ("ns3::VideoStreamServer::FragmentSizing", StringValue ("PathMtu"));
+  Config::SetDefault ("ns3::VideoStreamServer::Jumbo", BooleanValue (true));
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+  NS_TEST_ASSERT_MSG_EQ (m_maxPacketSize, 9000 - 28, "The fragments do not fill the path MTU");
+  NS_TEST_ASSERT_MSG_EQ (m_txPackets, 50 * 3, "Wrong number of jumbo fragments");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), 50, "Not every frame was received");
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, m_txBytes, "The client did not receive every byte");
+
+  // without jumbo fragments the same link is used like an Ethernet link
+  Config::SetDefault ("ns3::VideoStreamServer::Jumbo", BooleanValue (false));
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+  NS_TEST_ASSERT_MSG_EQ (m_maxPacketSize, 1500 - 28, "The fragments exceed an Ethernet MTU");
+  NS_TEST_ASSERT_MSG_EQ (m_txPackets, 50 * 14, "Wrong number of fragments");
+
+  // fixed fragments ignore the MTU
+  Config::SetDefault ("ns3::VideoStreamServer::FragmentSizing", StringValue ("Fixed"));
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+  Config::SetDefault ("ns3::PointToPointNetDevice::Mtu", UintegerValue (1500));
+  NS_TEST_ASSERT_MSG_EQ (m_maxPacketSize, 1400, "Fixed fragments do not follow MaxPacketSize");
+  NS_TEST_ASSERT_MSG_EQ (m_txPackets, 50 * 15, "Wrong number of fragments");
+}
+
+/**
+ * @brief Check that aggregated fragments keep the bytes, frames and loss accounting.
+ */
+class VideoStreamAggregationTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamAggregationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamAggregationTestCase::VideoStreamAggregationTestCase ()
+  : VideoStreamTestCase ("Check the frame aggregation fast mode")
+{
+}
+
+void
+VideoStreamAggregationTestCase::DoRun (void)
+{
+  std::vector<uint32_t> frameSizes (50, 20000);
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+  uint64_t fragmentEvents = m_events;
+
+  // the 15 fragments of a frame go in 2 packets of at most 8 fragments
+  Config::SetDefault ("ns3::PointToPointNetDevice::Mtu", UintegerValue (65535));
+  Config::SetDefault ("ns3::VideoStreamServer::FrameAggregation", UintegerValue (8));
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+  Config::SetDefault ("ns3::PointToPointNetDevice::Mtu", UintegerValue (1500));
+  Config::SetDefault ("ns3::VideoStreamServer::FrameAggregation", UintegerValue (0));
+  NS_TEST_ASSERT_MSG_EQ (m_txPackets, 50 * 2, "Wrong number of aggregated packets");
+  NS_TEST_ASSERT_MSG_EQ (m_maxPacketSize, 8 * 1400, "Wrong size of an aggregated packet");
+  NS_TEST_ASSERT_MSG_EQ (m_txBytes, 50 * 20000, "The aggregated packets do not carry the frame bytes");
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, m_txBytes, "The client did not receive every byte");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), 50, "Not every frame was received");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetLostPackets (), 0, "Aggregated fragments were counted as lost");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReorderedPackets (), 0, "Aggregated fragments were counted as reordered");
+  NS_TEST_ASSERT_MSG_LT (m_events, fragmentEvents, "Aggregation did not reduce the number of events");
+}
+
+/**
+ * @brief Check that a lost HELLO is repeated and that the session keeps to the announced level.
+ */
+class VideoStreamHandshakeTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamHandshakeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * @brief Run a client started before the server, so that its first HELLO is lost.
+   *
+   * @param helloTimeout the HelloTimeout of the client
+   */
+  void RunLateServer (Time helloTimeout);
+};
+
+VideoStreamHandshakeTestCase::VideoStreamHandshakeTestCase ()
+  : VideoStreamTestCase ("Check the session handshake")
+{
+}
+
+void
+VideoStreamHandshakeTestCase::RunLateServer (Time helloTimeout)
+{
+  m_serverStart = Seconds (1.0);
+  SetClientAttribute ("MaxVideoLevel", UintegerValue (2));
+  SetClientAttribute ("HelloTimeout", TimeValue (helloTimeout));
+  RunScenario (std::vector<uint32_t> (200, 2000), "100Mbps", 1400, 3, true, Seconds (8.0));
+}
+
+void
+VideoStreamHandshakeTestCase::DoRun (void)
+{
+  // the HELLO at 0.5s finds no server, the retries follow 200ms and 600ms later
+  RunLateServer (MilliSeconds (200));
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetHelloAttempts (), 3, "The lost hello was not repeated with backoff");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_client->GetHandshakeTime (), MilliSeconds (600), "The session started before the server");
+  NS_TEST_ASSERT_MSG_LT (m_client->GetHandshakeTime (), MilliSeconds (700), "The handshake took longer than the retries");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), 200, "The session was not streamed after the handshake");
+  // the buffer grows past 5 seconds, but the client never asks for more than it announced
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetVideoLevel (), 2, "The client adapted above its maximum level");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedVideoLevel (), 2, "The server sent above the announced level");
+
+  // a single HELLO is lost for good
+  RunLateServer (Seconds (0.0));
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetHelloAttempts (), 1, "The hello was repeated without a timeout");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), 0, "Frames arrived without a session");
+}
+
+/**
+ * @brief Check the playback start threshold and the fast-start burst.
+ */
+class VideoStreamFastStartTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamFastStartTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamFastStartTestCase::VideoStreamFastStartTestCase ()
+  : VideoStreamTestCase ("Check the fast start")
+{
+}
+
+void
+VideoStreamFastStartTestCase::DoRun (void)
+{
+  std::vector<uint32_t> frameSizes (100, 2000);
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+  NS_TEST_ASSERT_MSG_LT (m_client->GetTimeToFirstFrame (), MilliSeconds (10), "The first frame took longer than a round trip");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetStartupDelay (), Seconds (3.0), "The playback did not wait for the initial delay");
+
+  // 50 frames arrive one Interval apart
+  Config::SetDefault ("ns3::VideoStreamClient::StartThreshold", UintegerValue (50));
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+  NS_TEST_ASSERT_MSG_GT (m_client->GetStartupDelay (), MilliSeconds (450), "The playback started before the threshold");
+  NS_TEST_ASSERT_MSG_LT (m_client->GetStartupDelay (), MilliSeconds (550), "The playback did not start at the threshold");
+
+  // the burst sends them at 20Mbps instead
+  Config::SetDefault ("ns3::VideoStreamServer::FastStartFrames", UintegerValue (100));
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (5.0));
+  Config::SetDefault ("ns3::VideoStreamClient::StartThreshold", UintegerValue (0));
+  Config::SetDefault ("ns3::VideoStreamServer::FastStartFrames", UintegerValue (0));
+  NS_TEST_ASSERT_MSG_LT (m_client->GetStartupDelay (), MilliSeconds (100), "The burst did not fill the buffer faster than real time");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), 100, "Not every frame of the burst was received");
+  NS_TEST_ASSERT_MSG_EQ (m_rxBytes, m_txBytes, "The client did not receive every byte");
+}
+
+/**
+ * @brief Check the fluid sessions of a population and the capacity they leave to the packets.
+ */
+class VideoStreamFluidTestCase : public TestCase
+{
+public:
+  VideoStreamFluidTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * @brief Run 6 fluid and 2 packet sessions of 1 Mbit/s through a bottleneck.
+   *
+   * @param bottleneckRate the data rate of the bottleneck
+   * @return the fluid model of the run
+   */
+  Ptr<VideoStreamFluidModel> RunScenario (std::string bottleneckRate);
+
+  /**
+   * @brief Record the data rate of the bottleneck.
+   *
+   * @param device the device sending on the bottleneck
+   */
+  void SampleRate (Ptr<NetDevice> device);
+
+  uint32_t m_packetClients; //!< Packet-level clients installed by the last run
+  DataRate m_sharedRate; //!< Data rate of the bottleneck while the sessions run
+  DataRate m_finalRate; //!< Data rate of the bottleneck after the sessions
+};
+
+VideoStreamFluidTestCase::VideoStreamFluidTestCase ()
+  : TestCase ("Check the hybrid fluid and packet population"),
+    m_packetClients (0)
+{
+}
+
+void
+VideoStreamFluidTestCase::SampleRate (Ptr<NetDevice> device)
+{
+  DataRateValue rate;
+  device->GetAttribute ("DataRate", rate);
+  m_finalRate = rate.Get ();
+  if (Simulator::Now () < Seconds (9.0))
+  {
+    m_sharedRate = rate.Get ();
+  }
+}
+
+Ptr<VideoStreamFluidModel>
+VideoStreamFluidTestCase::RunScenario (std::string bottleneckRate)
+{
+  // server, router and viewer node
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  PointToPointHelper access;
+  access.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  access.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer serverDevices = access.Install (nodes.Get (0), nodes.Get (1));
+  PointToPointHelper bottleneck;
+  bottleneck.SetDeviceAttribute ("DataRate", StringValue (bottleneckRate));
+  bottleneck.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer viewerDevices = bottleneck.Install (nodes.Get (1), nodes.Get (2));
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer serverInterfaces = address.Assign (serverDevices);
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  address.Assign (viewerDevices);
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  Ptr<VideoStreamFrameGenerator> generator = CreateObject<VideoStreamFrameGenerator> ();
+  generator->SetAttribute ("BitRate", DataRateValue (DataRate ("1Mbps")));
+  uint16_t port = 6969;
+  VideoStreamServerHelper videoServer (port);
+  videoServer.SetAttribute ("FrameGenerator", PointerValue (generator));
+  videoServer.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (0));
+  serverApp.Start (Seconds (0.0));
+  serverApp.Stop (Seconds (10.0));
+
+  // one client in 4 runs at the packet level
+  Ptr<VideoStreamFluidModel> model = CreateObject<VideoStreamFluidModel> ();
+  model->SetAttribute ("BitRate", DataRateValue (DataRate ("1Mbps")));
+  model->SetAttribute ("VideoLevel", UintegerValue (1));
+  VideoStreamPopulationHelper population (serverInterfaces.GetAddress (0), port);
+  population.SetClientAttribute ("InitialVideoLevel", UintegerValue (1));
+  population.SetClientAttribute ("Adaptive", BooleanValue (false));
+  population.SetFluidModel (model, 4);
+  ApplicationContainer clientApps = population.Install (NodeContainer (nodes.Get (2)), 8, Seconds (0.5), Seconds (9.5));
+  m_packetClients = clientApps.GetN ();
+
+  Simulator::Schedule (Seconds (5.0), &VideoStreamFluidTestCase::SampleRate, this, viewerDevices.Get (0));
+  Simulator::Schedule (Seconds (9.9), &VideoStreamFluidTestCase::SampleRate, this, viewerDevices.Get (0));
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return model;
+}
+
+void
+VideoStreamFluidTestCase::DoRun (void)
+{
+  // every session gets its bitrate: the playback starts after the initial delay and never stalls
+  Ptr<VideoStreamFluidModel> model = RunScenario ("100Mbps");
+  NS_TEST_ASSERT_MSG_EQ (m_packetClients, 2, "Wrong number of packet-level clients");
+  NS_TEST_ASSERT_MSG_EQ (model->GetFluidSessions (), 6, "Wrong number of fluid sessions");
+  NS_TEST_ASSERT_MSG_EQ (model->GetUnroutedSessions (), 0, "A fluid session found no route");
+  NS_TEST_ASSERT_MSG_EQ (model->GetStallCount (), 0, "A fluid session stalled on an idle link");
+  NS_TEST_ASSERT_MSG_EQ (model->GetStartupDelayHistogram ().GetCount (), 6, "Not every fluid session played");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetStartupDelayHistogram ().GetMean ().GetSeconds (), 3.0, 0.001, "Wrong startup delay");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetDeliveredBytes (), 6 * 125000 * 9.0, 1000, "Wrong bytes delivered to the fluid sessions");
+  NS_TEST_ASSERT_MSG_EQ (m_sharedRate.GetBitRate (), 94000000, "The bottleneck does not leave the packets the capacity the fluid sessions do not use");
+  NS_TEST_ASSERT_MSG_EQ (m_finalRate.GetBitRate (), 100000000, "The bottleneck capacity was not restored");
+  model->Dispose ();
+
+  // 8 sessions share 4 Mbit/s: the fluid buffers fill at half speed, play at 3.5 s,
+  // empty at 6.5 s and resume 2 s later
+  model = RunScenario ("4Mbps");
+  NS_TEST_ASSERT_MSG_EQ (m_sharedRate.GetBitRate (), 1000000, "The packets do not get their max-min share");
+  NS_TEST_ASSERT_MSG_EQ (model->GetStallCount (), 6, "Every fluid session should stall once");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetStallHistogram ().GetMean ().GetSeconds (), 2.0, 0.001, "Wrong stall duration");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetDeliveredBytes (), 6 * 62500 * 9.0, 1000, "Wrong bytes delivered to the fluid sessions");
+  model->Dispose ();
+}
+
+/**
+ * @brief Check the keyframe index, the seeks and the fast forward.
+ */
+class VideoStreamSeekTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamSeekTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void ScenarioInstalled (void);
+
+  /**
+   * @brief Run a client that seeks or fast forwards at 2 seconds.
+   *
+   * @param frame the frame to seek to
+   * @param trickPlay whether the client fast forwards
+   */
+  void RunSeek (uint32_t frame, bool trickPlay);
+
+  /**
+   * @brief Record the frames received in fast forward.
+   *
+   * @param packet the packet
+   * @param from the sender address
+   */
+  void TrickPlayRx (Ptr<const Packet> packet, const Address &from);
+
+  uint32_t m_seekFrame; //!< Frame the client of the next run seeks to
+  bool m_trickPlay; //!< Whether the client of the next run fast forwards
+  std::vector<uint32_t> m_trickFrames; //!< Frames received in fast forward
+};
+
+VideoStreamSeekTestCase::VideoStreamSeekTestCase ()
+  : VideoStreamTestCase ("Check the seeks and the fast forward"),
+    m_seekFrame (0),
+    m_trickPlay (false)
+{
+}
+
+void
+VideoStreamSeekTestCase::TrickPlayRx (Ptr<const Packet> packet, const Address &from)
+{
+  VideoStreamHeader header;
+  packet->PeekHeader (header);
+  if (header.GetMessageType () == VideoStreamHeader::DATA
+      && (header.GetFlags () & VideoStreamHeader::TRICK_PLAY) && (header.GetFlags () & VideoStreamHeader::LAST_FRAGMENT))
+  {
+    m_trickFrames.push_back (header.GetFrame ());
+  }
+}
+
+void
+VideoStreamSeekTestCase::ScenarioInstalled (void)
+{
+  m_client->TraceConnectWithoutContext ("Rx", MakeCallback (&VideoStreamSeekTestCase::TrickPlayRx, this));
+  Simulator::Schedule (Seconds (2.0), m_trickPlay ? &VideoStreamClient::FastForward : &VideoStreamClient::Seek, m_client, m_seekFrame);
+}
+
+void
+VideoStreamSeekTestCase::RunSeek (uint32_t frame, bool trickPlay)
+{
+  // 2000-byte frames with a scene change at frame 310
+  std::vector<uint32_t> frameSizes (500, 2000);
+  frameSizes[310] = 10000;
+  m_trickFrames.clear ();
+  m_seekFrame = frame;
+  m_trickPlay = trickPlay;
+  RunScenario (frameSizes, "100Mbps", 1400, 1, false, Seconds (6.0));
+}
+
+void
+VideoStreamSeekTestCase::DoRun (void)
+{
+  RunSeek (320, false);
+  // a GOP every 25 frames, and one at the scene change
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetKeyframe (0, 0), 0, "The first frame is not a keyframe");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetKeyframe (0, 309), 300, "Wrong keyframe of a regular GOP");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetKeyframe (0, 320), 310, "The scene change is not a keyframe");
+  NS_TEST_ASSERT_MSG_EQ (m_server->GetKeyframe (0, 340), 335, "The GOP after the scene change is not indexed");
+  // the server sends a frame every 10ms, so the 25 frames of one second follow the first within 240ms
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetSeekCount (), 1, "The seek was not counted");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetSeekLatencyHistogram ().GetCount (), 1, "The playback did not resume after the seek");
+  NS_TEST_ASSERT_MSG_GT (m_client->GetSeekLatencyHistogram ().GetMax (), MilliSeconds (240), "The playback resumed before the buffer refilled");
+  NS_TEST_ASSERT_MSG_LT (m_client->GetSeekLatencyHistogram ().GetMax (), MilliSeconds (260), "The refill took longer than 25 frames");
+
+  // fast forward from the start sends the 21 keyframes only
+  RunSeek (10, true);
+  NS_TEST_ASSERT_MSG_EQ (m_trickFrames.size (), 21, "Wrong number of keyframes in fast forward");
+  for (uint32_t frame : m_trickFrames)
+  {
+    NS_TEST_ASSERT_MSG_EQ (m_server->GetKeyframe (0, frame), frame, "Fast forward sent a frame that is not a keyframe");
+  }
+}
+
+/**
+ * @brief Check the bitrate ladder and its negotiation.
+ */
+class VideoStreamLadderTestCase : public VideoStreamTestCase
+{
+public:
+  VideoStreamLadderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamLadderTestCase::VideoStreamLadderTestCase ()
+  : VideoStreamTestCase ("Check the bitrate ladder")
+{
+}
+
+void
+VideoStreamLadderTestCase::DoRun (void)
+{
+  VideoStreamLadder ladder ("640x360@1Mbps; 1280x720@3Mbps;1920x1080@6Mbps");
+  NS_TEST_ASSERT_MSG_EQ (ladder.GetLevelCount (), 3, "Wrong number of renditions");
+  NS_TEST_ASSERT_MSG_EQ (ladder.GetRendition (2).m_height, 720, "Wrong resolution");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ladder.GetScale (3), 6.0, 1e-9, "Wrong scale of a level");
+  NS_TEST_ASSERT_MSG_EQ (ladder.GetMaxLevel (0), 3, "A display of any size does not show every level");
+  NS_TEST_ASSERT_MSG_EQ (ladder.GetMaxLevel (720), 2, "Wrong highest level of a 720 line display");
+  NS_TEST_ASSERT_MSG_EQ (ladder.GetMaxLevel (240), 1, "A small display does not show the lowest level");
+  NS_TEST_ASSERT_MSG_EQ (VideoStreamLadder (ladder.ToString ()).ToString (), ladder.ToString (), "The description does not parse back");
+
+  // without frame sizes, a frame of level 2 carries 3Mbps for one 10ms Interval
+  SetServerAttribute ("Ladder", StringValue (ladder.ToString ()));
+  SetServerAttribute ("VideoLength", UintegerValue (1));
+  SetClientAttribute ("MaxHeight", UintegerValue (720));
+  RunScenario (std::vector<uint32_t> (), "100Mbps", 1400, 3, false, Seconds (3.0));
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetLadder ().GetLevelCount (), 3, "The client did not receive the ladder");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedVideoLevel (), 2, "The server sent above the display of the client");
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedFrames (), 25, "Not every frame was received");
+  NS_TEST_ASSERT_MSG_EQ (m_txBytes, 25 * 3750, "The frames do not carry the bitrate of the level");
+
+  // a rendition with its own frame file sends it, from the start again once it ends
+  std::string frameFile = CreateTempDirFilename ("rendition-frames.txt");
+  std::ofstream frameStream (frameFile);
+  for (uint32_t i = 0; i < 10; i++)
+  {
+    frameStream << 1000 << "\n";
+  }
+  frameStream.close ();
+  SetServerAttribute ("Ladder", StringValue ("640x360@1Mbps," + frameFile + ";1280x720@3Mbps"));
+  SetClientAttribute ("MaxHeight", UintegerValue (360));
+  RunScenario (std::vector<uint32_t> (), "100Mbps", 1400, 3, false, Seconds (3.0));
+  NS_TEST_ASSERT_MSG_EQ (m_client->GetReceivedVideoLevel (), 1, "The server sent above the display of the client");
+  NS_TEST_ASSERT_MSG_EQ (m_txBytes, 25 * 1000, "The rendition did not send its frame file");
+}
+
+/**
+ * @brief Check that the request router spreads the sessions over its servers.
+ */
+class VideoStreamRouterTestCase : public TestCase
+{
+public:
+  VideoStreamRouterTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * @brief Run six clients of one title behind a router and three servers.
+   *
+   * @param policy the Policy of the router
+   */
+  void RunRouter (std::string policy);
+
+  std::vector<uint32_t> m_admittedSessions; //!< Sessions admitted by each server
+  uint32_t m_redirectedClients; //!< Clients redirected and streamed to the end
+  uint32_t m_knownServers; //!< Servers the router learnt from their load reports
+};
+
+VideoStreamRouterTestCase::VideoStreamRouterTestCase ()
+  : TestCase ("Check the request router")
+{
+}
+
+void
+VideoStreamRouterTestCase::RunRouter (std::string policy)
+{
+  // servers 1 to 3 and the clients on node 4, all behind the router on node 0
+  NodeContainer nodes;
+  nodes.Create (5);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  std::vector<Ipv4InterfaceContainer> interfaces;
+  for (uint32_t i = 1; i < nodes.GetN (); i++)
+  {
+    std::ostringstream subnet;
+    subnet << "10.1." << i << ".0";
+    address.SetBase (subnet.str ().c_str (), "255.255.255.0");
+    interfaces.push_back (address.Assign (pointToPoint.Install (nodes.Get (0), nodes.Get (i))));
+  }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t routerPort = 7000;
+  VideoStreamRouterHelper videoRouter (routerPort);
+  videoRouter.SetAttribute ("Policy", StringValue (policy));
+  ApplicationContainer routerApp = videoRouter.Install (nodes.Get (0));
+  routerApp.Start (Seconds (0.0));
+  routerApp.Stop (Seconds (3.0));
+
+  // the servers are only known from their load reports
+  VideoStreamServerHelper videoServer (6969);
+  videoServer.SetAttribute ("VideoLength", UintegerValue (1));
+  videoServer.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+  videoServer.SetAttribute ("RouterAddress", AddressValue (interfaces[0].GetAddress (0)));
+  videoServer.SetAttribute ("RouterPort", UintegerValue (routerPort));
+  ApplicationContainer serverApps = videoServer.Install (NodeContainer (nodes.Get (1), nodes.Get (2), nodes.Get (3)));
+  serverApps.Start (Seconds (0.0));
+  serverApps.Stop (Seconds (3.0));
+
+  // the clients arrive between two load reports
+  ApplicationContainer clientApps;
+  for (uint32_t i = 0; i < 6; i++)
+  {
+    VideoStreamClientHelper videoClient (interfaces[3].GetAddress (0), routerPort);
+    videoClient.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+    videoClient.SetAttribute ("Adaptive", BooleanValue (false));
+    ApplicationContainer clientApp = videoClient.Install (nodes.Get (4));
+    clientApp.Start (Seconds (0.5 + 0.01 * i));
+    clientApp.Stop (Seconds (3.0));
+    clientApps.Add (clientApp);
+  }
+
+  Simulator::Stop (Seconds (3.0));
+  Simulator::Run ();
+
+  m_admittedSessions.clear ();
+  for (uint32_t i = 0; i < serverApps.GetN (); i++)
+  {
+    m_admittedSessions.push_back (DynamicCast<VideoStreamServer> (serverApps.Get (i))->GetAdmittedSessions ());
+  }
+  m_redirectedClients = 0;
+  for (uint32_t i = 0; i < clientApps.GetN (); i++)
+  {
+    Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (clientApps.Get (i));
+    if (client->IsRedirected () && client->GetReceivedFrames () == 25)
+    {
+      m_redirectedClients++;
+    }
+  }
+  m_knownServers = DynamicCast<VideoStreamRouter> (routerApp.Get (0))->GetServerCount ();
+  Simulator::Destroy ();
+}
+
+void
+VideoStreamRouterTestCase::DoRun (void)
+{
+  // the sessions redirected since the last report count in the load of a server
+  RunRouter ("LeastLoad");
+  NS_TEST_ASSERT_MSG_EQ (m_knownServers, 3, "The router did not learn the servers from their load reports");
+  NS_TEST_ASSERT_MSG_EQ (m_redirectedClients, 6, "A client was not redirected to a server streaming the title");
+  for (uint32_t sessions : m_admittedSessions)
+  {
+    NS_TEST_ASSERT_MSG_EQ (sessions, 2, "The sessions were not spread evenly");
+  }
+
+  // every session of a title goes to the server of the title on the ring
+  RunRouter ("ContentHash");
+  NS_TEST_ASSERT_MSG_EQ (m_redirectedClients, 6, "A client was not redirected to a server streaming the title");
+  NS_TEST_ASSERT_MSG_EQ (*std::max_element (m_admittedSessions.begin (), m_admittedSessions.end ()), 6,
+                         "The sessions of a title went to several servers");
+}
+
+/**
+ * @brief Check that a client whose server stops fails over to the next server
+ * and resumes after the last complete frame.
+ */
+class VideoStreamFailoverTestCase : public TestCase
+{
+public:
+  VideoStreamFailoverTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamFailoverTestCase::VideoStreamFailoverTestCase ()
+  : TestCase ("Check the failover to the next server")
+{
+}
+
+void
+VideoStreamFailoverTestCase::DoRun (void)
+{
+  // server A on node 1 and server B on node 2, both linked to the client on node 0
+  NodeContainer nodes;
+  nodes.Create (3);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfacesA = address.Assign (pointToPoint.Install (nodes.Get (0), nodes.Get (1)));
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfacesB = address.Assign (pointToPoint.Install (nodes.Get (0), nodes.Get (2)));
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  VideoStreamServerHelper videoServer (6969);
+  videoServer.SetAttribute ("VideoLength", UintegerValue (4));
+  videoServer.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+  ApplicationContainer serverA = videoServer.Install (nodes.Get (1));
+  serverA.Start (Seconds (0.0));
+  serverA.Stop (Seconds (1.0));
+  ApplicationContainer serverB = videoServer.Install (nodes.Get (2));
+  serverB.Start (Seconds (0.0));
+  serverB.Stop (Seconds (10.0));
+
+  std::ostringstream failoverServers;
+  failoverServers << interfacesB.GetAddress (1) << ":6969";
+  VideoStreamClientHelper videoClient (interfacesA.GetAddress (1), 6969);
+  videoClient.SetAttribute ("InitialVideoLevel", UintegerValue (1));
+  videoClient.SetAttribute ("Adaptive", BooleanValue (false));
+  videoClient.SetAttribute ("FailoverServers", StringValue (failoverServers.str ()));
+  videoClient.SetAttribute ("FailoverTimeout", TimeValue (MilliSeconds (500)));
+  ApplicationContainer clientApp = videoClient.Install (nodes.Get (0));
+  clientApp.Start (Seconds (0.5));
+  clientApp.Stop (Seconds (10.0));
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+
+  Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (clientApp.Get (0));
+  NS_TEST_ASSERT_MSG_EQ (client->GetFailoverServers (), failoverServers.str (), "The failover servers were not parsed");
+  NS_TEST_ASSERT_MSG_EQ (client->GetFailoverCount (), 1, "The client did not fail over once");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<VideoStreamServer> (serverB.Get (0))->GetAdmittedSessions (), 1,
+                         "The next server did not admit the session");
+  // every frame arrives once, the frames of server B following the last frame of server A
+  NS_TEST_ASSERT_MSG_EQ (client->GetReceivedFrames (), 100, "The session did not resume after the last complete frame");
+  const VideoStreamHistogram &gap = client->GetFailoverGapHistogram ();
+  NS_TEST_ASSERT_MSG_EQ (gap.GetCount (), 1, "The failover gap was not recorded");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (gap.GetMax (), MilliSeconds (500), "The gap is shorter than the failover timeout");
+  NS_TEST_ASSERT_MSG_LT (gap.GetMax (), MilliSeconds (600), "The gap is longer than the timeout and a handshake");
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Check that a multipath session spreads its fragments over the
+ * interfaces of its client by the rate of each path.
+ */
+class VideoStreamMultipathTestCase : public TestCase
+{
+public:
+  VideoStreamMultipathTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamMultipathTestCase::VideoStreamMultipathTestCase ()
+  : TestCase ("Check the multipath session")
+{
+}
+
+void
+VideoStreamMultipathTestCase::DoRun (void)
+{
+  // the client on node 0 reaches the server on node 1 over a 1.5 Mbps and a 2 Mbps link
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  Ipv4AddressHelper address;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("1.5Mbps"));
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer slowLink = address.Assign (pointToPoint.Install (nodes.Get (0), nodes.Get (1)));
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("2Mbps"));
+  address.SetBase ("10.1.2.0", "255.255.255.0");
+  Ipv4InterfaceContainer fastLink = address.Assign (pointToPoint.Install (nodes.Get (0), nodes.Get (1)));
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  // the session takes the fast link to the server address of the slow one, the subflow the slow link
+  Ipv4StaticRoutingHelper staticRouting;
+  staticRouting.GetStaticRouting (nodes.Get (0)->GetObject<Ipv4> ())->AddHostRouteTo (slowLink.GetAddress (1), fastLink.GetAddress (1), fastLink.Get (0).second);
+
+  // a 3 Mbps title fits neither link alone
+  VideoStreamServerHelper videoServer (6969);
+  videoServer.SetAttribute ("Ladder", StringValue ("1280x720@3Mbps"));
+  videoServer.SetAttribute ("VideoLength", UintegerValue (4));
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (1));
+  serverApp.Start (Seconds (0.0));
+  serverApp.Stop (Seconds (10.0));
+
+  VideoStreamClientHelper videoClient (slowLink.GetAddress (1), 6969);
+  videoClient.SetAttribute ("Adaptive", BooleanValue (false));
+  videoClient.SetAttribute ("Multipath", BooleanValue (true));
+  videoClient.SetAttribute ("ReportInterval", TimeValue (MilliSeconds (100)));
+  ApplicationContainer clientApp = videoClient.Install (nodes.Get (0));
+  clientApp.Start (Seconds (0.5));
+  clientApp.Stop (Seconds (10.0));
+
+  Simulator::Stop (Seconds (10.0));
+  Simulator::Run ();
+
+  Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (clientApp.Get (0));
+  NS_TEST_ASSERT_MSG_EQ (client->GetPathCount (), 2, "The client did not open a subflow on its other interface");
+  NS_TEST_ASSERT_MSG_EQ (client->IsPathJoined (1), true, "The server did not accept the subflow");
+  NS_TEST_ASSERT_MSG_EQ (DynamicCast<VideoStreamServer> (serverApp.Get (0))->GetJoinedSubflows (), 1, "The server did not join the subflow");
+  // every frame is counted once, however its fragments were split
+  NS_TEST_ASSERT_MSG_EQ (client->GetReceivedFrames (), 100, "The frames were not reassembled from both paths");
+  NS_TEST_ASSERT_MSG_GT (client->GetPathShare (1), 0.1, "The slow path carried nothing");
+  NS_TEST_ASSERT_MSG_GT (client->GetPathShare (0), client->GetPathShare (1), "The fast path did not carry the larger share");
+  NS_TEST_ASSERT_MSG_GT (client->GetAggregateThroughput ().GetBitRate (), 2000000, "The paths did not carry more than the fast link alone");
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Video stream application test suite.
+ */
+class VideoStreamTestSuite : public TestSuite
+{
+public:
+  VideoStreamTestSuite ();
+};
+
+VideoStreamTestSuite::VideoStreamTestSuite ()
+  : TestSuite ("video-stream", UNIT)
+{
+  AddTestCase (new VideoStreamDeliveryTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamFragmentationTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamLevelSwitchTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamStallTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamBudgetTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamEventLogTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamPopulationTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamCatalogTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamPopularityTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamCacheTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamProxyTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamLiveTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamAdmissionTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamRateControlTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamDeliveryStatsTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamHistogramTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamFrameGeneratorTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamPathMtuTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamAggregationTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamFluidTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamHandshakeTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamFastStartTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamSeekTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamLadderTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamRouterTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamFailoverTestCase, TestCase::QUICK);
+  AddTestCase (new VideoStreamMultipathTestCase, TestCase::QUICK);
+}
+
+static VideoStreamTestSuite g_videoStreamTestSuite; //!< Static variable for test initialization
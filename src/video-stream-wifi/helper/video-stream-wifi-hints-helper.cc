@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "video-stream-wifi-hints-helper.h"
+#include "ns3/log.h"
+#include "ns3/config.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/mac48-address.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/wifi-mode.h"
+#include "ns3/wifi-phy-common.h"
+#include "ns3/video-stream-client.h"
+
+#include <cmath>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamWifiHintsHelper");
+
+/**
+ * @brief Read a frame received by the PHY of a followed device.
+ *
+ * @param monitor the monitor
+ * @param address the MAC address of the device
+ * @param packet the frame
+ * @param snr the SNR of the frame as a ratio
+ * @param mode the mode of the frame
+ * @param preamble the preamble of the frame
+ */
+static void
+PhyRxOk (Ptr<VideoStreamLinkMonitor> monitor, Mac48Address address,
+         Ptr<const Packet> packet, double snr, WifiMode mode, WifiPreamble preamble)
+{
+  WifiMacHeader header;
+  packet->PeekHeader (header);
+  bool data = header.IsData () && header.GetAddr1 () == address;
+  monitor->RecordReception (10 * std::log10 (snr), data, DataRate (mode.GetDataRate (20)), mode.GetUniqueName (),
+                            data && header.IsRetry ());
+}
+
+/**
+ * @brief Count a frame a followed device sends.
+ *
+ * @param monitor the monitor
+ * @param packet the frame
+ */
+static void
+MacTx (Ptr<VideoStreamLinkMonitor> monitor, Ptr<const Packet> packet)
+{
+  monitor->RecordTransmission (false);
+}
+
+/**
+ * @brief Count a failed attempt of a followed device.
+ *
+ * @param monitor the monitor
+ * @param address the receiver of the frame
+ */
+static void
+MacTxDataFailed (Ptr<VideoStreamLinkMonitor> monitor, Mac48Address address)
+{
+  monitor->RecordTransmission (true);
+}
+
+uint32_t
+VideoStreamWifiHintsHelper::Attach (Ptr<VideoStreamLinkMonitor> monitor, Ptr<Node> node)
+{
+  uint32_t devices = 0;
+  for (uint32_t index = 0; index < node->GetNDevices (); index++)
+  {
+    Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (node->GetDevice (index));
+    if (device == 0)
+    {
+      continue;
+    }
+    std::ostringstream path;
+    path << "/NodeList/" << node->GetId () << "/DeviceList/" << index << "/$ns3::WifiNetDevice/";
+    Config::ConnectWithoutContext (path.str () + "Phy/State/RxOk",
+                                   MakeBoundCallback (&PhyRxOk, monitor, Mac48Address::ConvertFrom (device->GetAddress ())));
+    Config::ConnectWithoutContext (path.str () + "Mac/MacTx", MakeBoundCallback (&MacTx, monitor));
+    Config::ConnectWithoutContext (path.str () + "RemoteStationManager/MacTxDataFailed", MakeBoundCallback (&MacTxDataFailed, monitor));
+    devices++;
+  }
+  NS_LOG_INFO ("Link monitor follows " << devices << " Wi-Fi devices of node " << node->GetId ());
+  return devices;
+}
+
+Ptr<VideoStreamLinkMonitor>
+VideoStreamWifiHintsHelper::Install (Ptr<VideoStreamClient> client) const
+{
+  Ptr<VideoStreamLinkMonitor> monitor = CreateObject<VideoStreamLinkMonitor> ();
+  if (Attach (monitor, client->GetNode ()) == 0)
+  {
+    NS_LOG_WARN ("No Wi-Fi device on node " << client->GetNode ()->GetId () << " to give link hints");
+    return 0;
+  }
+  client->SetAttribute ("LinkMonitor", PointerValue (monitor));
+  return monitor;
+}
+
+uint32_t
+VideoStreamWifiHintsHelper::Install (ApplicationContainer apps) const
+{
+  uint32_t clients = 0;
+  for (ApplicationContainer::Iterator i = apps.Begin (); i != apps.End (); ++i)
+  {
+    Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (*i);
+    if (client != 0 && Install (client) != 0)
+    {
+      clients++;
+    }
+  }
+  return clients;
+}
+
+} // namespace ns3
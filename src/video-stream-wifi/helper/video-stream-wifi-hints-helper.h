@@ -0,0 +1,59 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#ifndef VIDEO_STREAM_WIFI_HINTS_HELPER_H
+#define VIDEO_STREAM_WIFI_HINTS_HELPER_H
+
+#include "ns3/ptr.h"
+#include "ns3/application-container.h"
+#include "ns3/video-stream-link-monitor.h"
+
+namespace ns3 {
+
+class Node;
+class VideoStreamClient;
+
+/**
+ * @brief Give video stream clients the link hints of the Wi-Fi devices of
+ * their nodes.
+ *
+ * Every frame the PHY of a followed device receives, read from its RxOk
+ * trace source, gives the monitor an SNR sample. The data frames addressed
+ * to the device also give the mode they were sent with, whose data rate on
+ * a 20 MHz channel stands for the MCS, and a retry sample, set if the frame
+ * is a retransmission; every frame the MAC sends (MacTx) and every failed
+ * attempt (MacTxDataFailed) give a retry sample too. Frames are read as
+ * single MPDUs, so with frame aggregation only the SNR and the rate are
+ * meaningful.
+ */
+class VideoStreamWifiHintsHelper
+{
+public:
+  /**
+   * @brief Follow the Wi-Fi devices of a node with a link monitor.
+   *
+   * @param monitor the monitor
+   * @param node the node
+   * @return the number of Wi-Fi devices followed
+   */
+  static uint32_t Attach (Ptr<VideoStreamLinkMonitor> monitor, Ptr<Node> node);
+
+  /**
+   * @brief Set the LinkMonitor of a client to a monitor of the Wi-Fi devices of its node.
+   *
+   * @param client the client
+   * @return the monitor, null if the node has no Wi-Fi device
+   */
+  Ptr<VideoStreamLinkMonitor> Install (Ptr<VideoStreamClient> client) const;
+
+  /**
+   * @brief Set the LinkMonitor of every client of a container.
+   *
+   * @param apps the applications, those that are not video stream clients are skipped
+   * @return the number of clients given a monitor
+   */
+  uint32_t Install (ApplicationContainer apps) const;
+};
+
+} // namespace ns3
+
+#endif /* VIDEO_STREAM_WIFI_HINTS_HELPER_H */
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/application-container.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/wifi-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/position-allocator.h"
+#include "ns3/video-stream-helper.h"
+#include "ns3/video-stream-client.h"
+#include "ns3/video-stream-link-monitor.h"
+#include "ns3/video-stream-wifi-hints-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("VideoStreamWifiTestSuite");
+
+/**
+ * @brief Check that the link hints lower the level a Wi-Fi link cannot
+ * carry before the playback stalls.
+ */
+class VideoStreamLinkHintsTestCase : public TestCase
+{
+public:
+  VideoStreamLinkHintsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+VideoStreamLinkHintsTestCase::VideoStreamLinkHintsTestCase ()
+  : TestCase ("Check the link hints")
+{
+}
+
+void
+VideoStreamLinkHintsTestCase::DoRun (void)
+{
+  // the client on node 0 reaches the server on node 1 over a 9 Mbps ad hoc Wi-Fi link
+  NodeContainer nodes;
+  nodes.Create (2);
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate9Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy;
+  phy.SetChannel (channel.Create ());
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 0.0));
+  positions->Add (Vector (10.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positions);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  // level 3 of the default ladder takes 4.5 Mbps, more than the 3.6 Mbps the link leaves the stream
+  VideoStreamServerHelper videoServer (6969);
+  videoServer.SetAttribute ("VideoLength", UintegerValue (10));
+  ApplicationContainer serverApp = videoServer.Install (nodes.Get (1));
+  serverApp.Start (Seconds (0.0));
+  serverApp.Stop (Seconds (15.0));
+
+  VideoStreamClientHelper videoClient (interfaces.GetAddress (1), 6969);
+  videoClient.SetAttribute ("InitialVideoLevel", UintegerValue (3));
+  videoClient.SetAttribute ("LinkEfficiency", DoubleValue (0.4));
+  ApplicationContainer clientApp = videoClient.Install (nodes.Get (0));
+  VideoStreamWifiHintsHelper hints;
+  NS_TEST_ASSERT_MSG_EQ (hints.Install (clientApp), 1, "The client was not given the hints of its Wi-Fi device");
+  clientApp.Start (Seconds (0.5));
+  clientApp.Stop (Seconds (15.0));
+
+  Simulator::Stop (Seconds (15.0));
+  Simulator::Run ();
+
+  Ptr<VideoStreamClient> client = DynamicCast<VideoStreamClient> (clientApp.Get (0));
+  Ptr<VideoStreamLinkMonitor> monitor = client->GetLinkMonitor ();
+  NS_TEST_ASSERT_MSG_EQ ((monitor != 0), true, "The client did not follow its link");
+  NS_TEST_ASSERT_MSG_GT (monitor->GetReceivedFrames (), 0, "The monitor read no frame");
+  NS_TEST_ASSERT_MSG_EQ (monitor->GetMode (), "OfdmRate9Mbps", "The monitor did not read the mode of the data frames");
+  NS_TEST_ASSERT_MSG_EQ (monitor->GetPhyRate (), DataRate ("9Mbps"), "The monitor did not read the rate of the mode");
+  NS_TEST_ASSERT_MSG_GT (monitor->GetSnr (), 10.0, "The SNR of a 10 m link is too low");
+  NS_TEST_ASSERT_MSG_GT (client->GetLinkSwitchCount (), 0, "The link hints did not lower the level");
+  // 3 Mbps fits the link, and the link cannot carry the upgrade back to 4.5 Mbps
+  NS_TEST_ASSERT_MSG_EQ (client->GetVideoLevel (), 2, "The level does not follow the link rate");
+  NS_TEST_ASSERT_MSG_EQ (client->GetStallCount (), 0, "The level was lowered after the playback stalled");
+  Simulator::Destroy ();
+}
+
+/**
+ * @brief Video stream Wi-Fi link hints test suite.
+ */
+class VideoStreamWifiTestSuite : public TestSuite
+{
+public:
+  VideoStreamWifiTestSuite ();
+};
+
+VideoStreamWifiTestSuite::VideoStreamWifiTestSuite ()
+  : TestSuite ("video-stream-wifi", UNIT)
+{
+  AddTestCase (new VideoStreamLinkHintsTestCase, TestCase::QUICK);
+}
+
+static VideoStreamWifiTestSuite g_videoStreamWifiTestSuite; //!< Static variable for test initialization